@@ -0,0 +1,61 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "interpreter.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+
+/// Interprets the recursive computation of the n-th Fibonacci number, in a script that
+/// defines the given number of other functions before it, and reports the function calls
+/// made per second
+int main(int argc, char* argv[]) {
+    const int n{argc > 1 ? std::stoi(argv[1]) : 22};
+    const int otherFunctions{argc > 2 ? std::stoi(argv[2]) : 50};
+    const int repetitions{argc > 3 ? std::stoi(argv[3]) : 5};
+
+    std::string text;
+    for (int i{0}; i < otherFunctions; ++i)
+        text += "int function" + std::to_string(i) + "(int n) { return n; }\n";
+    text +=
+        "int fibonacci(int n) {\n"
+        "    if n < 2 {\n"
+        "        return n;\n"
+        "    }\n"
+        "    return fibonacci(n - 1) + fibonacci(n - 2);\n"
+        "}\n"
+        "print fibonacci(" +
+        std::to_string(n) + ");\n";
+
+    auto stream = std::istringstream(text);
+    auto source = Source(stream);
+    Lexer lexer(source, Lexer::Comments::SKIP);
+    const auto program = Parser(lexer).parseProgram();
+
+    // Computing the n-th number takes 2 * F(n + 1) - 1 calls, F(n + 1) is computed here
+    long long fibonacci{1};
+    long long previous{0};
+    for (int i{0}; i < n; ++i) {
+        fibonacci += previous;
+        previous = fibonacci - previous;
+    }
+    const auto calls = 2 * fibonacci - 1;
+
+    std::chrono::duration<double> best{std::chrono::hours(1)};
+    std::string result;
+    for (int i{0}; i < repetitions; ++i) {
+        std::stringstream output;
+        Interpreter interpreter(output);
+
+        const auto start = std::chrono::steady_clock::now();
+        interpreter.interpret(program);
+        best = std::min<std::chrono::duration<double>>(
+            best, std::chrono::steady_clock::now() - start);
+        result = output.str();
+    }
+
+    std::cout << "fibonacci(" << n << "): " << result << "calls:        " << calls << '\n'
+              << "best time:    " << best.count() << " s\n"
+              << "calls/sec:    " << calls / best.count() << '\n';
+}
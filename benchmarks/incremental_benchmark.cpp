@@ -0,0 +1,78 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "flat_ast.hpp"
+#include "incremental_parser.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "synthetic_program.hpp"
+
+using Seconds = std::chrono::duration<double>;
+
+/// @brief Returns the best time of parsing the whole text from scratch
+Seconds measureFullParse(const std::string& text, int repetitions) {
+    Seconds best{std::chrono::hours(1)};
+    for (int i{0}; i < repetitions; ++i) {
+        auto source = Source(std::make_shared<const SourceBuffer>(text));
+        const auto start = std::chrono::steady_clock::now();
+        Lexer lexer(source, Lexer::Comments::SKIP);
+        Parser(lexer).parseProgram();
+        best = std::min<Seconds>(best, std::chrono::steady_clock::now() - start);
+    }
+    return best;
+}
+
+/// @brief Applies single-line edits to random blocks of statements and returns the mean
+/// time per edit
+/// @param addLines whether each edit inserts a line, which shifts all following
+/// statements, or only changes one
+Seconds measureEdits(IncrementalParser& parser, int units, int edits, bool addLines) {
+    std::mt19937 random(7);
+    Seconds total{0};
+    for (int i{0}; i < edits; ++i) {
+        const auto unit = std::to_string(random() % units);
+        // Points to 'const int limit<unit> = <unit> * 2 + 1;'
+        const auto offset = parser.getText().find("const int limit" + unit + " = ");
+
+        const auto start = std::chrono::steady_clock::now();
+        if (addLines)
+            parser.applyEdit({offset, 0, "print " + unit + ";\n"});
+        else
+            parser.applyEdit({offset + 21 + 2 * unit.size(), 1, std::to_string(i % 10)});
+        total += std::chrono::steady_clock::now() - start;
+    }
+    return total / edits;
+}
+
+/// Compares parsing a large synthetic program from scratch after each edit with updating
+/// its tree incrementally
+int main(int argc, char* argv[]) {
+    const int units{argc > 1 ? std::stoi(argv[1]) : 20000};
+    const int edits{argc > 2 ? std::stoi(argv[2]) : 100};
+
+    const auto program = generateProgram(units);
+    const auto fullParse = measureFullParse(program.text, 3);
+
+    IncrementalParser parser(program.text);
+    const auto inLine = measureEdits(parser, units, edits, false);
+    const auto addedLine = measureEdits(parser, units, edits, true);
+
+    auto source =
+        Source(std::make_shared<const SourceBuffer>(std::string(parser.getText())));
+    Lexer lexer(source, Lexer::Comments::SKIP);
+    if (flatten(Parser(lexer).parseProgram()).serialize() !=
+        flatten(parser.getProgram()).serialize()) {
+        std::cerr << "incrementally updated tree differs from the parsed one\n";
+        return 1;
+    }
+
+    std::cout << "input:            " << program.text.size() / 1e6 << " MB\n"
+              << "full parse:       " << fullParse.count() * 1e3 << " ms\n"
+              << "edit in line:     " << inLine.count() * 1e3 << " ms ("
+              << fullParse / inLine << "x)\n"
+              << "edit adding line: " << addedLine.count() * 1e3 << " ms ("
+              << fullParse / addedLine << "x)\n";
+}
@@ -0,0 +1,72 @@
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string_view>
+
+#include "lexer.hpp"
+#include "parallel_lexer.hpp"
+
+/// Lexes the given script (example.rp by default) concatenated `scale` times into
+/// batches of compact tokens, as the parser does, and reports the lexing throughput.
+/// Options after the positional arguments:
+/// `--skip-comments` skips comments, `--parallel` lexes with ParallelLexer
+int main(int argc, char* argv[]) {
+    const std::string path{argc > 1 ? argv[1] : "example.rp"};
+    const int scale{argc > 2 ? std::stoi(argv[2]) : 1000};
+    const int repetitions{argc > 3 ? std::stoi(argv[3]) : 5};
+
+    auto comments = Lexer::Comments::KEEP;
+    bool parallel{false};
+    for (int i{4}; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--skip-comments")
+            comments = Lexer::Comments::SKIP;
+        if (std::string_view(argv[i]) == "--parallel")
+            parallel = true;
+    }
+
+    std::ifstream file(path);
+    std::stringstream script;
+    script << file.rdbuf();
+
+    std::string text;
+    for (int i{0}; i < scale; ++i)
+        text += script.str();
+    const auto buffer = std::make_shared<const SourceBuffer>(std::move(text));
+
+    std::size_t tokenCount{0};
+    std::chrono::duration<double> best{std::chrono::hours(1)};
+
+    for (int i{0}; i < repetitions; ++i) {
+        // A fresh buffer per repetition, so that line indexing is measured every time
+        const auto repetitionBuffer =
+            std::make_shared<const SourceBuffer>(std::string(buffer->getText()));
+        auto source = Source(repetitionBuffer);
+        tokenCount = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<ILexer> lexer;
+        if (parallel)
+            lexer = std::make_unique<ParallelLexer>(source, comments);
+        else
+            lexer = std::make_unique<Lexer>(source, comments);
+        std::array<CompactToken, 64> tokens;
+        std::size_t count{0};
+        do {
+            count = lexer->getCompactTokens(tokens);
+            tokenCount += count;
+        } while (tokens[count - 1].getType() != Token::Type::ETX);
+        --tokenCount;
+        best = std::min<std::chrono::duration<double>>(
+            best, std::chrono::steady_clock::now() - start);
+    }
+
+    const auto megabytes = buffer->getText().size() / 1e6;
+    std::cout << "tokens:     " << tokenCount << '\n'
+              << "input:      " << megabytes << " MB\n"
+              << "best time:  " << best.count() << " s\n"
+              << "tokens/sec: " << tokenCount / best.count() << '\n'
+              << "MB/sec:     " << megabytes / best.count() << '\n';
+}
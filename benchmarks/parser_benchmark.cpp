@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "synthetic_program.hpp"
+#include "threaded_lexer.hpp"
+
+/// @brief Returns the best time of parsing the program, lexing on the parsing thread or
+/// on a producer thread feeding the parser
+std::chrono::duration<double> measure(const std::shared_ptr<const SourceBuffer>& buffer,
+                                      int repetitions, bool threaded,
+                                      std::size_t& parsedStatements) {
+    std::chrono::duration<double> best{std::chrono::hours(1)};
+
+    for (int i{0}; i < repetitions; ++i) {
+        auto source = Source(buffer);
+
+        const auto start = std::chrono::steady_clock::now();
+        Lexer lexer(source, Lexer::Comments::SKIP);
+        std::optional<ThreadedLexer> threadedLexer;
+        if (threaded)
+            threadedLexer.emplace(lexer);
+        Parser parser(threadedLexer ? static_cast<ILexer&>(*threadedLexer) : lexer);
+        const auto parsed = parser.parseProgram();
+        best = std::min<std::chrono::duration<double>>(
+            best, std::chrono::steady_clock::now() - start);
+        parsedStatements = parsed.statements.size();
+    }
+    return best;
+}
+
+/// @brief Returns the best time of lexing the program alone, which bounds the time a
+/// producer thread can take off the parsing thread
+std::chrono::duration<double> measureLexing(
+    const std::shared_ptr<const SourceBuffer>& buffer, int repetitions) {
+    std::chrono::duration<double> best{std::chrono::hours(1)};
+    std::array<CompactToken, 4096> tokens;
+
+    for (int i{0}; i < repetitions; ++i) {
+        auto source = Source(buffer);
+
+        const auto start = std::chrono::steady_clock::now();
+        Lexer lexer(source, Lexer::Comments::SKIP);
+        while (lexer.getCompactTokens(tokens) == tokens.size()) {
+        }
+        best = std::min<std::chrono::duration<double>>(
+            best, std::chrono::steady_clock::now() - start);
+    }
+    return best;
+}
+
+/// Parses a synthetic program made of `units` repetitions of a block of statements and
+/// reports the parsing throughput, lexing included, with lexing on the parsing thread
+/// and on a separate one. The threaded run can only be faster with a spare hardware
+/// thread, at best taking the whole lexing time off the parsing thread
+int main(int argc, char* argv[]) {
+    const int units{argc > 1 ? std::stoi(argv[1]) : 20000};
+    const int repetitions{argc > 2 ? std::stoi(argv[2]) : 5};
+
+    const auto program = generateProgram(units);
+    const auto buffer = std::make_shared<const SourceBuffer>(program.text);
+
+    std::size_t parsedStatements{0};
+    const auto best = measure(buffer, repetitions, false, parsedStatements);
+    std::size_t threadedParsedStatements{0};
+    const auto threadedBest =
+        measure(buffer, repetitions, true, threadedParsedStatements);
+    const auto lexingBest = measureLexing(buffer, repetitions);
+    const auto overlappedBest = std::max(lexingBest, best - lexingBest);
+
+    std::cout << "statements:     " << program.statementCount << '\n'
+              << "top level:      " << parsedStatements << '\n'
+              << "input:          " << buffer->getText().size() / 1e6 << " MB\n"
+              << "best time:      " << best.count() << " s\n"
+              << "statements/sec: " << program.statementCount / best.count() << '\n'
+              << "lexing alone:   " << lexingBest.count() << " s\n"
+              << "threaded lexer: " << threadedBest.count() << " s ("
+              << best / threadedBest << "x, " << std::thread::hardware_concurrency()
+              << " hardware threads, at most " << best / overlappedBest
+              << "x with a spare one)\n";
+
+    if (threadedParsedStatements != parsedStatements) {
+        std::cerr << "threaded lexer parsed " << threadedParsedStatements
+                  << " top level statements\n";
+        return 1;
+    }
+}
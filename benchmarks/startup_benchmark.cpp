@@ -0,0 +1,77 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include "ast_cache.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+
+/// Compares getting the tree of the given script (example.rp by default) concatenated
+/// `scale` times by lexing and parsing it (cold start) with loading it from the AST cache
+/// (warm start)
+int main(int argc, char* argv[]) {
+    const std::string path{argc > 1 ? argv[1] : "example.rp"};
+    const int scale{argc > 2 ? std::stoi(argv[2]) : 1000};
+    const int repetitions{argc > 3 ? std::stoi(argv[3]) : 5};
+
+    std::ifstream file(path);
+    std::stringstream script;
+    script << file.rdbuf();
+
+    std::string text;
+    for (int i{0}; i < scale; ++i)
+        text += script.str();
+    const auto buffer = std::make_shared<const SourceBuffer>(std::move(text));
+    const auto source = buffer->getText();
+
+    const auto directory =
+        std::filesystem::temp_directory_path() / "raptor_lang_startup_benchmark";
+    const AstCache cache(directory);
+
+    using Duration = std::chrono::duration<double>;
+    const auto elapsedSince = [](auto start) -> Duration {
+        return std::chrono::steady_clock::now() - start;
+    };
+    Duration bestParse{std::chrono::hours(1)};
+    Duration bestStore{std::chrono::hours(1)};
+    Duration bestLoad{std::chrono::hours(1)};
+    std::size_t statementCount{0};
+
+    for (int i{0}; i < repetitions; ++i) {
+        std::filesystem::remove_all(directory);
+
+        auto start = std::chrono::steady_clock::now();
+        auto sourceReader = Source(buffer);
+        Lexer lexer(sourceReader, Lexer::Comments::SKIP);
+        const auto parsed = Parser(lexer).parseProgram();
+        bestParse = std::min(bestParse, elapsedSince(start));
+
+        start = std::chrono::steady_clock::now();
+        cache.store(source, parsed);
+        bestStore = std::min(bestStore, elapsedSince(start));
+
+        start = std::chrono::steady_clock::now();
+        const auto loaded = cache.load(source);
+        bestLoad = std::min(bestLoad, elapsedSince(start));
+
+        if (!loaded) {
+            std::cerr << "Failed to load the tree from " << directory << '\n';
+            return 1;
+        }
+        statementCount = loaded->statements.size();
+    }
+
+    const auto cacheSize = std::filesystem::file_size(cache.getPath(source));
+    std::filesystem::remove_all(directory);
+
+    std::cout << "statements:         " << statementCount << '\n'
+              << "input:              " << source.size() / 1e6 << " MB\n"
+              << "cache file:         " << cacheSize / 1e6 << " MB\n"
+              << "cold (lex + parse): " << bestParse.count() << " s\n"
+              << "storing the tree:   " << bestStore.count() << " s\n"
+              << "warm (load):        " << bestLoad.count() << " s\n"
+              << "speedup:            " << bestParse.count() / bestLoad.count() << "x\n";
+}
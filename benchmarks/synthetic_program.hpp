@@ -0,0 +1,41 @@
+#ifndef SYNTHETIC_PROGRAM_H
+#define SYNTHETIC_PROGRAM_H
+
+#include <string>
+
+/// @brief Synthetic program exercising every kind of statement
+struct SyntheticProgram {
+    std::string text;
+    std::size_t statementCount{0};
+};
+
+inline SyntheticProgram generateProgram(int units) {
+    SyntheticProgram program;
+    for (int i{0}; i < units; ++i) {
+        const auto n = std::to_string(i);
+        program.text += "struct Point" + n + " {\n    int x,\n    float y\n}\n" +
+                        "variant Number" + n + " { int, float, Point" + n + " }\n" +
+                        "const int limit" + n + " = " + n + " * 2 + 1;\n" +
+                        "int sum" + n + "(ref Point" + n + " p, int count) {\n" +
+                        "    int s = 0;\n" +
+                        "    while count > 0 {\n" +
+                        "        if p.x >= limit" + n + " and not (count == 3) {\n" +
+                        "            s = s + p.x * count - p.y as int;\n" +
+                        "        }\n" +
+                        "        count = count - 1;\n" +
+                        "    }\n" +
+                        "    return s;\n" +
+                        "}\n" +
+                        "void show" + n + "(str label) {\n" +
+                        "    print label + \"" + n + "\";\n" +
+                        "}\n" +
+                        "Point" + n + " p" + n + " = { " + n + ", 1.5 };\n" +
+                        "p" + n + ".x = sum" + n + "(ref p" + n + ", 4);\n" +
+                        "Number" + n + " v" + n + " = p" + n + ".y;\n" +
+                        "show" + n + "(\"unit\");\n";
+        program.statementCount += 19;
+    }
+    return program;
+}
+
+#endif
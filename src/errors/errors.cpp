@@ -35,8 +35,13 @@ NumericOverflow::NumericOverflow(const Position& position, Integral value, Integ
                                   + std::to_string(std::numeric_limits<Integral>::max())
                                   + " which is maximum value") {}
 
-InvalidFloat::InvalidFloat(const Position& position)
-    : BaseException(position, "Expected digit after '.' in float literal") {}
+NumericOverflow::NumericOverflow(const Position& position, std::string_view literal)
+    : BaseException(position, "Numeric literal " + std::string(literal)
+                                  + " is out of range of its type") {}
+
+InvalidFloat::InvalidFloat(const Position& position, char after)
+    : BaseException(position, std::string("Expected digit after '") + after
+                                  + "' in float literal") {}
 
 struct TypeToString {
     std::string operator()(BuiltInType type) {
@@ -99,7 +104,7 @@ struct ValueToString {
     std::string operator()(Integral) const { return "INT"; }
     std::string operator()(Floating) const { return "FLOAT"; }
     std::string operator()(bool) const { return "BOOL"; }
-    std::string operator()(const std::string&) const { return "STR"; }
+    std::string operator()(const SharedString&) const { return "STR"; }
     std::string operator()(const StructObj&) const { return "Anonymous struct"; }
     std::string operator()(const NamedStructObj& s) const {
         return "Struct " + s.structDef->name;
@@ -1,6 +1,8 @@
 #ifndef LEXER_ERRORS_H
 #define LEXER_ERRORS_H
 
+#include <string_view>
+
 #include "base_errors.hpp"
 #include "types.hpp"
 
@@ -22,11 +24,14 @@ class NonEscapableChar : public BaseException {
 class NumericOverflow : public BaseException {
    public:
     NumericOverflow(const Position& position, Integral value, Integral digit);
+    NumericOverflow(const Position& position, std::string_view literal);
 };
 
 class InvalidFloat : public BaseException {
    public:
-    explicit InvalidFloat(const Position& position);
+    /// @param position
+    /// @param after character that must be followed by a digit, '.' or an exponent mark
+    explicit InvalidFloat(const Position& position, char after = '.');
 };
 
 #endif
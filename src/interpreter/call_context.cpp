@@ -2,53 +2,90 @@
 
 #include <algorithm>
 #include <ranges>
+#include <utility>
 
-std::optional<RefObj> CallContext::getVariable(std::string_view name) const {
-    for (const auto& scope : std::ranges::views::reverse(scopes_))
-        if (const auto& varRef = scope.getVariable(name))
-            return *varRef;
+CallContext::CallContext(const CallContext* parent, std::size_t frameSize,
+                         std::span<const VariableSlot> outerSlots)
+    : parentContext_{parent}, outerSlots_{outerSlots}, slots_(frameSize) {
+    addScope();
+}
 
-    const auto res = std::ranges::find(varRefs_, name, &RefEntry::first);
-    if (res != varRefs_.end())
-        return res->second;
+bool CallContext::addVariable(std::uint32_t slot, std::unique_ptr<ValueObj> valueObj,
+                              bool isConst) {
+    const auto depth = static_cast<std::uint32_t>(scopes_.size());
+    auto& current = slots_[slot];
+    if (current.scopeDepth == depth)
+        return false;
 
-    if (parentContext_)
-        if (auto val = parentContext_->getVariable(name))
-            return val;
+    RefObj ref{.valueObj = valueObj.get(), .isConst = isConst};
+    scopes_.back().addVariable(slot,
+                               std::exchange(current, {std::move(valueObj), ref, depth}));
+    return true;
+}
+
+void CallContext::addReference(std::uint32_t slot, RefObj ref) {
+    if (!slots_[slot].ref.valueObj) {
+        slots_[slot] = {nullptr, ref};
+        scopes_.back().addVariable(slot, {});
+    }
+}
+
+void CallContext::removeScope() {
+    // Backwards, as a variable may shadow a reference parameter defined in the scope
+    auto& variables = scopes_.back().getVariables();
+    for (auto& variable : std::ranges::views::reverse(variables))
+        slots_[variable.slot] = std::move(variable.shadowed);
+    scopes_.pop_back();
+}
+
+std::optional<RefObj> CallContext::getOuterVariable(std::uint32_t slot) const {
+    for (auto ctx = this; slot < ctx->outerSlots_.size();) {
+        const auto outer = ctx->outerSlots_[slot];
+        ctx = ctx->getEnclosingContext(outer.depth);
+        slot = outer.index;
+        if (const auto& ref = ctx->slots_[slot].ref; ref.valueObj)
+            return ref;
+    }
     return std::nullopt;
 }
 
-std::optional<CallContext::FuncWithCtx> CallContext::getFunctionWithCtx(
-    std::string_view name) const {
-    for (auto const& scope : std::ranges::views::reverse(scopes_))
-        if (const auto& func = scope.getFunction(name))
-            return std::make_pair(func, this);
+void CallContext::resizeFrame(std::size_t frameSize) {
+    if (frameSize > slots_.size())
+        slots_.resize(frameSize);
+}
 
-    if (parentContext_)
-        if (auto funcWithCtx = parentContext_->getFunctionWithCtx(name))
-            return funcWithCtx;
+bool CallContext::hasFunctions() const {
+    return std::ranges::any_of(scopes_, &Scope::hasFunctions);
+}
+
+std::optional<CallTarget> CallContext::getFunctionWithCtx(Symbol name) const {
+    std::uint32_t depth{0};
+    for (auto ctx = this; ctx; ctx = ctx->parentContext_, ++depth)
+        for (auto const& scope : std::ranges::views::reverse(ctx->scopes_))
+            if (const auto& func = scope.getFunction(name))
+                return CallTarget{.funcDef = func, .context = ctx, .depth = depth};
     return std::nullopt;
 }
 
-const StructDef* CallContext::getStructDef(std::string_view name) const {
+const StructDef* CallContext::getStructDef(TypeId typeId) const {
     for (auto const& scope : std::ranges::views::reverse(scopes_))
-        if (const auto& structDef = scope.getStructDef(name))
+        if (const auto& structDef = scope.getStructDef(typeId))
             return structDef;
 
     if (parentContext_)
-        if (auto structDef = parentContext_->getStructDef(name))
+        if (auto structDef = parentContext_->getStructDef(typeId))
             return structDef;
 
     return nullptr;
 }
 
-const VariantDef* CallContext::getVariantDef(std::string_view name) const {
+const VariantDef* CallContext::getVariantDef(TypeId typeId) const {
     for (auto const& scope : std::ranges::views::reverse(scopes_))
-        if (auto variantDef = scope.getVariantDef(name))
+        if (auto variantDef = scope.getVariantDef(typeId))
             return variantDef;
 
     if (parentContext_)
-        if (auto variantDef = parentContext_->getVariantDef(name))
+        if (auto variantDef = parentContext_->getVariantDef(typeId))
             return variantDef;
 
     return nullptr;
@@ -1,26 +1,37 @@
 #ifndef CALL_CONTEXT_H
 #define CALL_CONTEXT_H
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "scope.hpp"
-
-using RefEntry = std::pair<std::string, RefObj>;
+#include "value_obj.hpp"
 
 /// @brief Function call context
+///
+/// Variables live in slots assigned by the NameResolver, one per name. A slot holds the
+/// innermost definition in scope, the ones it shadows are kept by the scopes. A
+/// variable of an enclosing function is reached by following the parents as many times
+/// as functions are nested, usually once for a global variable.
 class CallContext {
    public:
-    using FuncWithCtx = std::pair<const FuncDef*, const CallContext*>;
-
-    /// @param parent The context in which the function is called or nullptr if this is a
-    /// global context
-    explicit CallContext(const CallContext* parent)
-        : parentContext_{parent} {
-        addScope();
-    }
+    /// @param parent The context in which the function is defined or nullptr if this is
+    /// a global context
+    /// @param frameSize Number of variable slots
+    /// @param outerSlots See FuncDef::Frame::outerSlots
+    CallContext(const CallContext* parent, std::size_t frameSize,
+                std::span<const VariableSlot> outerSlots = {});
 
-    void addVariable(VarEntry entry) { scopes_.back().addVariable(std::move(entry)); }
-    void addReference(RefEntry entry) { varRefs_.push_back(std::move(entry)); }
+    /// @brief Defines a variable in the slot. Returns false if it is already defined in
+    /// the innermost scope
+    bool addVariable(std::uint32_t slot, std::unique_ptr<ValueObj> valueObj,
+                     bool isConst);
+    /// @brief Defines a reference parameter in the slot, which the variables of the body
+    /// can shadow. A parameter of the same name defined before takes precedence
+    void addReference(std::uint32_t slot, RefObj ref);
     void addFunction(const FuncDef* func) { scopes_.back().addFunction(func); }
     void addStruct(const StructDef* structDef) { scopes_.back().addStruct(structDef); }
     void addVariant(const VariantDef* variantDef) {
@@ -28,22 +39,52 @@ class CallContext {
     }
 
     void addScope() { scopes_.emplace_back(); }
-    void removeScope() { scopes_.pop_back(); }
+    /// @brief Removes the innermost scope along with the variables it defined
+    void removeScope();
+    /// @brief Whether functions are defined in the innermost scope
+    bool hasFunctionsInScope() const { return scopes_.back().hasFunctions(); }
+    /// @brief Whether functions are defined in any scope of the context
+    bool hasFunctions() const;
+
+    /// @brief Grows the number of variable slots, the global context gets more of them
+    /// as the program is resolved
+    void resizeFrame(std::size_t frameSize);
 
-    std::optional<RefObj> getVariable(std::string_view name) const;
+    /// @brief Returns the variable in the slot, or in the slots of the enclosing contexts
+    /// while it is empty, std::nullopt if none is defined
+    std::optional<RefObj> getVariable(VariableSlot slot) const {
+        const auto ctx = getEnclosingContext(slot.depth);
+        const auto& ref = ctx->slots_[slot.index].ref;
+        if (!ref.valueObj)
+            return ctx->getOuterVariable(slot.index);
+        return ref;
+    }
+
+    /// @brief Returns the context the given number of contexts up the chain of enclosing
+    /// ones, this one for 0
+    /// @param depth
+    const CallContext* getEnclosingContext(std::uint32_t depth) const {
+        auto ctx = this;
+        for (; depth > 0; --depth)
+            ctx = ctx->parentContext_;
+        return ctx;
+    }
 
     /// @brief Returns a function with the given name along with the call context in which
     /// the function is defined
     /// @param name Named of the function
-    /// @return
-    std::optional<FuncWithCtx> getFunctionWithCtx(std::string_view name) const;
-    const StructDef* getStructDef(std::string_view name) const;
-    const VariantDef* getVariantDef(std::string_view name) const;
+    /// @return the target with no version or std::nullopt if not found
+    std::optional<CallTarget> getFunctionWithCtx(Symbol name) const;
+    const StructDef* getStructDef(TypeId typeId) const;
+    const VariantDef* getVariantDef(TypeId typeId) const;
 
    private:
+    std::optional<RefObj> getOuterVariable(std::uint32_t slot) const;
+
     const CallContext* parentContext_{nullptr};
+    std::span<const VariableSlot> outerSlots_;
     std::vector<Scope> scopes_;
-    std::vector<RefEntry> varRefs_;
+    std::vector<VarSlot> slots_;
 };
 
 #endif
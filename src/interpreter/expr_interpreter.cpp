@@ -54,6 +54,26 @@ void ExpressionInterpreter::operator()(const ConjunctionExpression& expr) const
     evalLogicalExpr(expr, std::logical_and());
 }
 
+/// @brief Applies the evaluator to operands which the type checker proved to be of the
+/// same type, dispatching on the type of the left one only
+template <typename Evaluator>
+auto visitChecked(Evaluator evaluator, const ValueObj& lhs, const ValueObj& rhs) {
+    return std::visit(
+        [&](const auto& left) {
+            return evaluator(left, std::get<std::decay_t<decltype(left)>>(rhs.value));
+        },
+        lhs.value);
+}
+
+/// @brief Applies the evaluator to operands of any types
+template <typename Evaluator>
+auto visitOperands(const Interpreter& interpreter, const BinaryExpression& expr,
+                   Evaluator evaluator, const ValueObj& lhs, const ValueObj& rhs) {
+    if (expr.checked && interpreter.skipsCheckedTypes())
+        return visitChecked(evaluator, lhs, rhs);
+    return std::visit(evaluator, lhs.value, rhs.value);
+}
+
 template <typename Functor>
 struct EqualityEvaluator {
     EqualityEvaluator(const Functor& func)
@@ -62,7 +82,7 @@ struct EqualityEvaluator {
     bool operator()(bool lhs, bool rhs) const { return func_(lhs, rhs); }
     bool operator()(Integral lhs, Integral rhs) const { return func_(lhs, rhs); }
     bool operator()(Floating lhs, Floating rhs) const { return func_(lhs, rhs); }
-    bool operator()(const std::string& lhs, const std::string& rhs) const {
+    bool operator()(const SharedString& lhs, const SharedString& rhs) const {
         return func_(lhs, rhs);
     }
     bool operator()(const auto& lhs, const auto& rhs) const {
@@ -79,8 +99,8 @@ void ExpressionInterpreter::evalEqualityExpr(const BinaryExpression& expr,
     const auto leftValue = getExprValue(*expr.lhs);
     const auto rightValue = getExprValue(*expr.rhs);
     try {
-        const auto result =
-            std::visit(EqualityEvaluator(func), leftValue.value, rightValue.value);
+        const auto result = visitOperands(*interpreter_, expr, EqualityEvaluator(func),
+                                          leftValue, rightValue);
         lastResult_ = ValueObj{result};
     } catch (const TypeMismatch& e) {
         throw TypeMismatch{expr.position, e};
@@ -102,7 +122,7 @@ struct ComparisonEvaluator {
 
     bool operator()(Integral lhs, Integral rhs) { return func_(lhs, rhs); }
     bool operator()(Floating lhs, Floating rhs) { return func_(lhs, rhs); }
-    bool operator()(const std::string& lhs, const std::string& rhs) {
+    bool operator()(const SharedString& lhs, const SharedString& rhs) {
         return func_(lhs, rhs);
     }
     bool operator()(const auto& lhs, const auto& rhs) {
@@ -119,8 +139,8 @@ void ExpressionInterpreter::compareExpr(const BinaryExpression& expr,
     const auto rightValue = getExprValue(*expr.rhs);
 
     try {
-        const auto result =
-            std::visit(ComparisonEvaluator(func), leftValue.value, rightValue.value);
+        const auto result = visitOperands(*interpreter_, expr, ComparisonEvaluator(func),
+                                          leftValue, rightValue);
         lastResult_ = ValueObj{result};
     } catch (const TypeMismatch& e) {
         throw TypeMismatch{expr.position, e};
@@ -187,8 +207,8 @@ void ExpressionInterpreter::evalNumericExpr(const BinaryExpression& expr,
     const auto rightValueObj = getExprValue(*expr.rhs);
 
     try {
-        auto value =
-            std::visit(NumericEvaluator(func), leftValueObj.value, rightValueObj.value);
+        auto value = visitOperands(*interpreter_, expr, NumericEvaluator(func),
+                                   leftValueObj, rightValueObj);
         lastResult_ = ValueObj{std::move(value)};
     } catch (const TypeMismatch& e) {
         throw TypeMismatch{expr.position, e};
@@ -198,7 +218,7 @@ void ExpressionInterpreter::evalNumericExpr(const BinaryExpression& expr,
 }
 
 struct AdditionEvaluator {
-    ValueObj::Value operator()(const std::string& lhs, const std::string& rhs) const {
+    ValueObj::Value operator()(const SharedString& lhs, const SharedString& rhs) const {
         return lhs + rhs;
     }
     ValueObj::Value operator()(const auto& lhs, const auto& rhs) const {
@@ -211,7 +231,8 @@ void ExpressionInterpreter::operator()(const AdditionExpression& expr) const {
     const auto rightValue = getExprValue(*expr.rhs);
 
     try {
-        auto value = std::visit(AdditionEvaluator(), leftValue.value, rightValue.value);
+        auto value = visitOperands(*interpreter_, expr, AdditionEvaluator(), leftValue,
+                                   rightValue);
         lastResult_ = ValueObj{std::move(value)};
     } catch (const TypeMismatch& e) {
         throw TypeMismatch{expr.position, e};
@@ -255,14 +276,15 @@ void ExpressionInterpreter::operator()(const LogicalNegationExpression& expr) co
 }
 
 struct TypeConverter {
-    explicit TypeConverter(Interpreter* interpreter)
-        : interpreter_{interpreter} {
+    TypeConverter(Interpreter* interpreter, TypeId toId)
+        : interpreter_{interpreter},
+          toId_{toId} {
         if (!interpreter_)
             throw std::runtime_error("Null interpreter pointer");
     }
 
     ValueObj::Value operator()(VariantObj from, const auto& to) const {
-        if (std::visit(TypeComparer(), static_cast<Type>(to), from.valueObj->value))
+        if (getTypeId(from.valueObj->value) == toId_)
             return std::move(from.valueObj->value);
 
         throw InvalidTypeConversion{{}, std::move(from.valueObj->value), to};
@@ -276,13 +298,13 @@ struct TypeConverter {
     ValueObj::Value operator()(bool from, BuiltInType to) const {
         return fromBuiltInValue(from, to);
     }
-    ValueObj::Value operator()(std::string from, BuiltInType to) const {
+    ValueObj::Value operator()(SharedString from, BuiltInType to) const {
         if (to == BuiltInType::STR)
             return from;
         throw InvalidTypeConversion{{}, std::move(from), to};
     }
     ValueObj::Value operator()(NamedStructObj from, const std::string& to) const {
-        if (from.structDef->name == to)
+        if (from.structDef->typeId == toId_)
             return from;
         return convertToVariant(std::move(from), to);
     }
@@ -296,7 +318,7 @@ struct TypeConverter {
     ValueObj::Value operator()(bool from, const std::string& to) const {
         return convertToVariant(from, to);
     }
-    ValueObj::Value operator()(std::string from, const std::string& to) const {
+    ValueObj::Value operator()(SharedString from, const std::string& to) const {
         return convertToVariant(std::move(from), to);
     }
 
@@ -319,16 +341,12 @@ struct TypeConverter {
     }
 
     ValueObj::Value convertToVariant(auto from, const std::string& to) const {
-        const auto variantDef = interpreter_->getVariantDef(to);
+        const auto variantDef = interpreter_->getVariantDef(toId_);
         if (!variantDef)
             throw InvalidTypeConversion{{}, std::move(from), to};
 
         auto value = static_cast<ValueObj::Value>(std::move(from));
-
-        auto compareTypeWithValue = [&](const Type& type) {
-            return std::visit(TypeComparer(), type, value);
-        };
-        if (std::ranges::any_of(variantDef->types, compareTypeWithValue)) {
+        if (variantDef->typeIds.contains(getTypeId(value))) {
             auto valuePtr = std::make_unique<ValueObj>(std::move(value));
             return VariantObj{std::move(valuePtr), variantDef};
         }
@@ -336,14 +354,15 @@ struct TypeConverter {
     }
 
     Interpreter* interpreter_;
+    TypeId toId_;
 };
 
 void ExpressionInterpreter::operator()(const ConversionExpression& conversionExpr) const {
     auto valueObj = getExprValue(*conversionExpr.expr);
 
     try {
-        auto value = std::visit(TypeConverter(interpreter_), std::move(valueObj.value),
-                                conversionExpr.type);
+        auto value = std::visit(TypeConverter(interpreter_, conversionExpr.typeId),
+                                std::move(valueObj.value), conversionExpr.type);
         lastResult_ = ValueObj{std::move(value)};
     } catch (InvalidTypeConversion& e) {
         throw InvalidTypeConversion{conversionExpr.position, std::move(e)};
@@ -351,21 +370,23 @@ void ExpressionInterpreter::operator()(const ConversionExpression& conversionExp
 }
 
 struct TypeCheckEvaluator {
-    TypeCheckEvaluator(Type expected)
+    explicit TypeCheckEvaluator(TypeId expected)
         : expected_{expected} {}
 
     bool operator()(const VariantObj& variantObj) const {
-        return std::visit(TypeComparer(), expected_, variantObj.valueObj->value);
+        return getTypeId(variantObj.valueObj->value) == expected_;
+    }
+    bool operator()(const auto& value) const {
+        return ValueToTypeId()(value) == expected_;
     }
-    bool operator()(const auto& value) const { return TypeComparer()(expected_, value); }
 
-    Type expected_;
+    TypeId expected_;
 };
 
 void ExpressionInterpreter::operator()(const TypeCheckExpression& expr) const {
     const auto valueObj = getExprValue(*expr.expr);
 
-    const auto result = std::visit(TypeCheckEvaluator(expr.type), valueObj.value);
+    const auto result = std::visit(TypeCheckEvaluator(expr.typeId), valueObj.value);
     lastResult_ = ValueObj{result};
 }
 
@@ -393,7 +414,7 @@ struct FieldAccessEvaluator {
                                std::visit(ValueToType(), valueObj.value)};
 
         try {
-            return namedStructObj->getField(expr_.field);
+            return namedStructObj->getField(expr_.field, expr_.fieldIndex);
         } catch (const InvalidField& e) {
             throw InvalidField{expr_.position, e};
         }
@@ -409,6 +430,7 @@ void ExpressionInterpreter::operator()(const FieldAccessExpression& expr) const
 }
 
 void ExpressionInterpreter::operator()(const Constant& expr) const {
+    // String constants are shared with the parse tree, not copied
     auto value =
         std::visit([](const auto& v) -> ValueObj::Value { return v; }, expr.value);
     lastResult_ = ValueObj{std::move(value)};
@@ -422,8 +444,8 @@ void ExpressionInterpreter::operator()(const FuncCall& funcCall) const {
 }
 
 void ExpressionInterpreter::operator()(const VariableAccess& expr) const {
-    auto varRef = interpreter_->getVariable(expr.name);
+    auto varRef = interpreter_->getVariable(expr.slot);
     if (!varRef)
-        throw SymbolNotFound{expr.position, "Variable", expr.name};
+        throw SymbolNotFound{expr.position, "Variable", std::string(expr.name.getText())};
     lastResult_ = *varRef;
 }
@@ -1,65 +1,129 @@
 #include "interpreter.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <ranges>
 
 #include "expr_interpreter.hpp"
 #include "interpreter_errors.hpp"
+#include "type_checker.hpp"
 
-Interpreter::Interpreter(std::ostream& out)
-    : out_{out} {
-    callStack_.emplace(nullptr);
+Interpreter::Interpreter(std::ostream& out, TypeChecks typeChecks)
+    : out_{out}, typeChecks_{typeChecks} {
+    globalContext_ = &callStack_.emplace(nullptr, 0);
+    invalidateCallTargets();
 }
 
 void Interpreter::interpret(const Program& program) {
+    if (typeChecks_ == TypeChecks::RUNTIME) {
+        for (const auto& stmt : program.statements)
+            interpret(*stmt);
+        return;
+    }
+
+    // The checker needs the slots of all variables, also in bodies of functions which
+    // would be resolved on their first call
     for (const auto& stmt : program.statements) {
-        stmt->accept(*this);
-        if (returning_)
-            throw ReturnTypeMismatch{stmt->position, "No return in global scope",
-                                     "Returning in global scope"};
+        resolver_.resolve(*stmt);
+        const auto funcDef = dynamic_cast<const FuncDef*>(stmt.get());
+        if (funcDef && !resolver_.isResolved(*funcDef))
+            resolver_.resolveBody(*funcDef);
+    }
+    globalContext_->resizeFrame(resolver_.getGlobalFrameSize());
+    TypeChecker().check(program);
+
+    skipCheckedTypes_ = true;
+    try {
+        for (const auto& stmt : program.statements)
+            execute(*stmt);
+    } catch (...) {
+        skipCheckedTypes_ = false;
+        throw;
     }
+    skipCheckedTypes_ = false;
+}
+
+void Interpreter::interpret(const Statement& statement) {
+    resolver_.resolve(statement);
+    globalContext_->resizeFrame(resolver_.getGlobalFrameSize());
+    execute(statement);
 }
 
-void Interpreter::addVariable(VarEntry entry) {
-    callStack_.top().addVariable(std::move(entry));
+void Interpreter::execute(const Statement& statement) {
+    statement.accept(*this);
+    if (returning_)
+        throw ReturnTypeMismatch{statement.position, "No return in global scope",
+                                 "Returning in global scope"};
 }
 
 void Interpreter::addFunction(const FuncDef* funcDef) {
     callStack_.top().addFunction(funcDef);
+    invalidateCallTargets();
+}
+
+const CallTarget& Interpreter::getCallTarget(const FuncCall& funcCall) {
+    // A call is always made from contexts of the same function, which reach the defining
+    // context at the same depth. The context is compared in case the chain now goes
+    // through other activations
+    auto& target = funcCall.target;
+    const auto& ctx = callStack_.top();
+    if (target.version == functionsVersion_ &&
+        ctx.getEnclosingContext(target.depth) == target.context)
+        return target;
+
+    const auto found = ctx.getFunctionWithCtx(funcCall.name);
+    if (!found)
+        throw SymbolNotFound{funcCall.position, "Function",
+                             std::string(funcCall.name.getText())};
+    target = *found;
+    target.version = functionsVersion_;
+    return target;
+}
+
+void Interpreter::invalidateCallTargets() {
+    static std::atomic<std::uint64_t> lastVersion{0};
+    functionsVersion_ = ++lastVersion;
 }
 
 void Interpreter::addStruct(const StructDef* structDef) {
-    if (getStructDef(structDef->name))
+    if (getStructDef(structDef->typeId))
         throw StructRedefinition{{}, structDef->name};
-    if (getVariantDef(structDef->name))
+    if (getVariantDef(structDef->typeId))
         throw VariantRedefinition{{}, structDef->name};
     callStack_.top().addStruct(structDef);
 }
 
 void Interpreter::addVariant(const VariantDef* variantDef) {
-    if (getVariantDef(variantDef->name))
+    if (getVariantDef(variantDef->typeId))
         throw VariantRedefinition{{}, variantDef->name};
-    if (getStructDef(variantDef->name))
+    if (getStructDef(variantDef->typeId))
         throw StructRedefinition{{}, variantDef->name};
     callStack_.top().addVariant(variantDef);
 }
 
-std::optional<RefObj> Interpreter::getVariable(std::string_view name) const {
-    return callStack_.top().getVariable(name);
+std::optional<RefObj> Interpreter::getVariable(Symbol name) const {
+    if (const auto slot = resolver_.getGlobalSlot(name))
+        return globalContext_->getVariable({.index = *slot});
+    return std::nullopt;
+}
+
+void Interpreter::resolveBody(const FuncDef& funcDef) {
+    resolver_.resolveBody(funcDef);
+    globalContext_->resizeFrame(resolver_.getGlobalFrameSize());
 }
 
-std::optional<CallContext::FuncWithCtx> Interpreter::getFunctionWithCtx(
-    std::string_view name) const {
+std::optional<CallTarget> Interpreter::getFunctionWithCtx(
+    Symbol name) const {
     return callStack_.top().getFunctionWithCtx(name);
 }
 
-const StructDef* Interpreter::getStructDef(std::string_view name) const {
-    return callStack_.top().getStructDef(name);
+const StructDef* Interpreter::getStructDef(TypeId typeId) const {
+    return callStack_.top().getStructDef(typeId);
 }
 
-const VariantDef* Interpreter::getVariantDef(std::string_view name) const {
-    return callStack_.top().getVariantDef(name);
+const VariantDef* Interpreter::getVariantDef(TypeId typeId) const {
+    return callStack_.top().getVariantDef(typeId);
 }
 
 ValueHolder Interpreter::getValueFromExpr(const Expression& expr) {
@@ -69,6 +133,9 @@ ValueHolder Interpreter::getValueFromExpr(const Expression& expr) {
 
 bool Interpreter::evaluateCondition(const ConditionalStatement& stmt) {
     const auto conditionValue = getHeldValue(getValueFromExpr(*stmt.condition));
+    if (skipCheckedTypes_ && stmt.checked)
+        return std::get<bool>(conditionValue.value);
+
     const auto condition = std::get_if<bool>(&conditionValue.value);
     if (!condition)
         throw TypeMismatch{stmt.condition->position, BuiltInType::BOOL,
@@ -95,6 +162,8 @@ void Interpreter::interpretStatementsInNewContext(const Statements& statements)
             break;
     }
 
+    if (callStack_.top().hasFunctionsInScope())
+        invalidateCallTargets();
     callStack_.top().removeScope();
 }
 
@@ -106,6 +175,7 @@ void Interpreter::operator()(const ReturnStatement& stmt) {
     returning_ = true;
 }
 
+namespace {
 struct ValuePrinter {
     explicit ValuePrinter(std::ostream& out)
         : out_{out} {}
@@ -127,6 +197,7 @@ struct ValuePrinter {
 
     std::ostream& out_;
 };
+}  // namespace
 
 void Interpreter::operator()(const PrintStatement& stmt) {
     if (auto expr = stmt.expression.get()) {
@@ -147,56 +218,59 @@ void expectVoidReturnValue(const ReturnValue& valueObj) {
     }
 }
 
-void expectNonVoidReturnValue(const ReturnType& expected, const ReturnValue& valueObj) {
+void expectNonVoidReturnValue(const ReturnType& expected, TypeId expectedId,
+                              const ReturnValue& valueObj) {
     if (!valueObj)
         throw ReturnTypeMismatch{{}, expected, VoidType{}};
 
-    if (!std::visit(TypeComparer(), expected, valueObj->value)) {
+    if (getTypeId(valueObj->value) != expectedId) {
         const auto actualType = std::visit(ValueToType(), valueObj->value);
         throw ReturnTypeMismatch{
             {}, expected, std::visit([](auto t) -> ReturnType { return t; }, actualType)};
     }
 }
 
-void checkReturnType(const ReturnType& expected, const ReturnValue& valueObj) {
+void checkReturnType(const ReturnType& expected, TypeId expectedId,
+                     const ReturnValue& valueObj) {
     if (std::holds_alternative<VoidType>(expected))
         expectVoidReturnValue(valueObj);
     else
-        expectNonVoidReturnValue(expected, valueObj);
+        expectNonVoidReturnValue(expected, expectedId, valueObj);
 }
 
-void checkValueType(const Type& type, const ValueObj& valueObj) {
-    if (!std::visit(TypeComparer(), type, valueObj.value))
-        throw TypeMismatch{{}, type, std::visit(ValueToType(), valueObj.value)};
+void checkValueType(TypeId typeId, const ValueObj& valueObj) {
+    if (getTypeId(valueObj.value) != typeId)
+        throw TypeMismatch{{}, TypeRegistry::getType(typeId),
+                           std::visit(ValueToType(), valueObj.value)};
 }
 
-bool valueTypeOtherThanExpected(const Type& expected, const ValueHolder& holder) {
-    auto valueObj = getHeldValueCopy(holder);
-    return !std::visit(TypeComparer(), expected, valueObj.value);
+/// @brief Returns the value of ValueHolder without copying it
+const ValueObj& viewHeldValue(const ValueHolder& holder) {
+    if (const auto ref = std::get_if<RefObj>(&holder))
+        return *ref->valueObj;
+    return std::get<ValueObj>(holder);
 }
 
-ValueHolder Interpreter::convertAndCheckType(const Type& expected,
-                                             ValueHolder holder) const {
-    auto userDefinedTypeName = std::get_if<std::string>(&expected);
-    if (valueTypeOtherThanExpected(expected, holder) && userDefinedTypeName) {
-        auto valueObj = getHeldValue(std::move(holder));
-        convertToUserDefinedType(valueObj, *userDefinedTypeName);
-        checkValueType(expected, valueObj);
-        return valueObj;
-    }
+ValueHolder Interpreter::convertAndCheckType(TypeId expected, ValueHolder holder) const {
+    if (getTypeId(viewHeldValue(holder).value) == expected)
+        return holder;
+    if (!TypeRegistry::isUserDefined(expected))
+        checkValueType(expected, viewHeldValue(holder));
 
-    checkValueType(expected, getHeldValueCopy(holder));
-    return holder;
+    auto valueObj = getHeldValue(std::move(holder));
+    convertToUserDefinedType(valueObj, expected);
+    checkValueType(expected, valueObj);
+    return valueObj;
 }
 
-void Interpreter::convertToUserDefinedType(ValueObj& valueObj,
-                                           std::string_view typeName) const {
-    if (auto structDef = getStructDef(typeName))
+void Interpreter::convertToUserDefinedType(ValueObj& valueObj, TypeId typeId) const {
+    if (auto structDef = getStructDef(typeId))
         convertToNamedStruct(valueObj, structDef);
-    else if (auto variantDef = getVariantDef(typeName))
+    else if (auto variantDef = getVariantDef(typeId))
         convertToVariant(valueObj, variantDef);
     else
-        throw SymbolNotFound{{}, "User defined type", std::string(typeName)};
+        throw SymbolNotFound{{}, "User defined type",
+                             std::get<std::string>(TypeRegistry::getType(typeId))};
 }
 
 void Interpreter::convertToNamedStruct(ValueObj& valueObj,
@@ -210,7 +284,7 @@ void Interpreter::convertToNamedStruct(ValueObj& valueObj,
 
     auto covertSturctValue = [this](const Field& field,
                                     std::unique_ptr<ValueObj> valueObj) {
-        auto convertedValue = convertAndCheckType(field.type, std::move(*valueObj));
+        auto convertedValue = convertAndCheckType(field.typeId, std::move(*valueObj));
         auto convertedValueObj = getHeldValue(std::move(convertedValue));
         return std::make_unique<ValueObj>(std::move(convertedValueObj));
     };
@@ -224,10 +298,7 @@ void Interpreter::convertToNamedStruct(ValueObj& valueObj,
 
 void Interpreter::convertToVariant(ValueObj& valueObj,
                                    const VariantDef* variantDef) const {
-    auto compareTypeWithValue = [&](const Type& type) {
-        return std::visit(TypeComparer(), type, valueObj.value);
-    };
-    if (std::ranges::any_of(variantDef->types, compareTypeWithValue)) {
+    if (variantDef->typeIds.contains(getTypeId(valueObj.value))) {
         auto valuePtr = std::make_unique<ValueObj>(std::move(valueObj));
         valueObj.value = VariantObj{std::move(valuePtr), variantDef};
     }
@@ -235,52 +306,54 @@ void Interpreter::convertToVariant(ValueObj& valueObj,
 
 void Interpreter::operator()(const VarDef& stmt) {
     auto valueRef = getHeldValue(getValueFromExpr(*stmt.expression));
-    try {
-        valueRef = getHeldValue(convertAndCheckType(stmt.type, std::move(valueRef)));
-    } catch (const TypeMismatch& e) {
-        throw TypeMismatch{stmt.position, e};
-    } catch (const SymbolNotFound& e) {
-        throw SymbolNotFound{stmt.position, e};
-    } catch (const InvalidFieldCount& e) {
-        throw InvalidFieldCount{stmt.position, e};
+    if (!(skipCheckedTypes_ && stmt.checked)) {
+        try {
+            valueRef =
+                getHeldValue(convertAndCheckType(stmt.typeId, std::move(valueRef)));
+        } catch (const TypeMismatch& e) {
+            throw TypeMismatch{stmt.position, e};
+        } catch (const SymbolNotFound& e) {
+            throw SymbolNotFound{stmt.position, e};
+        } catch (const InvalidFieldCount& e) {
+            throw InvalidFieldCount{stmt.position, e};
+        }
     }
 
-    try {
-        VarEntry varEntry = {.name = std::move(stmt.name),
-                             .valueObj = std::make_unique<ValueObj>(std::move(valueRef)),
-                             .isConst = stmt.isConst};
-        addVariable(std::move(varEntry));
-    } catch (const VariableRedefinition& e) {
-        throw VariableRedefinition{stmt.position, e};
-    }
+    if (!callStack_.top().addVariable(
+            stmt.slot, std::make_unique<ValueObj>(std::move(valueRef)), stmt.isConst))
+        throw VariableRedefinition{stmt.position, std::string(stmt.name.getText())};
 }
 
+namespace {
 struct FieldAccessEvaluator {
-    explicit FieldAccessEvaluator(const Interpreter& interpreter)
-        : interpreter_{interpreter} {}
+    FieldAccessEvaluator(const Interpreter& interpreter, VariableSlot slot)
+        : interpreter_{interpreter}, slot_{slot} {}
 
-    RefObj operator()(std::string_view name) {
-        if (const auto refObj = interpreter_.getVariable(name))
+    RefObj operator()(Symbol name) {
+        if (const auto refObj = interpreter_.getVariable(slot_))
             return *refObj;
-        throw SymbolNotFound{{}, "Variable", std::string(name)};
+        throw SymbolNotFound{{}, "Variable", std::string(name.getText())};
     }
 
-    RefObj operator()(const std::unique_ptr<FieldAccess>& fieldAccess) {
+    RefObj operator()(const NodePtr<FieldAccess>& fieldAccess) {
         const auto containerRef = std::visit(*this, fieldAccess->container);
         const auto namedStruct =
             std::get_if<NamedStructObj>(&containerRef.valueObj->value);
         if (!namedStruct)
             throw std::runtime_error("Lhs of field access is not a named struct");
-        auto fieldRef = namedStruct->getField(fieldAccess->field);
+        auto fieldRef =
+            namedStruct->getField(fieldAccess->field, fieldAccess->fieldIndex);
         return {.valueObj = fieldRef, .isConst = containerRef.isConst};
     }
 
     const Interpreter& interpreter_;
+    VariableSlot slot_;
 };
+}  // namespace
 
 RefObj Interpreter::tryAccessLValue(const Assignment& stmt) const {
     try {
-        return std::visit(FieldAccessEvaluator(*this), stmt.lhs);
+        return std::visit(FieldAccessEvaluator(*this, stmt.slot), stmt.lhs);
     } catch (const SymbolNotFound& e) {
         throw SymbolNotFound{stmt.position, e};
     } catch (const InvalidField& e) {
@@ -294,16 +367,17 @@ void Interpreter::operator()(const Assignment& stmt) {
     if (lvalue.isConst)
         throw ConstViolation(stmt.position);
 
-    const auto expectedType = std::visit(ValueToType(), lvalue.valueObj->value);
-
     auto newValue = getValueFromExpr(*stmt.rhs);
 
-    try {
-        newValue = convertAndCheckType(expectedType, std::move(newValue));
-    } catch (const TypeMismatch& e) {
-        throw TypeMismatch{stmt.position, e};
-    } catch (const InvalidFieldCount& e) {
-        throw InvalidFieldCount{stmt.position, e};
+    if (!(skipCheckedTypes_ && stmt.checked)) {
+        const auto expectedType = getTypeId(lvalue.valueObj->value);
+        try {
+            newValue = convertAndCheckType(expectedType, std::move(newValue));
+        } catch (const TypeMismatch& e) {
+            throw TypeMismatch{stmt.position, e};
+        } catch (const InvalidFieldCount& e) {
+            throw InvalidFieldCount{stmt.position, e};
+        }
     }
 
     lvalue.valueObj->value = getHeldValue(std::move(newValue)).value;
@@ -322,23 +396,29 @@ void Interpreter::operator()(const FuncCall& funcCall) {
 }
 
 ReturnValue Interpreter::handleFunctionCall(const FuncCall& funcCall) {
-    auto funcWithCtx = getFunctionWithCtx(funcCall.name);
-    if (!funcWithCtx)
-        throw SymbolNotFound{funcCall.position, "Function", funcCall.name};
-    const auto [funcDef, parentCtx] = *funcWithCtx;
+    const auto& target = getCallTarget(funcCall);
+    const auto funcDef = target.funcDef;
+    const auto parentCtx = target.context;
+
+    // A deferred body is parsed here, when the function is called for the first time
+    if (!resolver_.isResolved(*funcDef))
+        resolveBody(*funcDef);
 
-    CallContext ctx{parentCtx};
+    const auto& frame = funcDef->getFrame();
+    CallContext ctx{parentCtx, frame.size, frame.outerSlots};
     passArgumentsToCtx(ctx, funcCall.arguments, funcDef->getParameters());
 
     const auto recursionLimit_{1000};
     if (callStack_.size() > recursionLimit_)
         throw MaxRecursionDepth{funcCall.position};
 
+    const auto& statements = funcDef->getStatements();
+
     callStack_.push(std::move(ctx));
 
     Position lastStmtPosition{funcDef->position};
 
-    for (const auto& stmt : funcDef->getStatements()) {
+    for (const auto& stmt : statements) {
         stmt->accept(*this);
         if (returning_) {
             lastStmtPosition = stmt->position;
@@ -347,23 +427,32 @@ ReturnValue Interpreter::handleFunctionCall(const FuncCall& funcCall) {
     }
     returning_ = false;
 
-    if (const auto typeName = std::get_if<std::string>(&funcDef->getReturnType()))
+    // The checker proves the types of returned values, not that a value is returned
+    const auto& returnType = funcDef->getReturnType();
+    const auto returnTypeId = funcDef->getReturnTypeId();
+    if (!skipCheckedTypes_ || !funcDef->areReturnsChecked() ||
+        std::holds_alternative<VoidType>(returnType) == returnValue_.has_value()) {
+        if (returnValue_ && TypeRegistry::isUserDefined(returnTypeId) &&
+            getTypeId(returnValue_->value) != returnTypeId)
+            try {
+                convertToUserDefinedType(*returnValue_, returnTypeId);
+            } catch (const InvalidFieldCount& e) {
+                throw InvalidFieldCount{lastStmtPosition, e};
+            } catch (const TypeMismatch& e) {
+                throw TypeMismatch{funcDef->position, e};
+            } catch (const SymbolNotFound& e) {
+                throw SymbolNotFound{funcDef->position, e};
+            }
+
         try {
-            convertToUserDefinedType(*returnValue_, *typeName);
-        } catch (const InvalidFieldCount& e) {
-            throw InvalidFieldCount{lastStmtPosition, e};
-        } catch (const TypeMismatch& e) {
-            throw TypeMismatch{funcDef->position, e};
-        } catch (const SymbolNotFound& e) {
-            throw SymbolNotFound{funcDef->position, e};
+            checkReturnType(returnType, returnTypeId, returnValue_);
+        } catch (const ReturnTypeMismatch& e) {
+            throw ReturnTypeMismatch{lastStmtPosition, e};
         }
-
-    try {
-        checkReturnType(funcDef->getReturnType(), returnValue_);
-    } catch (const ReturnTypeMismatch& e) {
-        throw ReturnTypeMismatch{lastStmtPosition, e};
     }
 
+    if (callStack_.top().hasFunctions())
+        invalidateCallTargets();
     callStack_.pop();
 
     auto returnValue = std::move(returnValue_);
@@ -395,25 +484,26 @@ void checkArgRef(const Argument& arg, const Parameter& param) {
         throw std::runtime_error("Expected value argument");
 }
 
+namespace {
+/// @brief Defines a parameter, returns false if it is already defined
 struct VariableAdder {
-    VariableAdder(CallContext& callCtx, std::string name)
-        : callCtx_{callCtx}, name_{std::move(name)} {}
-
-    void operator()(ValueObj valueObj) const {
-        VarEntry varEntry = {.name = name_,
-                             .valueObj = std::make_unique<ValueObj>(std::move(valueObj)),
-                             .isConst = false};
-        callCtx_.addVariable(std::move(varEntry));
+    VariableAdder(CallContext& callCtx, std::uint32_t slot)
+        : callCtx_{callCtx}, slot_{slot} {}
+
+    bool operator()(ValueObj valueObj) const {
+        auto owned = std::make_unique<ValueObj>(std::move(valueObj));
+        return callCtx_.addVariable(slot_, std::move(owned), false);
     }
-    void operator()(RefObj varRef) const {
-        RefEntry refEntry = {name_, varRef};
-        callCtx_.addReference(std::move(refEntry));
+    bool operator()(RefObj varRef) const {
+        callCtx_.addReference(slot_, varRef);
+        return true;
     }
 
    private:
     CallContext& callCtx_;
-    std::string name_;
+    std::uint32_t slot_;
 };
+}  // namespace
 
 bool isConst(const ValueHolder& holder) {
     if (auto varRef = std::get_if<RefObj>(&holder))
@@ -429,22 +519,21 @@ void Interpreter::passArgumentToCtx(CallContext& ctx, const Argument& arg,
     if (!arg.ref)
         valueRef = getHeldValueCopy(std::move(valueRef));
 
-    try {
-        valueRef = convertAndCheckType(param.type, std::move(valueRef));
-    } catch (const TypeMismatch& e) {
-        throw TypeMismatch{arg.position, e};
-    } catch (const InvalidFieldCount& e) {
-        throw InvalidFieldCount{arg.position, e};
+    if (!(skipCheckedTypes_ && arg.checked)) {
+        try {
+            valueRef = convertAndCheckType(param.typeId, std::move(valueRef));
+        } catch (const TypeMismatch& e) {
+            throw TypeMismatch{arg.position, e};
+        } catch (const InvalidFieldCount& e) {
+            throw InvalidFieldCount{arg.position, e};
+        }
     }
 
     if (isConst(valueRef))
         throw ConstViolation{arg.position};
 
-    try {
-        std::visit(VariableAdder{ctx, param.name}, std::move(valueRef));
-    } catch (const VariableRedefinition& e) {
-        throw VariableRedefinition{param.position, e};
-    }
+    if (!std::visit(VariableAdder{ctx, param.slot}, std::move(valueRef)))
+        throw VariableRedefinition{param.position, std::string(param.name.getText())};
 }
 
 void Interpreter::operator()(const StructDef& stmt) {
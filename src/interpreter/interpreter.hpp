@@ -6,6 +6,7 @@
 
 #include "call_context.hpp"
 #include "expr_interpreter.hpp"
+#include "name_resolver.hpp"
 #include "parse_tree.hpp"
 
 using ReturnValue = std::optional<ValueObj>;
@@ -13,33 +14,63 @@ using ReturnValue = std::optional<ValueObj>;
 /// @brief Statement interpreter
 class Interpreter : public StatementVisitor {
    public:
+    enum class TypeChecks {
+        /// Types are checked as the statements are executed
+        RUNTIME,
+        /// The whole program is checked by the TypeChecker before it is executed, runtime
+        /// checks of what the checker proved are skipped
+        STATIC,
+    };
+
     /// @brief
     /// @param out the stream to which the output will be written
-    explicit Interpreter(std::ostream& out);
+    /// @param typeChecks when types of programs are checked. Statements interpreted one
+    /// by one are always checked at runtime
+    explicit Interpreter(std::ostream& out, TypeChecks typeChecks = TypeChecks::RUNTIME);
 
     /// @brief Interprets the given program
     /// @param program
     void interpret(const Program& program);
 
-    /// @brief Returns a reference to a variable with the given name or std::nullopt if
-    /// not found
+    /// @brief Resolves and executes a single top level statement, e.g. one handed out by
+    /// Parser::parseProgram(const StatementHandler&)
+    /// @param statement
+    void interpret(const Statement& statement);
+
+    /// @brief Returns a reference to a global variable with the given name or
+    /// std::nullopt if not found
     /// @param name
-    std::optional<RefObj> getVariable(std::string_view name) const;
+    std::optional<RefObj> getVariable(Symbol name) const;
+    std::optional<RefObj> getVariable(std::string_view name) const {
+        return getVariable(Symbol(name));
+    }
+
+    /// @brief Returns a reference to the variable in the slot, as seen from the current
+    /// call context, or std::nullopt if it is not defined
+    /// @param slot
+    std::optional<RefObj> getVariable(VariableSlot slot) const {
+        return callStack_.top().getVariable(slot);
+    }
 
     /// @brief Returns a function definition with the given name along with the scope in
     /// which the function is defined. If not found the std::nullopt is returned
     /// @param name
-    std::optional<CallContext::FuncWithCtx> getFunctionWithCtx(
-        std::string_view name) const;
+    std::optional<CallTarget> getFunctionWithCtx(Symbol name) const;
 
     /// @brief Returns a function definition with the given name or a nullptr if nout
     /// found
     /// @param name
-    const StructDef* getStructDef(std::string_view name) const;
+    const StructDef* getStructDef(std::string_view name) const {
+        return getStructDef(TypeRegistry::getNameId(name));
+    }
+    const StructDef* getStructDef(TypeId typeId) const;
 
     /// @brief Returns a variant definition with the given name or a nullptr if nout found
     /// @param name
-    const VariantDef* getVariantDef(std::string_view name) const;
+    const VariantDef* getVariantDef(std::string_view name) const {
+        return getVariantDef(TypeRegistry::getNameId(name));
+    }
+    const VariantDef* getVariantDef(TypeId typeId) const;
 
     void operator()(const IfStatement& ifStmt) override;
     void operator()(const WhileStatement& whileStmt) override;
@@ -52,19 +83,30 @@ class Interpreter : public StatementVisitor {
     void operator()(const StructDef& stmt) override;
     void operator()(const VariantDef& stmt) override;
 
+    /// @brief Whether runtime checks of what the type checker proved are skipped
+    bool skipsCheckedTypes() const { return skipCheckedTypes_; }
+
     /// @brief Executes the given function call and returns the returned value
     /// @param funcCall
     /// @return Value returned from the function call
     ReturnValue handleFunctionCall(const FuncCall& funcCall);
 
    private:
-    void addVariable(VarEntry entry);
+    void execute(const Statement& statement);
+
     void addFunction(const FuncDef* func);
+    /// @brief Returns the function called by the node, reusing the target it cached if
+    /// no function definitions were added or removed since
+    /// @throws SymbolNotFound if there is no function of the name
+    const CallTarget& getCallTarget(const FuncCall& funcCall);
+    /// @brief Invalidates the targets cached by all function calls. Called whenever a
+    /// function definition becomes visible or goes out of scope
+    void invalidateCallTargets();
     void addStruct(const StructDef* structDef);
     void addVariant(const VariantDef* variantDef);
 
-    ValueHolder convertAndCheckType(const Type& expected, ValueHolder holder) const;
-    void convertToUserDefinedType(ValueObj& valueObj, std::string_view typeName) const;
+    ValueHolder convertAndCheckType(TypeId expected, ValueHolder holder) const;
+    void convertToUserDefinedType(ValueObj& valueObj, TypeId typeId) const;
 
     /// @brief Converts anonymous struct (StructObj) to one with field names (NamedStruct)
     /// @param valueObj
@@ -88,44 +130,54 @@ class Interpreter : public StatementVisitor {
 
     ValueHolder getValueFromExpr(const Expression& expr);
 
+    /// @brief Assigns slots to the variables of a function whose body was deferred
+    void resolveBody(const FuncDef& funcDef);
+
+    NameResolver resolver_;
     std::stack<CallContext> callStack_;
+    /// Bottom of the call stack, which does not move as contexts are pushed
+    CallContext* globalContext_;
     std::ostream& out_;
 
     ExpressionInterpreter exprInterpreter_{this};
     ReturnValue returnValue_{std::nullopt};
     bool returning_{false};
+    TypeChecks typeChecks_;
+    bool skipCheckedTypes_{false};
+    /// Version of the visible function definitions, unique among all interpreters so
+    /// that targets cached by another one are never reused
+    std::uint64_t functionsVersion_;
 };
 
-/// @brief Checks if the given value is of the given type
-struct TypeComparer {
-    bool operator()(BuiltInType variableType, Integral) const {
-        return variableType == BuiltInType::INT;
-    }
-    bool operator()(BuiltInType variableType, Floating) const {
-        return variableType == BuiltInType::FLOAT;
+/// @brief Returns the id of the type of the given value, TypeRegistry::NONE for
+/// anonymous structs
+struct ValueToTypeId {
+    TypeId operator()(Integral) const { return TypeRegistry::getId(BuiltInType::INT); }
+    TypeId operator()(Floating) const { return TypeRegistry::getId(BuiltInType::FLOAT); }
+    TypeId operator()(bool) const { return TypeRegistry::getId(BuiltInType::BOOL); }
+    TypeId operator()(const SharedString&) const {
+        return TypeRegistry::getId(BuiltInType::STR);
     }
-    bool operator()(BuiltInType variableType, bool) const {
-        return variableType == BuiltInType::BOOL;
+    TypeId operator()(const NamedStructObj& structObj) const {
+        return structObj.structDef->typeId;
     }
-    bool operator()(BuiltInType variableType, const std::string&) const {
-        return variableType == BuiltInType::STR;
+    TypeId operator()(const VariantObj& variantObj) const {
+        return variantObj.variantDef->typeId;
     }
-    bool operator()(const std::string& variableType,
-                    const NamedStructObj& structObj) const {
-        return structObj.structDef->name == variableType;
-    }
-    bool operator()(const std::string& variableType, const VariantObj& variantObj) const {
-        return variantObj.variantDef->name == variableType;
-    }
-    bool operator()(const auto&, const auto&) const { return false; }
+    TypeId operator()(const StructObj&) const { return TypeRegistry::NONE; }
 };
 
+/// @brief Returns the id of the type of the given value
+inline TypeId getTypeId(const ValueObj::Value& value) {
+    return std::visit(ValueToTypeId(), value);
+}
+
 /// @brief Returns the type of the given value
 struct ValueToType {
     Type operator()(Integral) const { return BuiltInType::INT; }
     Type operator()(Floating) const { return BuiltInType::FLOAT; }
     Type operator()(bool) const { return BuiltInType::BOOL; }
-    Type operator()(const std::string&) const { return BuiltInType::STR; }
+    Type operator()(const SharedString&) const { return BuiltInType::STR; }
     Type operator()(const NamedStructObj& structObj) const {
         return structObj.structDef->name;
     }
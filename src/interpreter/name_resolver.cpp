@@ -0,0 +1,233 @@
+#include "name_resolver.hpp"
+
+#include <atomic>
+
+/// @brief Binds the variables used by an expression
+class NameResolver::ExpressionResolver : public ExpressionVisitor {
+   public:
+    explicit ExpressionResolver(NameResolver& resolver)
+        : resolver_(resolver) {}
+
+    void operator()(const StructInitExpression& expr) const override {
+        for (const auto& element : expr.exprs)
+            resolver_.resolveExpression(element);
+    }
+    void operator()(const DisjunctionExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const ConjunctionExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const EqualExpression& expr) const override { resolveBinary(expr); }
+    void operator()(const NotEqualExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const LessThanExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const LessThanOrEqualExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const GreaterThanExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const GreaterThanOrEqualExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const AdditionExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const SubtractionExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const MultiplicationExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const DivisionExpression& expr) const override {
+        resolveBinary(expr);
+    }
+    void operator()(const SignChangeExpression& expr) const override {
+        resolver_.resolveExpression(expr.expr);
+    }
+    void operator()(const LogicalNegationExpression& expr) const override {
+        resolver_.resolveExpression(expr.expr);
+    }
+    void operator()(const ConversionExpression& expr) const override {
+        resolver_.resolveExpression(expr.expr);
+    }
+    void operator()(const TypeCheckExpression& expr) const override {
+        resolver_.resolveExpression(expr.expr);
+    }
+    void operator()(const FieldAccessExpression& expr) const override {
+        resolver_.resolveExpression(expr.expr);
+    }
+    void operator()(const Constant&) const override {}
+    void operator()(const FuncCall& expr) const override {
+        for (const auto& argument : expr.arguments)
+            resolver_.resolveExpression(argument.value);
+    }
+    void operator()(const VariableAccess& expr) const override {
+        expr.slot = resolver_.bind(expr.name);
+    }
+
+   private:
+    void resolveBinary(const BinaryExpression& expr) const {
+        resolver_.resolveExpression(expr.lhs);
+        resolver_.resolveExpression(expr.rhs);
+    }
+
+    NameResolver& resolver_;
+};
+
+/// @brief Collects the names of the variables defined in the blocks of one function's
+/// body
+class NameResolver::VariableCollector : public StatementVisitor {
+   public:
+    explicit VariableCollector(std::unordered_set<Symbol>& names)
+        : names_(names) {}
+
+    void collect(const Statements& statements) {
+        for (const auto& statement : statements)
+            statement->accept(*this);
+    }
+
+    void operator()(const IfStatement& stmt) override { collect(stmt.statements); }
+    void operator()(const WhileStatement& stmt) override { collect(stmt.statements); }
+    void operator()(const ReturnStatement&) override {}
+    void operator()(const PrintStatement&) override {}
+    void operator()(const FuncDef&) override {}
+    void operator()(const Assignment&) override {}
+    void operator()(const VarDef& stmt) override { names_.insert(stmt.name); }
+    void operator()(const FuncCall&) override {}
+    void operator()(const StructDef&) override {}
+    void operator()(const VariantDef&) override {}
+
+   private:
+    std::unordered_set<Symbol>& names_;
+};
+
+namespace {
+/// @brief Returns the name of the variable whose field or itself is assigned
+Symbol getAssignedVariable(const LValue& lvalue) {
+    if (const auto fieldAccess = std::get_if<NodePtr<FieldAccess>>(&lvalue))
+        return getAssignedVariable((*fieldAccess)->container);
+    return std::get<Symbol>(lvalue);
+}
+}  // namespace
+
+NameResolver::NameResolver()
+    : frames_(1) {
+    // Functions remember the resolver which assigned their slots, so each one needs a
+    // distinct id, also when the tree is interpreted again by another interpreter
+    static std::atomic<std::uint32_t> lastId{0};
+    id_ = ++lastId;
+}
+
+void NameResolver::resolve(const Statement& statement) { statement.accept(*this); }
+
+std::optional<std::uint32_t> NameResolver::getGlobalSlot(Symbol name) const {
+    const auto& slots = frames_.front().slots;
+    if (const auto it = slots.find(name); it != slots.end())
+        return it->second;
+    return std::nullopt;
+}
+
+std::size_t NameResolver::findDefiningFrame(Symbol name, std::size_t last) const {
+    for (auto index = last; index > 0; --index)
+        if (frames_[index].definedNames.contains(name))
+            return index;
+    return 0;
+}
+
+std::uint32_t NameResolver::getSlot(std::size_t frameIndex, Symbol name) {
+    auto& slots = frames_[frameIndex].slots;
+    const auto [it, inserted] =
+        slots.try_emplace(name, static_cast<std::uint32_t>(slots.size()));
+    const auto slot = it->second;
+    if (inserted && frameIndex > 0) {
+        const auto outer = findDefiningFrame(name, frameIndex - 1);
+        const auto depth = static_cast<std::uint32_t>(frameIndex - outer);
+        const VariableSlot outerSlot{.depth = depth, .index = getSlot(outer, name)};
+        frames_[frameIndex].outerSlots.push_back(outerSlot);
+    }
+    return slot;
+}
+
+VariableSlot NameResolver::bind(Symbol name) {
+    const auto current = frames_.size() - 1;
+    const auto frame = findDefiningFrame(name, current);
+    return {.depth = static_cast<std::uint32_t>(current - frame),
+            .index = getSlot(frame, name)};
+}
+
+void NameResolver::resolveExpression(const PExpression& expr) {
+    if (expr)
+        expr->accept(ExpressionResolver(*this));
+}
+
+void NameResolver::resolveBlock(const Statements& statements) {
+    if (frames_.size() == 1)
+        ++globalBlockDepth_;
+    for (const auto& statement : statements)
+        statement->accept(*this);
+    if (frames_.size() == 1)
+        --globalBlockDepth_;
+}
+
+void NameResolver::resolveFunction(const FuncDef& funcDef) {
+    auto& definedNames = frames_.emplace_back().definedNames;
+    for (const auto& parameter : funcDef.getParameters())
+        definedNames.insert(parameter.name);
+    VariableCollector(definedNames).collect(funcDef.getStatements());
+
+    for (const auto& parameter : funcDef.getParameters())
+        parameter.slot = define(parameter.name);
+    for (const auto& statement : funcDef.getStatements())
+        statement->accept(*this);
+
+    auto& frame = frames_.back();
+    funcDef.setFrame({.size = static_cast<std::uint32_t>(frame.slots.size()),
+                      .resolution = id_,
+                      .outerSlots = std::move(frame.outerSlots)});
+    frames_.pop_back();
+}
+
+void NameResolver::operator()(const IfStatement& stmt) {
+    resolveExpression(stmt.condition);
+    resolveBlock(stmt.statements);
+}
+
+void NameResolver::operator()(const WhileStatement& stmt) {
+    resolveExpression(stmt.condition);
+    resolveBlock(stmt.statements);
+}
+
+void NameResolver::operator()(const ReturnStatement& stmt) {
+    resolveExpression(stmt.expression);
+}
+
+void NameResolver::operator()(const PrintStatement& stmt) {
+    resolveExpression(stmt.expression);
+}
+
+void NameResolver::operator()(const FuncDef& stmt) {
+    // Deferred bodies of top level functions are resolved on the first call
+    if (stmt.isBodyDeferred() && frames_.size() == 1 && globalBlockDepth_ == 0)
+        return;
+    resolveFunction(stmt);
+}
+
+void NameResolver::operator()(const Assignment& stmt) {
+    resolveExpression(stmt.rhs);
+    stmt.slot = bind(getAssignedVariable(stmt.lhs));
+}
+
+void NameResolver::operator()(const VarDef& stmt) {
+    resolveExpression(stmt.expression);
+    stmt.slot = define(stmt.name);
+}
+
+void NameResolver::operator()(const FuncCall& stmt) {
+    for (const auto& argument : stmt.arguments)
+        resolveExpression(argument.value);
+}
@@ -0,0 +1,96 @@
+#ifndef NAME_RESOLVER_H
+#define NAME_RESOLVER_H
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "parse_tree.hpp"
+
+/// @brief Binds variables to the slots of the call contexts before they are executed
+///
+/// A context has one slot per name of a variable, which holds the innermost definition
+/// of the name currently in scope. A function's context has a slot for every name of a
+/// parameter or variable defined in its body, the global context one for every name
+/// used or defined outside of functions. A use is bound to the slot of the innermost
+/// function defining the name, or to the global one if none does. A function's slot
+/// falls back to the one of the enclosing functions while it is empty, so a body sees
+/// the variables of the enclosing contexts that are in scope when it is called.
+///
+/// Top level statements are resolved one at a time, so that they can be executed before
+/// the rest of the program is parsed.
+class NameResolver : public StatementVisitor {
+   public:
+    NameResolver();
+
+    /// @brief Resolves a top level statement
+    /// @param statement
+    void resolve(const Statement& statement);
+
+    /// @brief Resolves the body of a top level function, which was deferred when the
+    /// function was resolved
+    /// @param funcDef
+    void resolveBody(const FuncDef& funcDef) { resolveFunction(funcDef); }
+
+    /// @brief Whether the slots of the function were assigned by this resolver
+    /// @param funcDef
+    bool isResolved(const FuncDef& funcDef) const {
+        return funcDef.getFrame().resolution == id_;
+    }
+
+    std::uint32_t getGlobalFrameSize() const {
+        return static_cast<std::uint32_t>(frames_.front().slots.size());
+    }
+
+    /// @brief Returns the slot of a global variable with the given name or std::nullopt
+    /// if there is none
+    /// @param name
+    std::optional<std::uint32_t> getGlobalSlot(Symbol name) const;
+
+    void operator()(const IfStatement& stmt) override;
+    void operator()(const WhileStatement& stmt) override;
+    void operator()(const ReturnStatement& stmt) override;
+    void operator()(const PrintStatement& stmt) override;
+    void operator()(const FuncDef& stmt) override;
+    void operator()(const Assignment& stmt) override;
+    void operator()(const VarDef& stmt) override;
+    void operator()(const FuncCall& stmt) override;
+    void operator()(const StructDef&) override {}
+    void operator()(const VariantDef&) override {}
+
+   private:
+    class ExpressionResolver;
+    class VariableCollector;
+
+    struct Frame {
+        /// Slot of each name
+        std::unordered_map<Symbol, std::uint32_t> slots;
+        /// Names of the parameters and variables defined anywhere in the function's body,
+        /// empty for the global frame, in which any name may still be defined
+        std::unordered_set<Symbol> definedNames;
+        /// See FuncDef::Frame::outerSlots
+        std::vector<VariableSlot> outerSlots;
+    };
+
+    /// @brief Returns the index of the innermost frame up to the given one which defines
+    /// the name, 0 for the global frame
+    std::size_t findDefiningFrame(Symbol name, std::size_t last) const;
+    /// @brief Returns the slot of the name in the frame, assigning one if the name is new
+    std::uint32_t getSlot(std::size_t frameIndex, Symbol name);
+    VariableSlot bind(Symbol name);
+    std::uint32_t define(Symbol name) { return getSlot(frames_.size() - 1, name); }
+
+    void resolveExpression(const PExpression& expr);
+    void resolveBlock(const Statements& statements);
+    void resolveFunction(const FuncDef& funcDef);
+
+    std::uint32_t id_;
+    /// Number of blocks the global statement being resolved is nested in
+    std::uint32_t globalBlockDepth_{0};
+    /// The global frame first, the frame of the innermost function being resolved last
+    std::vector<Frame> frames_;
+};
+
+#endif
@@ -1,8 +1,8 @@
 #ifndef SCOPE_H
 #define SCOPE_H
 
+#include <cstdint>
 #include <memory>
-#include <optional>
 #include <string>
 #include <vector>
 
@@ -10,30 +10,49 @@
 #include "types.hpp"
 #include "value_obj.hpp"
 
-struct VarEntry {
-    std::string name;
+/// @brief Variable stored in a slot of a call context
+struct VarSlot {
+    /// Value owned by the context, nullptr for reference parameters
     std::unique_ptr<ValueObj> valueObj;
-    bool isConst{false};
+    /// Points to the owned value or to the referenced one, nullptr if the variable is
+    /// not defined
+    RefObj ref{.valueObj = nullptr};
+    /// Number of scopes in the context when the variable was defined, 0 for reference
+    /// parameters, which other definitions may shadow, and for undefined variables
+    std::uint32_t scopeDepth{0};
 };
 
+/// @brief Definitions made in a block. Variables are stored in the slots of the call
+/// context, the scope only remembers which of them it defined
 class Scope {
     using FuncDefEntry = const FuncDef*;
     using StructDefEntry = const StructDef*;
     using VariantDefEntry = const VariantDef*;
 
    public:
-    void addVariable(VarEntry entry);
+    /// @brief Variable defined in the scope
+    struct Variable {
+        std::uint32_t slot;
+        /// Variable of the same name from an enclosing scope, which is restored when
+        /// this scope ends
+        VarSlot shadowed;
+    };
+
+    void addVariable(std::uint32_t slot, VarSlot shadowed) {
+        variables_.push_back({slot, std::move(shadowed)});
+    }
     void addFunction(const FuncDef* func);
     void addStruct(const StructDef* structDef);
     void addVariant(const VariantDef* variantDef);
 
-    std::optional<RefObj> getVariable(std::string_view name) const;
-    const FuncDef* getFunction(std::string_view name) const;
-    StructDefEntry getStructDef(std::string_view name) const;
-    VariantDefEntry getVariantDef(std::string_view name) const;
+    std::vector<Variable>& getVariables() { return variables_; }
+    bool hasFunctions() const { return !functions_.empty(); }
+    const FuncDef* getFunction(Symbol name) const;
+    StructDefEntry getStructDef(TypeId typeId) const;
+    VariantDefEntry getVariantDef(TypeId typeId) const;
 
    private:
-    std::vector<VarEntry> variables_;
+    std::vector<Variable> variables_;
     std::vector<FuncDefEntry> functions_;
     std::vector<StructDefEntry> structs_;
     std::vector<VariantDefEntry> variants_;
@@ -0,0 +1,482 @@
+#include "type_checker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <type_traits>
+
+#include "interpreter_errors.hpp"
+
+namespace {
+const Type* getBuiltInType(BuiltInType type) {
+    static const std::array types{
+        TypeChecker::intern(BuiltInType::INT), TypeChecker::intern(BuiltInType::FLOAT),
+        TypeChecker::intern(BuiltInType::BOOL), TypeChecker::intern(BuiltInType::STR)};
+    return types[static_cast<std::size_t>(type)];
+}
+
+bool isOneOf(const Type* type, std::initializer_list<BuiltInType> types) {
+    return std::ranges::any_of(types, [&](auto builtIn) {
+        return type == getBuiltInType(builtIn);
+    });
+}
+
+ReturnType toReturnType(const Type& type) {
+    return std::visit([](const auto& t) -> ReturnType { return t; }, type);
+}
+
+/// @brief Returns the type of the values returned from a function, std::nullopt for void
+std::optional<Type> getReturnedType(const ReturnType& type) {
+    return std::visit(
+        []<typename T>(const T& t) -> std::optional<Type> {
+            if constexpr (std::is_same_v<T, VoidType>)
+                return std::nullopt;
+            else
+                return t;
+        },
+        type);
+}
+}  // namespace
+
+/// @brief Annotates an expression and its subexpressions with their types
+class TypeChecker::ExpressionChecker : public ExpressionVisitor {
+   public:
+    explicit ExpressionChecker(TypeChecker& checker)
+        : checker_(checker) {}
+
+    void operator()(const StructInitExpression& expr) const override {
+        for (const auto& element : expr.exprs)
+            checker_.checkExpression(element);
+        expr.checkedType = nullptr;
+    }
+    void operator()(const DisjunctionExpression& expr) const override {
+        checkLogical(expr);
+    }
+    void operator()(const ConjunctionExpression& expr) const override {
+        checkLogical(expr);
+    }
+    void operator()(const EqualExpression& expr) const override { checkEquality(expr); }
+    void operator()(const NotEqualExpression& expr) const override {
+        checkEquality(expr);
+    }
+    void operator()(const LessThanExpression& expr) const override {
+        checkComparison(expr);
+    }
+    void operator()(const LessThanOrEqualExpression& expr) const override {
+        checkComparison(expr);
+    }
+    void operator()(const GreaterThanExpression& expr) const override {
+        checkComparison(expr);
+    }
+    void operator()(const GreaterThanOrEqualExpression& expr) const override {
+        checkComparison(expr);
+    }
+    void operator()(const AdditionExpression& expr) const override {
+        checkBinary(expr, {BuiltInType::INT, BuiltInType::FLOAT, BuiltInType::STR});
+    }
+    void operator()(const SubtractionExpression& expr) const override {
+        checkArithmetic(expr);
+    }
+    void operator()(const MultiplicationExpression& expr) const override {
+        checkArithmetic(expr);
+    }
+    void operator()(const DivisionExpression& expr) const override {
+        checkArithmetic(expr);
+    }
+    void operator()(const SignChangeExpression& expr) const override {
+        const auto type = checker_.checkExpression(expr.expr);
+        if (type && !isOneOf(type, {BuiltInType::INT, BuiltInType::FLOAT}))
+            throw TypeMismatch{expr.position, "Numeric", *type};
+        expr.checkedType = type;
+    }
+    void operator()(const LogicalNegationExpression& expr) const override {
+        checkBool(expr.expr);
+        expr.checkedType = getBuiltInType(BuiltInType::BOOL);
+    }
+    void operator()(const ConversionExpression& expr) const override {
+        checker_.checkExpression(expr.expr);
+        expr.checkedType = intern(expr.type);
+    }
+    void operator()(const TypeCheckExpression& expr) const override {
+        checker_.checkExpression(expr.expr);
+        expr.checkedType = getBuiltInType(BuiltInType::BOOL);
+    }
+    void operator()(const FieldAccessExpression& expr) const override {
+        const auto container = checker_.checkExpression(expr.expr);
+        expr.checkedType = nullptr;
+        if (!container)
+            return;
+
+        const auto name = std::get_if<std::string>(container);
+        if (!name || (!checker_.getStructDef(*name) && checker_.getVariantDef(*name)))
+            throw TypeMismatch{expr.position, "Named struct", *container};
+        expr.checkedType = checker_.getFieldType(*container, expr.field);
+    }
+    void operator()(const Constant& expr) const override {
+        expr.checkedType = std::visit(
+            []<typename T>(const T&) {
+                if constexpr (std::is_same_v<T, int>)
+                    return getBuiltInType(BuiltInType::INT);
+                else if constexpr (std::is_same_v<T, float>)
+                    return getBuiltInType(BuiltInType::FLOAT);
+                else if constexpr (std::is_same_v<T, bool>)
+                    return getBuiltInType(BuiltInType::BOOL);
+                else
+                    return getBuiltInType(BuiltInType::STR);
+            },
+            expr.value);
+    }
+    void operator()(const FuncCall& funcCall) const override {
+        checker_.checkArguments(funcCall);
+        funcCall.checkedType = nullptr;
+        if (const auto funcDef = checker_.getFunction(funcCall.name)) {
+            const auto returned = getReturnedType(funcDef->getReturnType());
+            if (!returned)
+                throw TypeMismatch{funcCall.position, "NON-VOID", "VOID"};
+            funcCall.checkedType = intern(*returned);
+        }
+    }
+    void operator()(const VariableAccess& expr) const override {
+        expr.checkedType = checker_.getVariableType(expr.slot);
+    }
+
+   private:
+    /// @brief Checks operands that must be of the same type, one of the accepted ones.
+    /// The result is of the type of the operands, unless given
+    void checkBinary(const BinaryExpression& expr,
+                     std::initializer_list<BuiltInType> types,
+                     const Type* result = nullptr) const {
+        const auto lhs = checker_.checkExpression(expr.lhs);
+        const auto rhs = checker_.checkExpression(expr.rhs);
+        if (lhs && rhs && (lhs != rhs || !isOneOf(lhs, types)))
+            throw TypeMismatch{expr.position, *lhs, *rhs};
+
+        expr.checked = lhs && rhs;
+        const auto operand = isOneOf(lhs, types)   ? lhs
+                             : isOneOf(rhs, types) ? rhs
+                                                   : nullptr;
+        expr.checkedType = result ? result : operand;
+    }
+
+    void checkArithmetic(const BinaryExpression& expr) const {
+        checkBinary(expr, {BuiltInType::INT, BuiltInType::FLOAT});
+    }
+    void checkComparison(const BinaryExpression& expr) const {
+        checkBinary(expr, {BuiltInType::INT, BuiltInType::FLOAT, BuiltInType::STR},
+                    getBuiltInType(BuiltInType::BOOL));
+    }
+    void checkEquality(const BinaryExpression& expr) const {
+        checkBinary(expr,
+                    {BuiltInType::INT, BuiltInType::FLOAT, BuiltInType::BOOL,
+                     BuiltInType::STR},
+                    getBuiltInType(BuiltInType::BOOL));
+    }
+
+    void checkLogical(const BinaryExpression& expr) const {
+        const auto lhs = checkBool(expr.lhs);
+        const auto rhs = checkBool(expr.rhs);
+        expr.checked = lhs && rhs;
+        expr.checkedType = getBuiltInType(BuiltInType::BOOL);
+    }
+
+    /// @brief Returns whether the operand is known to be a bool
+    bool checkBool(const PExpression& operand) const {
+        const auto type = checker_.checkExpression(operand);
+        if (type && type != getBuiltInType(BuiltInType::BOOL))
+            throw TypeMismatch{operand->position, BuiltInType::BOOL, *type};
+        return type != nullptr;
+    }
+
+    TypeChecker& checker_;
+};
+
+/// @brief Collects functions, structures and variants defined anywhere in the statements
+class TypeChecker::DefinitionCollector : public StatementVisitor {
+   public:
+    explicit DefinitionCollector(TypeChecker& checker)
+        : checker_(checker) {}
+
+    void collect(const Statements& statements) {
+        for (const auto& statement : statements)
+            statement->accept(*this);
+    }
+
+    void operator()(const IfStatement& stmt) override { collect(stmt.statements); }
+    void operator()(const WhileStatement& stmt) override { collect(stmt.statements); }
+    void operator()(const ReturnStatement&) override {}
+    void operator()(const PrintStatement&) override {}
+    void operator()(const FuncDef& stmt) override {
+        addDefinition(checker_.functions_, stmt.getName(), &stmt);
+        collect(stmt.getStatements());
+    }
+    void operator()(const Assignment&) override {}
+    void operator()(const VarDef&) override {}
+    void operator()(const FuncCall&) override {}
+    void operator()(const StructDef& stmt) override {
+        addDefinition(checker_.structs_, stmt.name, &stmt);
+    }
+    void operator()(const VariantDef& stmt) override {
+        addDefinition(checker_.variants_, stmt.name, &stmt);
+    }
+
+   private:
+    TypeChecker& checker_;
+};
+
+/// @brief Collects types of the variables defined in the blocks of one function's body
+class TypeChecker::VariableCollector : public StatementVisitor {
+   public:
+    explicit VariableCollector(Frame& frame)
+        : frame_(frame) {}
+
+    void collect(const Statements& statements) {
+        for (const auto& statement : statements)
+            statement->accept(*this);
+    }
+
+    void operator()(const IfStatement& stmt) override { collect(stmt.statements); }
+    void operator()(const WhileStatement& stmt) override { collect(stmt.statements); }
+    void operator()(const ReturnStatement&) override {}
+    void operator()(const PrintStatement&) override {}
+    void operator()(const FuncDef&) override {}
+    void operator()(const Assignment&) override {}
+    void operator()(const VarDef& stmt) override { frame_.define(stmt.slot, stmt.type); }
+    void operator()(const FuncCall&) override {}
+    void operator()(const StructDef&) override {}
+    void operator()(const VariantDef&) override {}
+
+   private:
+    Frame& frame_;
+};
+
+const Type* TypeChecker::intern(const Type& type) {
+    static std::mutex mutex;
+    static std::set<Type> types;
+    const std::scoped_lock lock(mutex);
+    return &*types.insert(type).first;
+}
+
+void TypeChecker::Frame::define(std::uint32_t slot, const Type& type) {
+    if (slot >= slots.size())
+        slots.resize(slot + 1);
+    auto& entry = slots[slot];
+    const auto interned = intern(type);
+    if (entry.type && entry.type != interned)
+        entry.ambiguous = true;
+    entry.type = interned;
+}
+
+void TypeChecker::check(const Program& program) {
+    functions_.clear();
+    structs_.clear();
+    variants_.clear();
+    DefinitionCollector(*this).collect(program.statements);
+
+    frames_.clear();
+    VariableCollector(frames_.emplace_back()).collect(program.statements);
+    for (const auto& statement : program.statements) {
+        topLevelStatement_ = statement.get();
+        statement->accept(*this);
+    }
+    frames_.clear();
+}
+
+const Type* TypeChecker::checkExpression(const PExpression& expr) {
+    if (!expr)
+        return nullptr;
+    expr->accept(ExpressionChecker(*this));
+    return expr->checkedType;
+}
+
+void TypeChecker::checkStatements(const Statements& statements) {
+    for (const auto& statement : statements)
+        statement->accept(*this);
+}
+
+void TypeChecker::checkFunction(const FuncDef& funcDef) {
+    auto& frame = frames_.emplace_back();
+    frame.function = &funcDef;
+    for (const auto& parameter : funcDef.getParameters())
+        frame.define(parameter.slot, parameter.type);
+    VariableCollector(frame).collect(funcDef.getStatements());
+
+    checkStatements(funcDef.getStatements());
+    funcDef.setReturnsChecked(frames_.back().returnsChecked);
+    frames_.pop_back();
+}
+
+void TypeChecker::checkArguments(const FuncCall& funcCall) {
+    const auto funcDef = getFunction(funcCall.name);
+    const auto& arguments = funcCall.arguments;
+    for (std::size_t i{0}; i < arguments.size(); ++i) {
+        const auto& argument = arguments[i];
+        const auto type = checkExpression(argument.value);
+        argument.checked = false;
+        // Wrong number or kind of arguments is reported at runtime
+        if (!funcDef || funcDef->getParameters().size() != arguments.size())
+            continue;
+        const auto& parameter = funcDef->getParameters()[i];
+        if (parameter.ref != argument.ref)
+            continue;
+
+        const auto compatibility = getCompatibility(parameter.type, type);
+        if (compatibility == Compatibility::MISMATCH)
+            throw TypeMismatch{argument.position, parameter.type, *type};
+        argument.checked = compatibility == Compatibility::SAME;
+    }
+}
+
+void TypeChecker::checkCondition(const ConditionalStatement& stmt) {
+    const auto type = checkExpression(stmt.condition);
+    if (type && type != getBuiltInType(BuiltInType::BOOL))
+        throw TypeMismatch{stmt.condition->position, BuiltInType::BOOL, *type};
+    stmt.checked = type != nullptr;
+    checkStatements(stmt.statements);
+}
+
+const Type* TypeChecker::getVariableType(VariableSlot slot) const {
+    // While a function's slot is empty, the variable of an enclosing function is used
+    // instead, so the types defined in all of those slots have to agree
+    auto frameIndex = frames_.size() - 1 - slot.depth;
+    auto index = slot.index;
+    const Type* type{nullptr};
+    while (true) {
+        const auto& frame = frames_[frameIndex];
+        if (index < frame.slots.size()) {
+            const auto& entry = frame.slots[index];
+            if (entry.ambiguous || (entry.type && type && entry.type != type))
+                return nullptr;
+            if (entry.type)
+                type = entry.type;
+        }
+
+        if (!frame.function)
+            return type;
+        const auto& outerSlots = frame.function->getFrame().outerSlots;
+        if (index >= outerSlots.size())
+            return type;
+        frameIndex -= outerSlots[index].depth;
+        index = outerSlots[index].index;
+    }
+}
+
+const Type* TypeChecker::getAssignedType(const LValue& lvalue, VariableSlot slot) const {
+    if (const auto fieldAccess = std::get_if<NodePtr<FieldAccess>>(&lvalue)) {
+        const auto container = getAssignedType((*fieldAccess)->container, slot);
+        return container ? getFieldType(*container, (*fieldAccess)->field) : nullptr;
+    }
+    return getVariableType(slot);
+}
+
+const Type* TypeChecker::getFieldType(const Type& container, Symbol field) const {
+    const auto name = std::get_if<std::string>(&container);
+    const auto structDef = name ? getStructDef(*name) : nullptr;
+    if (!structDef)
+        return nullptr;
+
+    const auto found = std::ranges::find(structDef->fields, field, &Field::name);
+    return found != structDef->fields.end() ? intern(found->type) : nullptr;
+}
+
+const FuncDef* TypeChecker::getFunction(Symbol name) const {
+    const auto found = functions_.find(name);
+    return found != functions_.end() ? found->second : nullptr;
+}
+
+const StructDef* TypeChecker::getStructDef(const std::string& name) const {
+    const auto found = structs_.find(name);
+    if (found == structs_.end() || variants_.contains(name))
+        return nullptr;
+    return found->second;
+}
+
+const VariantDef* TypeChecker::getVariantDef(const std::string& name) const {
+    const auto found = variants_.find(name);
+    if (found == variants_.end() || structs_.contains(name))
+        return nullptr;
+    return found->second;
+}
+
+TypeChecker::Compatibility TypeChecker::getCompatibility(const Type& expected,
+                                                         const Type* actual) const {
+    if (!actual)
+        return Compatibility::UNCERTAIN;
+    if (actual == intern(expected))
+        return Compatibility::SAME;
+
+    // Only anonymous structs, whose type is not known, are converted to structures
+    const auto name = std::get_if<std::string>(&expected);
+    if (!name || getStructDef(*name))
+        return Compatibility::MISMATCH;
+    if (const auto variantDef = getVariantDef(*name))
+        return std::ranges::find(variantDef->types, *actual) != variantDef->types.end()
+                   ? Compatibility::UNCERTAIN
+                   : Compatibility::MISMATCH;
+    return Compatibility::UNCERTAIN;
+}
+
+void TypeChecker::operator()(const IfStatement& stmt) { checkCondition(stmt); }
+
+void TypeChecker::operator()(const WhileStatement& stmt) { checkCondition(stmt); }
+
+void TypeChecker::operator()(const ReturnStatement& stmt) {
+    const auto type = checkExpression(stmt.expression);
+    if (frames_.size() == 1)
+        throw ReturnTypeMismatch{topLevelStatement_->position,
+                                 "No return in global scope",
+                                 "Returning in global scope"};
+
+    auto& frame = frames_.back();
+    const auto& expected = frame.function->getReturnType();
+    const auto returned = getReturnedType(expected);
+    if (!stmt.expression) {
+        if (returned)
+            throw ReturnTypeMismatch{stmt.position, expected, VoidType{}};
+        return;
+    }
+
+    if (!type) {
+        frame.returnsChecked = false;
+        return;
+    }
+    if (!returned)
+        throw ReturnTypeMismatch{stmt.position, expected, toReturnType(*type)};
+
+    const auto compatibility = getCompatibility(*returned, type);
+    if (compatibility == Compatibility::MISMATCH)
+        throw ReturnTypeMismatch{stmt.position, expected, toReturnType(*type)};
+    if (compatibility != Compatibility::SAME)
+        frame.returnsChecked = false;
+}
+
+void TypeChecker::operator()(const PrintStatement& stmt) {
+    checkExpression(stmt.expression);
+}
+
+void TypeChecker::operator()(const FuncDef& stmt) { checkFunction(stmt); }
+
+void TypeChecker::operator()(const Assignment& stmt) {
+    const auto type = checkExpression(stmt.rhs);
+    const auto target = getAssignedType(stmt.lhs, stmt.slot);
+    stmt.checked = false;
+    if (!target)
+        return;
+
+    const auto compatibility = getCompatibility(*target, type);
+    if (compatibility == Compatibility::MISMATCH)
+        throw TypeMismatch{stmt.position, *target, *type};
+    stmt.checked = compatibility == Compatibility::SAME;
+}
+
+void TypeChecker::operator()(const VarDef& stmt) {
+    const auto type = checkExpression(stmt.expression);
+    const auto compatibility = getCompatibility(stmt.type, type);
+    if (compatibility == Compatibility::MISMATCH)
+        throw TypeMismatch{stmt.position, stmt.type, *type};
+    stmt.checked = compatibility == Compatibility::SAME;
+}
+
+void TypeChecker::operator()(const FuncCall& stmt) { checkArguments(stmt); }
@@ -0,0 +1,108 @@
+#ifndef TYPE_CHECKER_H
+#define TYPE_CHECKER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "parse_tree.hpp"
+
+/// @brief Checks the types of a whole program before it is executed
+///
+/// A variable always holds a value of the type it is defined with, so the type of a
+/// variable access follows from the definitions bound to its slot by the NameResolver.
+/// Functions, structures and variants are looked up by name at runtime, so the checker
+/// relies only on names defined once in the whole program. Types it can not determine
+/// that way are left to the runtime checks.
+///
+/// Expressions are annotated with their types. Statements and operators proven to get
+/// values of the expected types are marked as checked, so that the interpreter can skip
+/// their runtime checks.
+class TypeChecker : public StatementVisitor {
+   public:
+    /// @brief Checks the program, whose variables must already be resolved
+    /// @param program
+    /// @throws TypeMismatch, ReturnTypeMismatch of the first error found
+    void check(const Program& program);
+
+    /// @brief Returns the interned copy of the type, equal types get the same pointer
+    /// @param type
+    static const Type* intern(const Type& type);
+
+    void operator()(const IfStatement& stmt) override;
+    void operator()(const WhileStatement& stmt) override;
+    void operator()(const ReturnStatement& stmt) override;
+    void operator()(const PrintStatement& stmt) override;
+    void operator()(const FuncDef& stmt) override;
+    void operator()(const Assignment& stmt) override;
+    void operator()(const VarDef& stmt) override;
+    void operator()(const FuncCall& stmt) override;
+    void operator()(const StructDef&) override {}
+    void operator()(const VariantDef&) override {}
+
+   private:
+    class ExpressionChecker;
+    class DefinitionCollector;
+    class VariableCollector;
+
+    /// @brief Whether a value of one type can be stored where another one is expected
+    enum class Compatibility {
+        SAME,
+        /// Not known or needs a conversion at runtime
+        UNCERTAIN,
+        MISMATCH,
+    };
+
+    /// @brief Types of the variables of a function's context, indexed by their slots
+    struct Frame {
+        struct Slot {
+            const Type* type{nullptr};
+            /// Whether the slot is shared by definitions of different types
+            bool ambiguous{false};
+        };
+
+        const FuncDef* function{nullptr};
+        std::vector<Slot> slots;
+        bool returnsChecked{true};
+
+        void define(std::uint32_t slot, const Type& type);
+    };
+
+    /// @brief Definitions found in the program, nullptr for names defined more than once
+    template <typename Definition>
+    using Definitions = std::unordered_map<std::string, const Definition*>;
+
+    /// @brief Adds the definition or marks its name as ambiguous
+    template <typename Key, typename Definition>
+    static void addDefinition(std::unordered_map<Key, const Definition*>& definitions,
+                              const Key& name, const Definition* definition) {
+        const auto [it, inserted] = definitions.try_emplace(name, definition);
+        if (!inserted)
+            it->second = nullptr;
+    }
+
+    const Type* checkExpression(const PExpression& expr);
+    void checkStatements(const Statements& statements);
+    void checkFunction(const FuncDef& funcDef);
+    void checkArguments(const FuncCall& funcCall);
+    void checkCondition(const ConditionalStatement& stmt);
+
+    const Type* getVariableType(VariableSlot slot) const;
+    const Type* getAssignedType(const LValue& lvalue, VariableSlot slot) const;
+    const Type* getFieldType(const Type& container, Symbol field) const;
+    const FuncDef* getFunction(Symbol name) const;
+    const StructDef* getStructDef(const std::string& name) const;
+    const VariantDef* getVariantDef(const std::string& name) const;
+
+    Compatibility getCompatibility(const Type& expected, const Type* actual) const;
+
+    std::unordered_map<Symbol, const FuncDef*> functions_;
+    Definitions<StructDef> structs_;
+    Definitions<VariantDef> variants_;
+    /// The global frame first, the frame of the function being checked last
+    std::vector<Frame> frames_;
+    /// The top level statement being checked
+    const Statement* topLevelStatement_{nullptr};
+};
+
+#endif
@@ -11,12 +11,19 @@ NamedStructObj::NamedStructObj(Values values, const StructDef* structDef)
             "Cannot instantiate StructObj without struct definition");
 }
 
-ValueObj* NamedStructObj::getField(std::string_view fieldName) const {
-    const auto field = std::ranges::find(structDef->fields, fieldName, &Field::name);
-    if (field == structDef->fields.end())
-        throw InvalidField{{}, fieldName};
-    const auto index = std::ranges::distance(structDef->fields.begin(), field);
-    return values.at(index).get();
+ValueObj* NamedStructObj::getField(Symbol fieldName, FieldIndex& fieldIndex) const {
+    // The name is compared too, as a definition released by reparsing may leave its
+    // address to a new one
+    const auto& fields = structDef->fields;
+    if (fieldIndex.structDef != structDef || fieldIndex.index >= fields.size() ||
+        fields[fieldIndex.index].name != fieldName) {
+        const auto field = std::ranges::find(fields, fieldName, &Field::name);
+        if (field == fields.end())
+            throw InvalidField{{}, fieldName.getText()};
+        const auto index = std::ranges::distance(fields.begin(), field);
+        fieldIndex = {.structDef = structDef, .index = static_cast<std::uint32_t>(index)};
+    }
+    return values[fieldIndex.index].get();
 }
 
 struct ValueCopier {
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "parse_tree.hpp"
+#include "shared_string.hpp"
 #include "types.hpp"
 
 struct ValueObj;
@@ -19,7 +20,11 @@ struct StructObj {
 /// @brief Struct with field names
 struct NamedStructObj : public StructObj {
     NamedStructObj(Values values, const StructDef* structDef);
-    ValueObj* getField(std::string_view fieldName) const;
+    /// @brief Returns the field, looking it up by name only if the cached index was not
+    /// found in this structure's definition
+    /// @param fieldName
+    /// @param fieldIndex index cached by the accessing node, updated on a miss
+    ValueObj* getField(Symbol fieldName, FieldIndex& fieldIndex) const;
 
     const StructDef* structDef;
 };
@@ -31,7 +36,7 @@ struct VariantObj {
 
 /// @brief Object owning a value
 struct ValueObj {
-    using Value = std::variant<Integral, Floating, bool, std::string, StructObj,
+    using Value = std::variant<Integral, Floating, bool, SharedString, StructObj,
                                NamedStructObj, VariantObj>;
     Value value;
 };
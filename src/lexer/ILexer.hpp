@@ -1,11 +1,37 @@
 #ifndef I_LEXER_H
 #define I_LEXER_H
 
+#include <span>
+
+#include "compact_token.hpp"
 #include "token.hpp"
+#include "token_table.hpp"
 
 class ILexer {
    public:
     virtual Token getToken() = 0;
+
+    /// @brief Fills the buffer with subsequent tokens. Stops after the end-of-text token
+    ///
+    /// Lexers that can not amortize the per-token cost implement it with
+    /// getTokensOneByOne()
+    /// @param tokens
+    /// @return Number of tokens written. Less than the buffer size only if the last
+    /// token written is the end-of-text token or producing the next token failed. In the
+    /// latter case the failure is reported by the next call
+    virtual std::size_t getTokens(std::span<Token> tokens) = 0;
+
+    /// @brief Fills the buffer with subsequent tokens in the compact form, resolved by
+    /// getTokenTable(). Behaves like getTokens()
+    ///
+    /// Lexers producing only whole tokens implement it with a CompactTokenConverter
+    /// @param tokens
+    /// @return Number of tokens written
+    virtual std::size_t getCompactTokens(std::span<CompactToken> tokens) = 0;
+
+    /// @brief Returns the table resolving tokens returned by getCompactTokens()
+    virtual const TokenTable& getTokenTable() const = 0;
+
     virtual ~ILexer() = default;
 };
 
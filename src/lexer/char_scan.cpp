@@ -0,0 +1,103 @@
+#include "char_scan.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr bool isWhiteSpace(char c) {
+    return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+#if defined(__AVX2__)
+
+constexpr std::size_t blockSize{32};
+using Block = __m256i;
+
+Block load(const char* data) {
+    return _mm256_loadu_si256(reinterpret_cast<const Block*>(data));
+}
+
+unsigned int whiteSpaceMask(Block block) {
+    const auto shifted = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+    const auto maxShifted = _mm256_set1_epi8('\r' - '\t');
+    const auto controls =
+        _mm256_cmpeq_epi8(_mm256_max_epu8(shifted, maxShifted), maxShifted);
+    const auto spaces = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+    const auto whiteSpaces = _mm256_or_si256(controls, spaces);
+    return static_cast<unsigned int>(_mm256_movemask_epi8(whiteSpaces));
+}
+
+unsigned int newLineMask(Block block) {
+    const auto newLines = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'));
+    return static_cast<unsigned int>(_mm256_movemask_epi8(newLines));
+}
+
+constexpr unsigned int fullMask{0xFFFFFFFFu};
+
+#elif defined(__SSE2__)
+
+constexpr std::size_t blockSize{16};
+using Block = __m128i;
+
+Block load(const char* data) {
+    return _mm_loadu_si128(reinterpret_cast<const Block*>(data));
+}
+
+unsigned int whiteSpaceMask(Block block) {
+    const auto shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    const auto maxShifted = _mm_set1_epi8('\r' - '\t');
+    const auto controls = _mm_cmpeq_epi8(_mm_max_epu8(shifted, maxShifted), maxShifted);
+    const auto spaces = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+    const auto whiteSpaces = _mm_or_si128(controls, spaces);
+    return static_cast<unsigned int>(_mm_movemask_epi8(whiteSpaces));
+}
+
+unsigned int newLineMask(Block block) {
+    const auto newLines = _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'));
+    return static_cast<unsigned int>(_mm_movemask_epi8(newLines));
+}
+
+constexpr unsigned int fullMask{0xFFFFu};
+
+#endif
+
+}  // namespace
+
+std::size_t skipWhiteSpace(std::string_view text, std::size_t begin) {
+    auto offset = begin;
+
+    // Most runs between tokens are a single space or none at all
+    if (offset >= text.size() || !isWhiteSpace(text[offset]))
+        return offset;
+    ++offset;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    for (; offset + blockSize <= text.size(); offset += blockSize) {
+        const auto mask = whiteSpaceMask(load(text.data() + offset));
+        if (mask != fullMask)
+            return offset + __builtin_ctz(~mask & fullMask);
+    }
+#endif
+
+    while (offset < text.size() && isWhiteSpace(text[offset]))
+        ++offset;
+    return offset;
+}
+
+std::size_t findLineEnd(std::string_view text, std::size_t begin) {
+    auto offset = begin;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    for (; offset + blockSize <= text.size(); offset += blockSize) {
+        const auto mask = newLineMask(load(text.data() + offset));
+        if (mask)
+            return offset + __builtin_ctz(mask);
+    }
+#endif
+
+    while (offset < text.size() && text[offset] != '\n')
+        ++offset;
+    return offset;
+}
@@ -0,0 +1,22 @@
+#ifndef CHAR_SCAN_H
+#define CHAR_SCAN_H
+
+#include <cstddef>
+#include <string_view>
+
+/// @brief Returns offset of the first character at or after begin that is not a
+/// whitespace (as classified by std::isspace in the "C" locale)
+///
+/// Long runs are scanned 32 (AVX2) or 16 (SSE2) characters at a time
+/// @param text
+/// @param begin
+/// @return Offset of the first non-whitespace character or text size if there is none
+std::size_t skipWhiteSpace(std::string_view text, std::size_t begin);
+
+/// @brief Returns offset of the first new line character at or after begin
+/// @param text
+/// @param begin
+/// @return Offset of the new line character or text size if there is none
+std::size_t findLineEnd(std::string_view text, std::size_t begin);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef COMPACT_TOKEN_H
+#define COMPACT_TOKEN_H
+
+#include <bit>
+#include <cstdint>
+
+#include "symbol.hpp"
+#include "token.hpp"
+#include "types.hpp"
+
+/// @brief Token packed into 12 bytes, passed from lexers to the parser
+///
+/// Instead of a position it holds the byte offset of the token in the source and instead
+/// of a value a 32-bit payload: the value itself for numbers, bools and identifiers or an
+/// index of the string in the TokenTable. Positions and strings are resolved by the
+/// TokenTable of the lexer that returned the token
+class CompactToken {
+   public:
+    /// @brief Constructs a token of type unknown
+    CompactToken() = default;
+
+    CompactToken(Token::Type type, std::uint32_t offset, std::uint32_t payload = 0)
+        : type_(type), offset_(offset), payload_(payload) {}
+
+    Token::Type getType() const { return type_; }
+    std::uint32_t getOffset() const { return offset_; }
+    std::uint32_t getPayload() const { return payload_; }
+
+    Integral getIntegral() const { return std::bit_cast<Integral>(payload_); }
+    Floating getFloating() const { return std::bit_cast<Floating>(payload_); }
+    bool getBool() const { return payload_ != 0; }
+    Symbol getSymbol() const { return Symbol::fromId(payload_); }
+
+    /// @brief Is one of the constants (e.g. int, bool, str)
+    bool isConstant() const { return Token::isConstant(type_); }
+
+    /// @brief Is the payload an index of a string in the TokenTable
+    bool hasString() const {
+        return type_ == Token::Type::STR_CONST || type_ == Token::Type::CMT;
+    }
+
+    static std::uint32_t pack(Integral value) {
+        return std::bit_cast<std::uint32_t>(value);
+    }
+    static std::uint32_t pack(Floating value) {
+        return std::bit_cast<std::uint32_t>(value);
+    }
+    static std::uint32_t pack(bool value) { return value; }
+    static std::uint32_t pack(Symbol value) { return value.getId(); }
+
+   private:
+    Token::Type type_{Token::Type::UNKNOWN};
+    std::uint32_t offset_{0};
+    std::uint32_t payload_{0};
+};
+
+static_assert(sizeof(CompactToken) == 12);
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef FILTER_H
 #define FILTER_H
 
+#include <algorithm>
+
 #include "ILexer.hpp"
 
 /// @brief Exception thrown when trying to instantiate
@@ -40,7 +42,36 @@ class Filter : public ILexer {
         return token;
     }
 
+    /// @brief Fills the buffer with tokens from the decorated ILexer, leaving out the
+    /// ignored ones
+    /// @param tokens
+    /// @return Number of tokens written. Nonzero for a nonempty buffer
+    std::size_t getTokens(std::span<Token> tokens) override {
+        return filterTokens(tokens, &ILexer::getTokens);
+    }
+
+    std::size_t getCompactTokens(std::span<CompactToken> tokens) override {
+        return filterTokens(tokens, &ILexer::getCompactTokens);
+    }
+
+    const TokenTable& getTokenTable() const override { return lexer_.getTokenTable(); }
+
    private:
+    template <typename T>
+    std::size_t filterTokens(std::span<T> tokens,
+                             std::size_t (ILexer::*getLexerTokens)(std::span<T>)) {
+        if (tokens.empty())
+            return 0;
+
+        std::size_t count{0};
+        while (count == 0) {
+            const auto read = tokens.first((lexer_.*getLexerTokens)(tokens));
+            const auto kept = std::ranges::remove(read, ignore_, &T::getType);
+            count = read.size() - kept.size();
+        }
+        return count;
+    }
+
     ILexer& lexer_;
     Token::Type ignore_;
 };
@@ -0,0 +1,96 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "token.hpp"
+
+/// @brief Compile-time perfect hash table of keywords and bool constants
+class Keywords {
+   public:
+    /// @brief Returns the token type of the keyword or bool constant spelled by the
+    /// lexeme. Doesn't allocate and compares at most one table entry
+    /// @param lexeme
+    /// @return Token type or std::nullopt if the lexeme is an identifier
+    static constexpr std::optional<Token::Type> find(std::string_view lexeme) {
+        if (lexeme.size() < minLength_ || lexeme.size() > maxLength_)
+            return std::nullopt;
+
+        const auto& entry = table_[hash(lexeme, seed_)];
+        if (entry.lexeme == lexeme)
+            return entry.type;
+        return std::nullopt;
+    }
+
+   private:
+    struct Entry {
+        std::string_view lexeme;
+        Token::Type type;
+    };
+
+    static constexpr std::array<Entry, 20> keywords_{{
+        {"if", Token::Type::IF_KW},
+        {"while", Token::Type::WHILE_KW},
+        {"return", Token::Type::RETURN_KW},
+        {"print", Token::Type::PRINT_KW},
+        {"const", Token::Type::CONST_KW},
+        {"ref", Token::Type::REF_KW},
+        {"struct", Token::Type::STRUCT_KW},
+        {"variant", Token::Type::VARIANT_KW},
+        {"or", Token::Type::OR_KW},
+        {"and", Token::Type::AND_KW},
+        {"not", Token::Type::NOT_KW},
+        {"as", Token::Type::AS_KW},
+        {"is", Token::Type::IS_KW},
+        {"void", Token::Type::VOID_KW},
+        {"int", Token::Type::INT_KW},
+        {"float", Token::Type::FLOAT_KW},
+        {"bool", Token::Type::BOOL_KW},
+        {"str", Token::Type::STR_KW},
+        {"true", Token::Type::TRUE_CONST},
+        {"false", Token::Type::FALSE_CONST},
+    }};
+
+    static constexpr std::size_t tableSize_{64};
+    using Table = std::array<Entry, tableSize_>;
+
+    /// Mixes the length with the first, middle and last character
+    static constexpr std::size_t hash(std::string_view lexeme, std::uint32_t seed) {
+        std::uint32_t h{seed ^ static_cast<std::uint32_t>(lexeme.size())};
+        for (const auto c : {lexeme.front(), lexeme[lexeme.size() / 2], lexeme.back()})
+            h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+        return (h >> 16) % tableSize_;
+    }
+
+    static constexpr std::optional<Table> makeTable(std::uint32_t seed) {
+        Table table{};
+        for (const auto& keyword : keywords_) {
+            auto& entry = table[hash(keyword.lexeme, seed)];
+            if (!entry.lexeme.empty())
+                return std::nullopt;
+            entry = keyword;
+        }
+        return table;
+    }
+
+    static constexpr std::uint32_t findSeed() {
+        std::uint32_t seed{1};
+        while (!makeTable(seed))
+            ++seed;
+        return seed;
+    }
+
+    static constexpr std::size_t minLength_{2};
+    static constexpr std::size_t maxLength_{7};
+
+    static const std::uint32_t seed_;
+    static const Table table_;
+};
+
+inline constexpr std::uint32_t Keywords::seed_{findSeed()};
+inline constexpr Keywords::Table Keywords::table_{*makeTable(seed_)};
+
+#endif
@@ -1,152 +1,188 @@
 #include "lexer.hpp"
 
 #include <algorithm>
-#include <cmath>
+#include <charconv>
+#include <cstdint>
 #include <limits>
 #include <string_view>
+#include <utility>
 
+#include "char_scan.hpp"
+#include "keywords.hpp"
 #include "lexer_errors.hpp"
-#include "magic_enum/magic_enum.hpp"
 
 bool isAlnumOrUnderscore(char c);
-bool isAnyUpperCase(std::string_view s);
+std::size_t skipDigits(std::string_view text, std::size_t offset);
 Integral charToDigit(char c);
 bool willOverflow(Integral value, Integral digit);
-std::string lexemeToKeyword(std::string_view lexeme);
+bool isBelowOne(std::string_view floatLiteral);
 
-Token Lexer::getToken() {
+CompactToken Lexer::getCompactToken() {
     ignoreWhiteSpace();
 
-    tokenPosition_ = source_.getPosition();
+    tokenOffset_ = source_.getOffset();
 
-    for (const auto& builder : tokenBuilders_) {
-        if (auto token = builder(*this))
-            return token.value();
-    }
+    const auto builder = tokenBuilders_[static_cast<unsigned char>(source_.getChar())];
+    return (this->*builder)();
+}
 
-    throw InvalidToken(tokenPosition_, source_.getChar());
+std::size_t Lexer::getTokens(std::span<Token> tokens) {
+    return fillTokens(tokens, [this] { return table_.getToken(getCompactToken()); });
 }
 
-void Lexer::ignoreWhiteSpace() const {
-    while (std::isspace(source_.getChar())) {
-        source_.nextChar();
-    }
+std::size_t Lexer::getCompactTokens(std::span<CompactToken> tokens) {
+    return fillTokens(tokens, [this] { return getCompactToken(); });
 }
 
-std::optional<Token> Lexer::buildIdOrKeyword() const {
-    if (!std::isalpha(source_.getChar()))
-        return std::nullopt;
+template <typename T, typename Lex>
+std::size_t Lexer::fillTokens(std::span<T> tokens, Lex lex) {
+    if (pendingError_)
+        std::rethrow_exception(std::exchange(pendingError_, nullptr));
+
+    std::size_t count{0};
+    try {
+        while (count < tokens.size()) {
+            tokens[count] = lex();
+            if (tokens[count++].getType() == Token::Type::ETX)
+                break;
+        }
+    } catch (...) {
+        if (count == 0)
+            throw;
+        pendingError_ = std::current_exception();
+    }
+    return count;
+}
 
-    std::string lexeme;
+Position Lexer::getTokenPosition() const {
+    return source_.getBuffer()->getPosition(tokenOffset_);
+}
 
-    do {
-        lexeme.push_back(source_.getChar());
-        source_.nextChar();
-    } while (isAlnumOrUnderscore(source_.getChar()));
+CompactToken Lexer::makeToken(Token::Type type, std::uint32_t payload) const {
+    return CompactToken(type, static_cast<std::uint32_t>(tokenOffset_), payload);
+}
 
-    if (auto token = buildKeyword(lexeme))
-        return token;
+void Lexer::ignoreWhiteSpace() const {
+    const auto text = source_.getText();
 
-    if (auto token = buildBoolConst(lexeme))
-        return token;
+    auto offset = skipWhiteSpace(text, source_.getOffset());
+    if (comments_ == Comments::SKIP)
+        while (offset < text.size() && text[offset] == '#')
+            offset = skipWhiteSpace(text, findLineEnd(text, offset));
 
-    return Token(Token::Type::ID, std::move(lexeme), tokenPosition_);
+    source_.seek(offset);
 }
 
-bool isAlnumOrUnderscore(char c) {
-    return std::isalnum(c) || c == '_';
-}
+CompactToken Lexer::buildIdOrKeyword() {
+    const auto begin = source_.getOffset();
 
-std::optional<Token> Lexer::buildKeyword(std::string_view lexeme) const {
-    if (isAnyUpperCase(lexeme))
-        return std::nullopt;
+    do {
+        source_.nextChar();
+    } while (isAlnumOrUnderscore(source_.getChar()));
 
-    auto keyword = lexemeToKeyword(lexeme);
+    const auto lexeme = source_.getTextFrom(begin);
 
-    if (auto tokenType = magic_enum::enum_cast<Token::Type>(keyword))
-        return Token(tokenType.value(), {}, tokenPosition_);
-    return std::nullopt;
-}
+    if (const auto type = Keywords::find(lexeme))
+        return buildKeyword(*type);
 
-bool isAnyUpperCase(std::string_view s) {
-    return std::any_of(s.begin(), s.end(), [](char c) { return std::isupper(c); });
+    return makeToken(Token::Type::ID, CompactToken::pack(Symbol(lexeme)));
 }
 
-std::string lexemeToKeyword(std::string_view lexeme) {
-    static const std::string_view suffix{"_KW"};
-
-    std::string keyword(lexeme.size(), ' ');
-    std::transform(lexeme.begin(), lexeme.end(), keyword.begin(),
-                   [](char c) { return std::toupper(c); });
-    keyword += suffix;
-
-    return keyword;
+bool isAlnumOrUnderscore(char c) {
+    return std::isalnum(c) || c == '_';
 }
 
-std::optional<Token> Lexer::buildBoolConst(std::string_view lexeme) const {
-    if (lexeme == "true")
-        return Token(Token::Type::TRUE_CONST, true, tokenPosition_);
-    if (lexeme == "false")
-        return Token(Token::Type::FALSE_CONST, false, tokenPosition_);
-    return std::nullopt;
+CompactToken Lexer::buildKeyword(Token::Type type) {
+    if (type == Token::Type::TRUE_CONST)
+        return makeToken(type, CompactToken::pack(true));
+    return makeToken(type);
 }
 
-std::optional<Token> Lexer::buildIntConst() const {
-    if (source_.getChar() == '0') {
-        source_.nextChar();
+CompactToken Lexer::buildNumericConst() {
+    const auto text = source_.getText();
+    const auto begin = source_.getOffset();
 
-        if (auto token = buildFloatConst(0))
-            return token;
+    // A leading zero is a literal on its own
+    auto end = text[begin] == '0' ? begin + 1 : skipDigits(text, begin);
+    auto isFloat = false;
 
-        return Token(Token::Type::INT_CONST, 0, tokenPosition_);
+    if (end < text.size() && text[end] == '.') {
+        const auto fractionEnd = skipDigits(text, end + 1);
+        if (fractionEnd == end + 1)
+            throw InvalidFloat(getTokenPosition(), '.');
+        end = fractionEnd;
+        isFloat = true;
     }
 
-    if (auto res = buildNumber()) {
-        const auto& [integralPart, _] = res.value();
-
-        if (auto token = buildFloatConst(integralPart))
-            return token;
-
-        return Token(Token::Type::INT_CONST, integralPart, tokenPosition_);
+    if (const auto exponentEnd = scanExponent(text, end); exponentEnd != end) {
+        end = exponentEnd;
+        isFloat = true;
     }
 
-    return std::nullopt;
+    source_.seek(end);
+    const auto literal = text.substr(begin, end - begin);
+    if (isFloat)
+        return buildFloatConst(literal);
+    return buildIntConst(literal);
 }
 
-std::optional<Token> Lexer::buildFloatConst(Integral integralPart) const {
-    if (source_.getChar() != '.')
-        return std::nullopt;
+std::size_t Lexer::scanExponent(std::string_view text, std::size_t offset) const {
+    if (offset >= text.size() || (text[offset] != 'e' && text[offset] != 'E'))
+        return offset;
+
+    auto digits = offset + 1;
+    if (digits < text.size() && (text[digits] == '+' || text[digits] == '-'))
+        ++digits;
+    else if (skipDigits(text, digits) == digits)
+        // Not an exponent, e.g. an identifier right after the literal
+        return offset;
+
+    const auto end = skipDigits(text, digits);
+    if (end == digits)
+        throw InvalidFloat(getTokenPosition(), text[offset]);
+    return end;
+}
 
-    source_.nextChar();
+CompactToken Lexer::buildIntConst(std::string_view literal) const {
+    Integral value{0};
+    const auto result =
+        std::from_chars(literal.data(), literal.data() + literal.size(), value);
+    if (result.ec == std::errc::result_out_of_range)
+        throwIntegralOverflow(literal);
 
-    if (auto res = buildNumber()) {
-        const auto& [fractionalPart, digitCount] = res.value();
-        const int exponent{-static_cast<int>(digitCount)};
+    return makeToken(Token::Type::INT_CONST, CompactToken::pack(value));
+}
 
-        const Floating value = integralPart + fractionalPart * std::pow(10, exponent);
-        return Token(Token::Type::FLOAT_CONST, value, tokenPosition_);
+CompactToken Lexer::buildFloatConst(std::string_view literal) const {
+    // Parsed straight into Floating, so the value is correctly rounded
+    Floating value{0};
+    const auto result =
+        std::from_chars(literal.data(), literal.data() + literal.size(), value);
+    if (result.ec == std::errc::result_out_of_range) {
+        // Also reported for values too small even for a denormal, which round to 0
+        if (!isBelowOne(literal))
+            throw NumericOverflow(getTokenPosition(), literal);
+        value = 0;
     }
 
-    throw InvalidFloat(tokenPosition_);
+    return makeToken(Token::Type::FLOAT_CONST, CompactToken::pack(value));
 }
 
-std::optional<Lexer::IntWithDigitCount> Lexer::buildNumber() const {
-    if (!std::isdigit(source_.getChar()))
-        return std::nullopt;
-
+void Lexer::throwIntegralOverflow(std::string_view digits) const {
     Integral value{0};
-    unsigned int digitCount{0};
-
-    do {
-        auto digit = charToDigit(source_.getChar());
+    for (const auto c : digits) {
+        const auto digit = charToDigit(c);
         if (willOverflow(value, digit))
-            throw NumericOverflow(tokenPosition_, value, digit);
+            throw NumericOverflow(getTokenPosition(), value, digit);
         value = 10 * value + digit;
-        source_.nextChar();
-        ++digitCount;
-    } while (std::isdigit(source_.getChar()));
+    }
+    throw NumericOverflow(getTokenPosition(), digits);
+}
 
-    return {{value, digitCount}};
+std::size_t skipDigits(std::string_view text, std::size_t offset) {
+    while (offset < text.size() && text[offset] >= '0' && text[offset] <= '9')
+        ++offset;
+    return offset;
 }
 
 Integral charToDigit(char c) {
@@ -159,12 +195,49 @@ bool willOverflow(Integral value, Integral digit) {
     return value > maxSafe;
 }
 
-std::optional<Token> Lexer::buildStrConst() const {
-    if (source_.getChar() != '"')
-        return std::nullopt;
+bool isBelowOne(std::string_view floatLiteral) {
+    const auto mantissa = floatLiteral.substr(0, floatLiteral.find_first_of("eE"));
+    auto exponentDigits = floatLiteral.substr(mantissa.size());
+    if (!exponentDigits.empty())
+        exponentDigits.remove_prefix(1);
+    const auto negative = exponentDigits.starts_with('-');
+    if (negative || exponentDigits.starts_with('+'))
+        exponentDigits.remove_prefix(1);
+
+    std::int64_t exponent{0};
+    const auto end = exponentDigits.data() + exponentDigits.size();
+    if (std::from_chars(exponentDigits.data(), end, exponent).ec ==
+        std::errc::result_out_of_range)
+        return negative;
+    if (negative)
+        exponent = -exponent;
+
+    // Decimal exponent of the first significant digit. The integer part is either a
+    // single zero or starts with a significant digit
+    const auto integerPart = mantissa.substr(0, mantissa.find('.'));
+    const auto magnitude =
+        integerPart == "0"
+            ? -static_cast<std::int64_t>(mantissa.find_first_not_of('0', 2) - 1)
+            : static_cast<std::int64_t>(integerPart.size()) - 1;
+    return magnitude + exponent < 0;
+}
+
+CompactToken Lexer::buildStrConst() {
     source_.nextChar();
 
-    std::string strConst;
+    const auto text = source_.getText();
+    const auto begin = source_.getOffset();
+    const auto end = std::min(text.find_first_of("\"\\", begin), text.size());
+    const auto unescaped = text.substr(begin, end - begin);
+    source_.seek(end);
+
+    // Literals without escape sequences are the source text itself
+    if (source_.getChar() == '"') {
+        source_.nextChar();
+        return makeToken(Token::Type::STR_CONST, table_.addSourceString(unescaped));
+    }
+
+    std::string strConst(unescaped);
 
     while (source_.getChar() != '"') {
         expectNoEndOfFile();
@@ -181,101 +254,135 @@ std::optional<Token> Lexer::buildStrConst() const {
     }
 
     source_.nextChar();
-    return Token(Token::Type::STR_CONST, std::move(strConst), tokenPosition_);
+    return makeToken(Token::Type::STR_CONST, table_.addString(std::move(strConst)));
 }
 
 void Lexer::expectNoEndOfFile() const {
     if (source_.getChar() == EOF)
-        throw NotTerminatedStrConst(tokenPosition_);
+        throw NotTerminatedStrConst(getTokenPosition());
 }
 
 char Lexer::findInEscapedChars(char searched) const {
     auto res = std::ranges::find(escapedChars_, searched, &CharPair::first);
 
     if (res == escapedChars_.end())
-        throw NonEscapableChar(tokenPosition_, source_.getChar());
+        throw NonEscapableChar(getTokenPosition(), source_.getChar());
     return res->second;
 }
 
-std::optional<Token> Lexer::buildComment() const {
-    if (source_.getChar() != '#')
-        return std::nullopt;
+CompactToken Lexer::buildComment() {
     source_.nextChar();
 
-    std::string value;
+    const auto begin = source_.getOffset();
+    source_.seek(findLineEnd(source_.getText(), begin));
 
-    while (source_.getChar() != '\n' && source_.getChar() != EOF) {
-        value.push_back(source_.getChar());
-        source_.nextChar();
-    }
-    return Token(Token::Type::CMT, std::move(value), tokenPosition_);
+    const auto index = table_.addSourceString(source_.getTextFrom(begin));
+    return makeToken(Token::Type::CMT, index);
 }
 
-std::optional<Token> Lexer::buildNotEqualOp() const {
-    if (source_.getChar() != '!')
-        return std::nullopt;
-
+CompactToken Lexer::buildNotEqualOp() {
     source_.nextChar();
 
     if (source_.getChar() == '=') {
         source_.nextChar();
-        return Token(Token::Type::NEQ_OP, {}, tokenPosition_);
+        return makeToken(Token::Type::NEQ_OP);
     }
 
-    throw InvalidToken(tokenPosition_, '!');
+    throw InvalidToken(getTokenPosition(), '!');
 }
 
-std::optional<Token> Lexer::buildOneLetterOp(char c, Token::Type type) const {
-    if (source_.getChar() != c)
-        return std::nullopt;
+struct TwoLetterOp {
+    char second;
+    Token::Type oneLetterType;
+    Token::Type twoLetterType;
+};
+
+using CharTable = std::array<Token::Type, 256>;
+using TwoLetterOpTable = std::array<TwoLetterOp, 256>;
 
-    source_.nextChar();
-    return Token(type, {}, tokenPosition_);
+constexpr std::size_t tableIndex(char c) {
+    return static_cast<unsigned char>(c);
+}
+
+constexpr CharTable makeOneLetterOps() {
+    CharTable ops{};
+    ops[tableIndex(';')] = Token::Type::SEMI;
+    ops[tableIndex(',')] = Token::Type::CMA;
+    ops[tableIndex('.')] = Token::Type::DOT;
+    ops[tableIndex('+')] = Token::Type::ADD_OP;
+    ops[tableIndex('-')] = Token::Type::MIN_OP;
+    ops[tableIndex('*')] = Token::Type::MULT_OP;
+    ops[tableIndex('/')] = Token::Type::DIV_OP;
+    ops[tableIndex('(')] = Token::Type::L_PAR;
+    ops[tableIndex(')')] = Token::Type::R_PAR;
+    ops[tableIndex('{')] = Token::Type::L_C_BR;
+    ops[tableIndex('}')] = Token::Type::R_C_BR;
+    return ops;
 }
 
-std::optional<Token> Lexer::buildTwoLetterOp(CharPair chars, TokenTypes types) const {
-    if (source_.getChar() != chars.first)
-        return std::nullopt;
+constexpr TwoLetterOpTable makeTwoLetterOps() {
+    TwoLetterOpTable ops{};
+    ops[tableIndex('<')] = {'=', Token::Type::LT_OP, Token::Type::LTE_OP};
+    ops[tableIndex('>')] = {'=', Token::Type::GT_OP, Token::Type::GTE_OP};
+    ops[tableIndex('=')] = {'=', Token::Type::ASGN_OP, Token::Type::EQ_OP};
+    return ops;
+}
+
+constexpr CharTable oneLetterOps{makeOneLetterOps()};
+constexpr TwoLetterOpTable twoLetterOps{makeTwoLetterOps()};
+
+CompactToken Lexer::buildOneLetterOp() {
+    const auto type = oneLetterOps[tableIndex(source_.getChar())];
+    source_.nextChar();
+    return makeToken(type);
+}
 
+CompactToken Lexer::buildTwoLetterOp() {
+    const auto& op = twoLetterOps[tableIndex(source_.getChar())];
     source_.nextChar();
 
-    if (source_.getChar() != chars.second)
-        return Token(types.first, {}, tokenPosition_);
+    if (source_.getChar() != op.second)
+        return makeToken(op.oneLetterType);
 
     source_.nextChar();
-    return Token(types.second, {}, tokenPosition_);
-}
-
-Lexer::TokenBuilders Lexer::tokenBuilders_{
-    [](Lexer& l) { return l.buildIdOrKeyword(); },
-    [](Lexer& l) { return l.buildIntConst(); },
-    [](Lexer& l) { return l.buildStrConst(); },
-    [](Lexer& l) { return l.buildComment(); },
-    [](Lexer& l) { return l.buildNotEqualOp(); },
-
-    [](Lexer& l) { return l.buildOneLetterOp(';', Token::Type::SEMI); },
-    [](Lexer& l) { return l.buildOneLetterOp(',', Token::Type::CMA); },
-    [](Lexer& l) { return l.buildOneLetterOp('.', Token::Type::DOT); },
-    [](Lexer& l) { return l.buildOneLetterOp('+', Token::Type::ADD_OP); },
-    [](Lexer& l) { return l.buildOneLetterOp('-', Token::Type::MIN_OP); },
-    [](Lexer& l) { return l.buildOneLetterOp('*', Token::Type::MULT_OP); },
-    [](Lexer& l) { return l.buildOneLetterOp('/', Token::Type::DIV_OP); },
-    [](Lexer& l) { return l.buildOneLetterOp('(', Token::Type::L_PAR); },
-    [](Lexer& l) { return l.buildOneLetterOp(')', Token::Type::R_PAR); },
-    [](Lexer& l) { return l.buildOneLetterOp('{', Token::Type::L_C_BR); },
-    [](Lexer& l) { return l.buildOneLetterOp('}', Token::Type::R_C_BR); },
-    [](Lexer& l) { return l.buildOneLetterOp(EOF, Token::Type::ETX); },
-
-    [](Lexer& l) {
-        return l.buildTwoLetterOp({'<', '='}, {Token::Type::LT_OP, Token::Type::LTE_OP});
-    },
-    [](Lexer& l) {
-        return l.buildTwoLetterOp({'>', '='}, {Token::Type::GT_OP, Token::Type::GTE_OP});
-    },
-    [](Lexer& l) {
-        return l.buildTwoLetterOp({'=', '='}, {Token::Type::ASGN_OP, Token::Type::EQ_OP});
-    },
-};
+    return makeToken(op.twoLetterType);
+}
+
+CompactToken Lexer::buildEndOfText() {
+    source_.nextChar();
+    return makeToken(Token::Type::ETX);
+}
+
+CompactToken Lexer::buildInvalidToken() {
+    throw InvalidToken(getTokenPosition(), source_.getChar());
+}
+
+constexpr Lexer::TokenBuilders Lexer::makeTokenBuilders() {
+    TokenBuilders builders{};
+    builders.fill(&Lexer::buildInvalidToken);
+
+    for (char c{'a'}; c <= 'z'; ++c)
+        builders[tableIndex(c)] = &Lexer::buildIdOrKeyword;
+    for (char c{'A'}; c <= 'Z'; ++c)
+        builders[tableIndex(c)] = &Lexer::buildIdOrKeyword;
+    for (char c{'0'}; c <= '9'; ++c)
+        builders[tableIndex(c)] = &Lexer::buildNumericConst;
+
+    for (std::size_t i{0}; i < builders.size(); ++i) {
+        if (oneLetterOps[i] != Token::Type::UNKNOWN)
+            builders[i] = &Lexer::buildOneLetterOp;
+        if (twoLetterOps[i].second)
+            builders[i] = &Lexer::buildTwoLetterOp;
+    }
+
+    builders[tableIndex('"')] = &Lexer::buildStrConst;
+    builders[tableIndex('#')] = &Lexer::buildComment;
+    builders[tableIndex('!')] = &Lexer::buildNotEqualOp;
+    builders[tableIndex(EOF)] = &Lexer::buildEndOfText;
+    return builders;
+}
+
+constexpr Lexer::TokenBuilders Lexer::tokenBuilders_{makeTokenBuilders()};
 
 Lexer::EscapedChars Lexer::escapedChars_{
     {'n', '\n'}, {'t', '\t'}, {'"', '"'}, {'\\', '\\'}};
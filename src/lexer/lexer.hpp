@@ -1,56 +1,104 @@
 #ifndef LEXER_H
 #define LEXER_H
 
-#include <functional>
-#include <optional>
+#include <array>
+#include <exception>
+#include <string_view>
 
 #include "ILexer.hpp"
+#include "compact_token.hpp"
 #include "source.hpp"
 #include "token.hpp"
+#include "token_table.hpp"
 
 /// @brief Lexer that lazily converts characters read from source into tokens
 class Lexer : public ILexer {
     using CharPair = std::pair<char, char>;
-    using TokenTypes = std::pair<Token::Type, Token::Type>;
 
-    using TokenBuilders =
-        std::initializer_list<std::function<std::optional<Token>(Lexer&)>>;
+    /// @brief Builds a token starting with the current character
+    using TokenBuilder = CompactToken (Lexer::*)();
+    /// @brief Token builders indexed by the first character of a token
+    using TokenBuilders = std::array<TokenBuilder, 256>;
     using EscapedChars = std::initializer_list<CharPair>;
 
-    using IntWithDigitCount = std::pair<Integral, unsigned int>;
-
    public:
+    /// @brief Whether comments are returned as CMT tokens or skipped like whitespace
+    enum class Comments { KEEP, SKIP };
+
     /// @brief Constructs a Lexer that reads characters from the source
     /// @param source
-    explicit Lexer(Source& source)
-        : source_(source) {}
+    /// @param comments SKIP when no consumer needs CMT tokens. Comments are then skipped
+    /// without being copied
+    explicit Lexer(Source& source, Comments comments = Comments::KEEP)
+        : source_(source), comments_(comments), table_(source.getBuffer()) {}
 
     /// @brief Returns next token lazily constructed from characters read from source
     /// @return Next token
-    Token getToken() override;
+    Token getToken() override { return table_.getToken(getCompactToken()); }
+
+    /// @brief Returns next token in the compact form, resolved by getTokenTable()
+    CompactToken getCompactToken();
+
+    /// @brief Fills the buffer with tokens lexed in a tight loop
+    ///
+    /// If lexing fails after some tokens were already written, these tokens are returned
+    /// and the error is thrown by the next call. The errors are therefore reported in the
+    /// same order as when the tokens are requested one by one
+    /// @param tokens
+    /// @return Number of tokens written
+    std::size_t getTokens(std::span<Token> tokens) override;
+    std::size_t getCompactTokens(std::span<CompactToken> tokens) override;
+
+    const TokenTable& getTokenTable() const override { return table_; }
+
+    /// @brief Returns byte offset of the first character of the most recently lexed (or
+    /// failed) token
+    std::size_t getTokenOffset() const { return tokenOffset_; }
 
    private:
     Source& source_;
-    Position tokenPosition_;
+    Comments comments_;
+    TokenTable table_;
+    std::size_t tokenOffset_{0};
+    std::exception_ptr pendingError_;
+
+    template <typename T, typename Lex>
+    std::size_t fillTokens(std::span<T> tokens, Lex lex);
 
+    /// @brief Skips whitespace and, in the SKIP mode, comments
     void ignoreWhiteSpace() const;
 
-    std::optional<Token> buildIdOrKeyword() const;
-    std::optional<Token> buildKeyword(std::string_view lexeme) const;
-    std::optional<Token> buildBoolConst(std::string_view lexeme) const;
-    std::optional<Token> buildIntConst() const;
-    std::optional<Token> buildFloatConst(Integral integralPart) const;
-    std::optional<Token> buildStrConst() const;
-    std::optional<Token> buildComment() const;
-    std::optional<Token> buildNotEqualOp() const;
-    std::optional<Token> buildOneLetterOp(char c, Token::Type type) const;
-    std::optional<Token> buildTwoLetterOp(CharPair chars, TokenTypes types) const;
-
-    std::optional<IntWithDigitCount> buildNumber() const;
+    /// @brief Returns position of the first character of the current token. Computed
+    /// only when needed, e.g. for errors
+    Position getTokenPosition() const;
+    CompactToken makeToken(Token::Type type, std::uint32_t payload = 0) const;
+
+    CompactToken buildIdOrKeyword();
+    CompactToken buildKeyword(Token::Type type);
+    /// @brief Builds an int or float literal, scanned once and converted by from_chars
+    CompactToken buildNumericConst();
+    CompactToken buildIntConst(std::string_view literal) const;
+    /// @brief Builds a float literal, rounding one too small even for a denormal to 0 and
+    /// throwing NumericOverflow for one too large
+    CompactToken buildFloatConst(std::string_view literal) const;
+    CompactToken buildStrConst();
+    CompactToken buildComment();
+    CompactToken buildNotEqualOp();
+    CompactToken buildOneLetterOp();
+    CompactToken buildTwoLetterOp();
+    CompactToken buildEndOfText();
+    CompactToken buildInvalidToken();
+
+    /// @brief Returns end of the exponent starting at the offset, or the offset if there
+    /// is no exponent
+    std::size_t scanExponent(std::string_view text, std::size_t offset) const;
+    [[noreturn]] void throwIntegralOverflow(std::string_view digits) const;
     void expectNoEndOfFile() const;
     char findInEscapedChars(char searched) const;
 
-    static TokenBuilders tokenBuilders_;
+    static constexpr TokenBuilders makeTokenBuilders();
+
+    static const TokenBuilders tokenBuilders_;
     static EscapedChars escapedChars_;
 };
 
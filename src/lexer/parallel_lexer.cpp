@@ -0,0 +1,183 @@
+#include "parallel_lexer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <utility>
+
+#include "char_scan.hpp"
+
+ParallelLexer::ParallelLexer(Source& source, Lexer::Comments comments,
+                             unsigned int threadCount, std::size_t minChunkSize)
+    : buffer_(source.getBuffer()), comments_(comments), table_(buffer_) {
+    const auto text = buffer_->getText();
+    const auto begin = std::min(source.getOffset(), text.size());
+    const auto maxChunkCount = std::max<std::size_t>(threadCount, 1);
+    const auto chunkCount = std::clamp<std::size_t>(
+        (text.size() - begin) / std::max<std::size_t>(minChunkSize, 1), 1, maxChunkCount);
+    const auto chunkSize = (text.size() - begin) / chunkCount;
+
+    std::vector<Chunk> chunks;
+    chunks.push_back(Chunk{.begin = source.getOffset()});
+    for (std::size_t i{1}; i < chunkCount; ++i) {
+        const auto boundary = findLineEnd(text, begin + i * chunkSize) + 1;
+        if (boundary >= text.size())
+            break;
+        if (boundary > chunks.back().begin) {
+            chunks.back().end = boundary;
+            chunks.push_back(Chunk{.begin = boundary});
+        }
+    }
+    chunks.back().end = std::numeric_limits<std::size_t>::max();
+
+    if (chunks.size() == 1) {
+        sequential_ = std::make_unique<Lexer>(source, comments);
+        return;
+    }
+
+    buffer_->indexAllLines();
+
+    {
+        std::vector<std::jthread> workers;
+        for (auto& chunk : chunks | std::views::drop(1))
+            workers.emplace_back([this, &chunk] { lexChunk(chunk); });
+        lexChunk(chunks.front());
+    }
+
+    // The first chunk starts where the sequential lexer would, so its tokens are exact.
+    // Every other chunk is validated against where the previous one stopped
+    appendChunk(chunks.front(), 0);
+    auto expected = chunks.front().stop;
+    for (auto& chunk : chunks | std::views::drop(1)) {
+        if (error_)
+            break;
+
+        const auto first = std::ranges::lower_bound(chunk.tokens, expected, {},
+                                                    &CompactToken::getOffset);
+        if (first != chunk.tokens.end() && first->getOffset() == expected)
+            appendChunk(chunk, first - chunk.tokens.begin());
+        else
+            relexChunk(chunk, expected);
+        expected = chunk.stop;
+    }
+}
+
+Token ParallelLexer::getToken() {
+    Token token;
+    getTokens({&token, 1});
+    return token;
+}
+
+std::size_t ParallelLexer::getTokens(std::span<Token> tokens) {
+    if (sequential_)
+        return sequential_->getTokens(tokens);
+
+    std::array<CompactToken, 16> buffer;
+    const auto count =
+        getCompactTokens(std::span(buffer).first(std::min(buffer.size(), tokens.size())));
+    for (std::size_t i{0}; i < count; ++i)
+        tokens[i] = table_.getToken(buffer[i]);
+    return count;
+}
+
+std::size_t ParallelLexer::getCompactTokens(std::span<CompactToken> tokens) {
+    if (sequential_)
+        return sequential_->getCompactTokens(tokens);
+
+    std::size_t count{0};
+
+    while (count < tokens.size() && next_ < tokens_.size()) {
+        tokens[count++] = tokens_[next_];
+        if (tokens_[next_].getType() == Token::Type::ETX)
+            break;
+        ++next_;
+    }
+
+    if (count == 0 && !tokens.empty() && error_)
+        std::rethrow_exception(error_);
+    return count;
+}
+
+const TokenTable& ParallelLexer::getTokenTable() const {
+    if (sequential_)
+        return sequential_->getTokenTable();
+    return table_;
+}
+
+void ParallelLexer::lexChunk(Chunk& chunk) const {
+    auto source = Source(buffer_, chunk.begin);
+    auto lexer = Lexer(source, comments_);
+    chunk.strings = TokenTable(buffer_);
+
+    try {
+        while (true) {
+            auto token = lexer.getCompactToken();
+            if (lexer.getTokenOffset() >= chunk.end) {
+                chunk.stop = lexer.getTokenOffset();
+                return;
+            }
+
+            if (token.hasString()) {
+                const auto index = chunk.strings.addString(lexer.getTokenTable(), token);
+                token = CompactToken(token.getType(), token.getOffset(), index);
+            }
+            chunk.tokens.push_back(token);
+            if (token.getType() == Token::Type::ETX)
+                return;
+        }
+    } catch (...) {
+        if (lexer.getTokenOffset() >= chunk.end)
+            chunk.stop = lexer.getTokenOffset();
+        else
+            chunk.error = std::current_exception();
+    }
+}
+
+void ParallelLexer::appendChunk(Chunk& chunk, std::size_t first) {
+    for (auto token : chunk.tokens | std::views::drop(first)) {
+        if (token.hasString())
+            token = CompactToken(token.getType(), token.getOffset(),
+                                 table_.addString(chunk.strings, token));
+        tokens_.push_back(token);
+    }
+    error_ = chunk.error;
+}
+
+void ParallelLexer::relexChunk(Chunk& chunk, std::size_t begin) {
+    auto source = Source(buffer_, begin);
+    auto lexer = Lexer(source, comments_);
+    auto speculative = chunk.tokens.begin();
+
+    try {
+        while (true) {
+            auto token = lexer.getCompactToken();
+            const auto offset = lexer.getTokenOffset();
+            if (offset >= chunk.end) {
+                chunk.stop = offset;
+                return;
+            }
+
+            // From a common token start on the speculative tokens are exact
+            speculative = std::ranges::lower_bound(
+                speculative, chunk.tokens.end(), offset, {}, &CompactToken::getOffset);
+            if (speculative != chunk.tokens.end() && speculative->getOffset() == offset) {
+                appendChunk(chunk, speculative - chunk.tokens.begin());
+                return;
+            }
+
+            if (token.hasString())
+                token = CompactToken(token.getType(), token.getOffset(),
+                                     table_.addString(lexer.getTokenTable(), token));
+            tokens_.push_back(token);
+            if (token.getType() == Token::Type::ETX)
+                return;
+        }
+    } catch (...) {
+        if (lexer.getTokenOffset() >= chunk.end)
+            chunk.stop = lexer.getTokenOffset();
+        else
+            error_ = std::current_exception();
+    }
+}
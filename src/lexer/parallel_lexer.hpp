@@ -0,0 +1,71 @@
+#ifndef PARALLEL_LEXER_H
+#define PARALLEL_LEXER_H
+
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ILexer.hpp"
+#include "compact_token.hpp"
+#include "lexer.hpp"
+#include "source.hpp"
+#include "token_table.hpp"
+
+/// @brief Lexer that splits the source into chunks at line boundaries and lexes them
+/// concurrently
+///
+/// A chunk may start inside a multi-line string literal. Such a chunk is lexed
+/// speculatively and its tokens are used from the first token that also starts a token
+/// of the previous chunk's stream; the part before it is lexed again. The returned
+/// tokens, their positions and the reported errors are the same as those of the
+/// sequential Lexer.
+class ParallelLexer : public ILexer {
+   public:
+    static constexpr std::size_t defaultMinChunkSize{1 << 20};
+
+    /// @brief Lexes the whole source from its current offset. Lexing errors are thrown
+    /// when the token that failed is requested
+    /// @param source
+    /// @param comments
+    /// @param threadCount maximal number of chunks lexed concurrently
+    /// @param minChunkSize sources shorter than two chunks are lexed sequentially and
+    /// lazily, just like by the Lexer
+    explicit ParallelLexer(
+        Source& source, Lexer::Comments comments = Lexer::Comments::KEEP,
+        unsigned int threadCount = std::thread::hardware_concurrency(),
+        std::size_t minChunkSize = defaultMinChunkSize);
+
+    Token getToken() override;
+    std::size_t getTokens(std::span<Token> tokens) override;
+    std::size_t getCompactTokens(std::span<CompactToken> tokens) override;
+    const TokenTable& getTokenTable() const override;
+
+   private:
+    /// @brief Tokens starting in [begin, end)
+    struct Chunk {
+        std::size_t begin{0};
+        std::size_t end{0};
+        std::vector<CompactToken> tokens{};
+        /// Strings of the tokens, indexed by their payloads
+        TokenTable strings{};
+        /// Offset of the first token starting at or after the end
+        std::size_t stop{0};
+        std::exception_ptr error{};
+    };
+
+    void lexChunk(Chunk& chunk) const;
+    void appendChunk(Chunk& chunk, std::size_t first);
+    void relexChunk(Chunk& chunk, std::size_t begin);
+
+    std::shared_ptr<const SourceBuffer> buffer_;
+    Lexer::Comments comments_;
+    std::unique_ptr<Lexer> sequential_;
+
+    TokenTable table_;
+    std::vector<CompactToken> tokens_;
+    std::size_t next_{0};
+    std::exception_ptr error_;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "source.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+SourceBuffer::SourceBuffer(std::string text)
+    : owned_(std::move(text)), data_(owned_.data()), size_(owned_.size()) {}
+
+SourceBuffer::SourceBuffer(const char* data, std::size_t size)
+    : data_(data), size_(size), mapped_(true) {}
+
+SourceBuffer::~SourceBuffer() {
+    if (mapped_)
+        ::munmap(const_cast<char*>(data_), size_);
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat fileStat {};
+        const bool mappable = ::fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode)
+                              && fileStat.st_size > 0;
+        void* address = MAP_FAILED;
+        const auto size = static_cast<std::size_t>(fileStat.st_size);
+        if (mappable)
+            address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (address != MAP_FAILED) {
+            ::madvise(address, size, MADV_SEQUENTIAL);
+            return std::shared_ptr<const SourceBuffer>(
+                new SourceBuffer(static_cast<const char*>(address), size));
+        }
+    }
+
+    std::ifstream stream(path, std::ios::binary);
+    return fromStream(stream);
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromStream(std::istream& stream) {
+    std::ostringstream text;
+    if (stream.peek() != EOF)
+        text << stream.rdbuf();
+    return std::make_shared<const SourceBuffer>(std::move(text).str());
+}
+
+Position SourceBuffer::getPosition(std::size_t offset) const {
+    indexLinesUpTo(offset);
+
+    auto lineStart = lineStarts_.end() - 1;
+    if (offset < *lineStart)
+        lineStart = std::upper_bound(lineStarts_.begin(), lineStarts_.end(), offset) - 1;
+
+    const auto line = std::distance(lineStarts_.begin(), lineStart) + 1;
+    const auto column = offset - *lineStart + 1;
+    return {static_cast<unsigned int>(line), static_cast<unsigned int>(column)};
+}
+
+void SourceBuffer::indexLinesUpTo(std::size_t offset) const {
+    const auto end = std::min(offset, size_);
+
+    while (indexedUpTo_ < end) {
+        const auto newLine = static_cast<const char*>(
+            std::memchr(data_ + indexedUpTo_, '\n', end - indexedUpTo_));
+        if (!newLine) {
+            indexedUpTo_ = end;
+            break;
+        }
+        indexedUpTo_ = newLine - data_ + 1;
+        lineStarts_.push_back(indexedUpTo_);
+    }
+}
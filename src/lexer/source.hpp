@@ -1,45 +1,124 @@
 #ifndef SOURCE_H
 #define SOURCE_H
 
+#include <algorithm>
+#include <cstdio>
 #include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "position.hpp"
 
+/// @brief Immutable text of the whole program
+///
+/// The text is memory-mapped from a file when possible and read into an owned buffer
+/// otherwise (e.g. for pipes and streams). Line starts are indexed lazily, only as far
+/// as positions are requested.
+class SourceBuffer {
+   public:
+    /// @brief Constructs a buffer owning the given text
+    /// @param text
+    explicit SourceBuffer(std::string text);
+
+    /// @brief Maps the file into memory. Falls back to reading the file into an owned
+    /// buffer if the file cannot be mapped
+    /// @param path
+    static std::shared_ptr<const SourceBuffer> fromFile(const std::string& path);
+
+    /// @brief Reads the whole stream into an owned buffer
+    /// @param stream
+    static std::shared_ptr<const SourceBuffer> fromStream(std::istream& stream);
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+    ~SourceBuffer();
+
+    std::string_view getText() const { return {data_, size_}; }
+
+    /// @brief Returns position of the character at the given byte offset. Offsets past
+    /// the end of text are placed on the last line
+    /// @param offset
+    Position getPosition(std::size_t offset) const;
+
+    /// @brief Indexes all line starts up front. Afterwards getPosition only reads the
+    /// index and can be called from multiple threads
+    void indexAllLines() const { indexLinesUpTo(size_); }
+
+   private:
+    SourceBuffer(const char* data, std::size_t size);
+
+    void indexLinesUpTo(std::size_t offset) const;
+
+    std::string owned_;
+    const char* data_{nullptr};
+    std::size_t size_{0};
+    bool mapped_{false};
+
+    mutable std::vector<std::size_t> lineStarts_{0};
+    mutable std::size_t indexedUpTo_{0};
+};
+
 /// @brief Source of characters that keeps track of current character and its position
 class Source {
    public:
     /// @brief Constructs a new Source
     ///
-    /// Immediately reads the first character by calling nextChar()
+    /// Reads the whole stream into memory
     /// @param stream from which characters will be read
     explicit Source(std::istream& stream)
-        : stream_(stream) {
-        currentChar_ = stream_.get();
+        : Source(SourceBuffer::fromStream(stream)) {}
+
+    /// @brief Constructs a new Source reading the buffer from the given offset
+    /// @param buffer
+    /// @param offset
+    explicit Source(std::shared_ptr<const SourceBuffer> buffer, std::size_t offset = 0)
+        : buffer_(std::move(buffer)),
+          data_(buffer_->getText().data()),
+          size_(buffer_->getText().size()),
+          offset_(offset) {}
+
+    /// @brief Constructs a new Source reading the file with the given path
+    /// @param path
+    static Source fromFile(const std::string& path) {
+        return Source(SourceBuffer::fromFile(path));
     }
 
     /// @brief Returns current character
-    /// @return Current character
-    char getChar() const { return currentChar_; }
+    /// @return Current character or EOF when the whole text was read
+    char getChar() const { return offset_ < size_ ? data_[offset_] : EOF; }
 
     /// @brief Returns position of current character
     /// @return Position of current character
-    const Position& getPosition() const { return currentPosition_; }
+    Position getPosition() const { return buffer_->getPosition(offset_); }
+
+    /// @brief Returns byte offset of current character
+    std::size_t getOffset() const { return offset_; }
 
-    /// @brief Reads next character and calculates its position
-    void nextChar() {
-        if (currentChar_ == '\n') {
-            currentPosition_.line += 1;
-            currentPosition_.column = 0;
-        }
+    /// @brief Returns the whole text
+    std::string_view getText() const { return {data_, size_}; }
 
-        currentChar_ = stream_.get();
-        currentPosition_.column += 1;
+    /// @brief Returns text from the given offset up to (excluding) current character
+    /// @param begin
+    std::string_view getTextFrom(std::size_t begin) const {
+        return {data_ + begin, std::min(offset_, size_) - begin};
     }
 
+    /// @brief Advances to the next character
+    void nextChar() { ++offset_; }
+
+    /// @brief Moves to the character at the given offset
+    /// @param offset
+    void seek(std::size_t offset) { offset_ = offset; }
+
+    const std::shared_ptr<const SourceBuffer>& getBuffer() const { return buffer_; }
+
    private:
-    std::istream& stream_;
-    char currentChar_{};
-    Position currentPosition_{1, 1};
+    std::shared_ptr<const SourceBuffer> buffer_;
+    const char* data_;
+    std::size_t size_;
+    std::size_t offset_;
 };
 
 #endif
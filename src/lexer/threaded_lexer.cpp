@@ -0,0 +1,74 @@
+#include "threaded_lexer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+ThreadedLexer::ThreadedLexer(ILexer& lexer, std::size_t capacity)
+    : lexer_(lexer), ring_(std::max(capacity, batchSize_)) {
+    const auto& buffer = lexer.getTokenTable().getBuffer();
+    if (!buffer)
+        throw std::invalid_argument("ThreadedLexer needs a lexer reading from a source");
+    table_ = TokenTable(buffer);
+    // Both threads resolve positions, e.g. for errors, and indexing lines is lazy
+    buffer->indexAllLines();
+
+    producer_ = std::jthread([this] { produce(); });
+}
+
+void ThreadedLexer::produce() {
+    std::array<CompactToken, batchSize_> tokens;
+    std::array<Slot, batchSize_> slots;
+    const auto& strings = lexer_.getTokenTable();
+
+    try {
+        while (true) {
+            const auto count = lexer_.getCompactTokens(tokens);
+            for (std::size_t i{0}; i < count; ++i) {
+                slots[i] = {tokens[i], {}};
+                if (tokens[i].hasString())
+                    slots[i].text = strings.getString(tokens[i]);
+            }
+            if (!ring_.push(std::span(slots).first(count)))
+                return;
+            if (count > 0 && tokens[count - 1].getType() == Token::Type::ETX)
+                break;
+        }
+    } catch (...) {
+        error_ = std::current_exception();
+    }
+    ring_.close();
+}
+
+Token ThreadedLexer::getToken() {
+    CompactToken token;
+    getCompactTokens({&token, 1});
+    return table_.getToken(token);
+}
+
+std::size_t ThreadedLexer::getCompactTokens(std::span<CompactToken> tokens) {
+    std::size_t count{0};
+    while (count < tokens.size() && end_.getType() != Token::Type::ETX) {
+        const auto wanted = std::min(slots_.size(), tokens.size() - count);
+        const auto popped = ring_.pop(std::span(slots_).first(wanted));
+        if (popped == 0)
+            break;
+
+        for (const auto& [token, text] : std::span(slots_).first(popped)) {
+            if (token.hasString())
+                tokens[count++] = CompactToken(token.getType(), token.getOffset(),
+                                               table_.addExternalString(text));
+            else
+                tokens[count++] = token;
+        }
+        end_ = tokens[count - 1];
+    }
+
+    if (count > 0 || tokens.empty())
+        return count;
+    // The end-of-text token is repeated, just like by the Lexer
+    if (end_.getType() == Token::Type::ETX) {
+        tokens[0] = end_;
+        return 1;
+    }
+    std::rethrow_exception(error_);
+}
@@ -0,0 +1,65 @@
+#ifndef THREADED_LEXER_H
+#define THREADED_LEXER_H
+
+#include <array>
+#include <exception>
+#include <string_view>
+#include <thread>
+
+#include "ILexer.hpp"
+#include "compact_token.hpp"
+#include "spsc_ring.hpp"
+#include "token_conversion.hpp"
+#include "token_table.hpp"
+
+/// @brief Decorator running the decorated lexer on a producer thread, so that lexing
+/// overlaps with the work of the consumer, e.g. parsing
+///
+/// Tokens are passed through a lock-free single-producer single-consumer ring. They,
+/// their positions and the errors are the same as those of the decorated lexer, errors
+/// are thrown after all the tokens preceding them were returned. The decorated lexer
+/// must read from a source, must not be used by anyone else and must outlive the
+/// decorator.
+class ThreadedLexer : public ILexer {
+   public:
+    static constexpr std::size_t defaultCapacity{8192};
+
+    /// @brief Starts lexing on a new thread
+    /// @param lexer e.g. a Lexer or a Filter decorating it
+    /// @param capacity maximal number of tokens lexed ahead of the consumer
+    explicit ThreadedLexer(ILexer& lexer, std::size_t capacity = defaultCapacity);
+
+    /// @brief Stops the producer thread, even if it has not finished
+    ~ThreadedLexer() override { ring_.close(); }
+
+    Token getToken() override;
+    std::size_t getTokens(std::span<Token> tokens) override {
+        return getTokensOneByOne(*this, tokens);
+    }
+    std::size_t getCompactTokens(std::span<CompactToken> tokens) override;
+    const TokenTable& getTokenTable() const override { return table_; }
+
+   private:
+    static constexpr std::size_t batchSize_{256};
+
+    /// @brief Token along with its string, resolved by the producer, since the table of
+    /// the decorated lexer grows while the consumer reads
+    struct Slot {
+        CompactToken token{};
+        std::string_view text{};
+    };
+
+    void produce();
+
+    ILexer& lexer_;
+    TokenTable table_;
+    SpscRing<Slot> ring_;
+    /// Set by the producer before it closes the ring
+    std::exception_ptr error_;
+    std::array<Slot, batchSize_> slots_;
+    CompactToken end_{};
+    /// Declared last, so that it is joined before the other members are destroyed
+    std::jthread producer_;
+};
+
+#endif
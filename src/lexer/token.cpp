@@ -2,8 +2,8 @@
 
 #include "magic_enum/magic_enum.hpp"
 
-bool Token::isConstant() const {
-    return std::find(constantTypes_.begin(), constantTypes_.end(), type_)
+bool Token::isConstant(Type type) {
+    return std::find(constantTypes_.begin(), constantTypes_.end(), type)
            != constantTypes_.end();
 }
 
@@ -19,6 +19,7 @@ struct ToStringFunctor {
     std::string operator()(Floating i) const { return std::to_string(i); }
     std::string operator()(bool b) const { return std::to_string(b); }
     std::string operator()(const std::string& s) const { return s; }
+    std::string operator()(Symbol s) const { return std::string(s.getText()); }
 };
 
 std::ostream& operator<<(std::ostream& stream, const Token& token) {
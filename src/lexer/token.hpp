@@ -1,11 +1,13 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include <cstdint>
 #include <ostream>
 #include <variant>
 #include <vector>
 
 #include "position.hpp"
+#include "symbol.hpp"
 #include "types.hpp"
 
 struct Position;
@@ -13,7 +15,7 @@ struct Position;
 /// @brief Token returned by lexer and used by parser
 class Token {
    public:
-    enum class Type {
+    enum class Type : std::uint8_t {
         UNKNOWN,
         IF_KW,
         WHILE_KW,
@@ -61,7 +63,8 @@ class Token {
         CMT,
     };
 
-    using Value = std::variant<std::monostate, Integral, Floating, bool, std::string>;
+    using Value =
+        std::variant<std::monostate, Integral, Floating, bool, std::string, Symbol>;
 
     /// @param type
     /// @param value
@@ -81,7 +84,8 @@ class Token {
     const Position& getPosition() const { return position_; }
 
     /// @brief Is one of the constants (e.g. int, bool, str)
-    bool isConstant() const;
+    bool isConstant() const { return isConstant(type_); }
+    static bool isConstant(Type type);
 
    private:
     Type type_;
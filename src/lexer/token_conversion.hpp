@@ -0,0 +1,56 @@
+#ifndef TOKEN_CONVERSION_H
+#define TOKEN_CONVERSION_H
+
+#include <algorithm>
+#include <array>
+#include <span>
+
+#include "ILexer.hpp"
+#include "compact_token.hpp"
+#include "token.hpp"
+#include "token_table.hpp"
+
+/// @brief Fills the buffer by calling getToken() for every token. Implements
+/// ILexer::getTokens() for lexers that can not amortize the per-token cost
+/// @param lexer
+/// @param tokens
+/// @return Number of tokens written, see ILexer::getTokens()
+inline std::size_t getTokensOneByOne(ILexer& lexer, std::span<Token> tokens) {
+    std::size_t count{0};
+    while (count < tokens.size()) {
+        tokens[count] = lexer.getToken();
+        if (tokens[count++].getType() == Token::Type::ETX)
+            break;
+    }
+    return count;
+}
+
+/// @brief Implements ILexer::getCompactTokens() and ILexer::getTokenTable() for lexers
+/// producing only whole tokens, e.g. ones not reading from a source
+///
+/// Converts tokens returned by getTokens() of the lexer, keeping all their positions and
+/// strings in its own table. The lexer owns the converter, one per lexer
+class CompactTokenConverter {
+   public:
+    /// @brief Fills the buffer with the converted subsequent tokens of the lexer.
+    /// Behaves like ILexer::getCompactTokens()
+    /// @param lexer
+    /// @param tokens
+    /// @return Number of tokens written
+    std::size_t getCompactTokens(ILexer& lexer, std::span<CompactToken> tokens) {
+        std::array<Token, 16> buffer;
+        const auto count = lexer.getTokens(
+            std::span(buffer).first(std::min(buffer.size(), tokens.size())));
+        for (std::size_t i{0}; i < count; ++i)
+            tokens[i] = table_.add(buffer[i]);
+        return count;
+    }
+
+    /// @brief Returns the table resolving the converted tokens
+    const TokenTable& getTokenTable() const { return table_; }
+
+   private:
+    TokenTable table_;
+};
+
+#endif
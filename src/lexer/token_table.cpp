@@ -0,0 +1,79 @@
+#include "token_table.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+TokenTable::TokenTable(std::shared_ptr<const SourceBuffer> buffer)
+    : buffer_(std::move(buffer)) {
+    // One past the end is the offset of the end-of-text token
+    if (buffer_->getText().size() >= std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("Source longer than 4 GiB");
+}
+
+std::uint32_t TokenTable::addString(std::string text) {
+    strings_.push_back(decoded_.emplace_back(std::move(text)));
+    return static_cast<std::uint32_t>(strings_.size() - 1);
+}
+
+std::uint32_t TokenTable::addSourceString(std::string_view text) {
+    strings_.push_back(text);
+    return static_cast<std::uint32_t>(strings_.size() - 1);
+}
+
+std::uint32_t TokenTable::addExternalString(std::string_view text) {
+    if (isInSource(text))
+        return addSourceString(text);
+    return addString(std::string(text));
+}
+
+bool TokenTable::isInSource(std::string_view text) const {
+    if (!buffer_)
+        return false;
+    const auto source = buffer_->getText();
+    // Compared as integers, the pointers may belong to unrelated objects
+    const auto begin = reinterpret_cast<std::uintptr_t>(source.data());
+    const auto address = reinterpret_cast<std::uintptr_t>(text.data());
+    return address >= begin && address + text.size() <= begin + source.size();
+}
+
+struct ValueToPayload {
+    std::uint32_t operator()(std::monostate) const { return 0; }
+    std::uint32_t operator()(const std::string&) const { return 0; }
+    std::uint32_t operator()(auto value) const { return CompactToken::pack(value); }
+};
+
+CompactToken TokenTable::add(const Token& token) {
+    const auto offset = static_cast<std::uint32_t>(positions_.size());
+    positions_.push_back(token.getPosition());
+
+    auto payload = std::visit(ValueToPayload(), token.getValue());
+    if (const auto text = std::get_if<std::string>(&token.getValue()))
+        payload = addString(*text);
+    return CompactToken(token.getType(), offset, payload);
+}
+
+Position TokenTable::getPosition(CompactToken token) const {
+    if (buffer_)
+        return buffer_->getPosition(token.getOffset());
+    return positions_[token.getOffset()];
+}
+
+Token::Value TokenTable::getValue(CompactToken token) const {
+    switch (token.getType()) {
+        case Token::Type::ID:
+            return token.getSymbol();
+        case Token::Type::INT_CONST:
+            return token.getIntegral();
+        case Token::Type::FLOAT_CONST:
+            return token.getFloating();
+        case Token::Type::TRUE_CONST:
+        case Token::Type::FALSE_CONST:
+            return token.getBool();
+        case Token::Type::STR_CONST:
+        case Token::Type::CMT:
+            return std::string(getString(token));
+        default:
+            return {};
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef TOKEN_TABLE_H
+#define TOKEN_TABLE_H
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "compact_token.hpp"
+#include "source.hpp"
+#include "token.hpp"
+
+/// @brief Side table resolving positions and strings of compact tokens
+///
+/// Tokens lexed from a source hold byte offsets resolved through the source buffer.
+/// Tokens added as whole Tokens (e.g. by lexers not reading from a source) hold indices
+/// of positions stored in the table instead. Strings that appear verbatim in the source
+/// are not copied.
+class TokenTable {
+   public:
+    /// @brief Constructs a table of tokens that were not lexed from a source
+    TokenTable() = default;
+
+    /// @brief Constructs a table of tokens lexed from the buffer
+    /// @param buffer
+    explicit TokenTable(std::shared_ptr<const SourceBuffer> buffer);
+
+    // Copies would view the decoded strings of the original
+    TokenTable(const TokenTable&) = delete;
+    TokenTable& operator=(const TokenTable&) = delete;
+    TokenTable(TokenTable&&) = default;
+    TokenTable& operator=(TokenTable&&) = default;
+
+    /// @brief Stores the string and returns its index for the token payload
+    /// @param text
+    std::uint32_t addString(std::string text);
+
+    /// @brief Stores a view of text lying in the source buffer without copying it
+    /// @param text
+    std::uint32_t addSourceString(std::string_view text);
+
+    /// @brief Stores the string of a token from another table of the same source. Text
+    /// viewing the source stays a view, decoded text is copied
+    /// @param other
+    /// @param token
+    std::uint32_t addString(const TokenTable& other, CompactToken token) {
+        return addExternalString(other.getString(token));
+    }
+
+    /// @brief Stores a string owned by someone else, e.g. another table of the same
+    /// source. Text viewing the source stays a view, other text is copied
+    /// @param text
+    std::uint32_t addExternalString(std::string_view text);
+
+    /// @brief Converts the token to the compact form, storing its string and position
+    /// @param token
+    CompactToken add(const Token& token);
+
+    std::string_view getString(CompactToken token) const {
+        return strings_[token.getPayload()];
+    }
+    Position getPosition(CompactToken token) const;
+
+    /// @brief Returns the buffer the offsets of the tokens refer to, null if the tokens
+    /// were not lexed from a source
+    const std::shared_ptr<const SourceBuffer>& getBuffer() const { return buffer_; }
+    Token::Value getValue(CompactToken token) const;
+
+    /// @brief Returns the token as a Token with resolved value and position
+    /// @param token
+    Token getToken(CompactToken token) const {
+        return Token(token.getType(), getValue(token), getPosition(token));
+    }
+
+   private:
+    bool isInSource(std::string_view text) const;
+
+    std::shared_ptr<const SourceBuffer> buffer_;
+    /// Strings of the tokens, indexed by their payloads
+    std::vector<std::string_view> strings_;
+    /// Strings that do not appear verbatim in the source, e.g. with decoded escapes
+    std::deque<std::string> decoded_;
+    std::vector<Position> positions_;
+};
+
+#endif
@@ -1,27 +1,93 @@
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string_view>
 
+#include "ast_cache.hpp"
 #include "base_errors.hpp"
-#include "filter.hpp"
 #include "interpreter.hpp"
 #include "lexer.hpp"
+#include "parallel_lexer.hpp"
 #include "parser.hpp"
+#include "threaded_lexer.hpp"
+
+struct ParseOptions {
+    bool parallelLexing{false};
+    bool threadedLexing{false};
+    Parser::FunctionBodies functionBodies{Parser::FunctionBodies::EAGER};
+};
+
+/// @brief Parses the program. If the interpreter is given, each top level statement is
+/// executed as soon as it is parsed and only the definitions are returned
+Program parse(const std::shared_ptr<const SourceBuffer>& buffer,
+              const ParseOptions& options, Interpreter* interpreter) {
+    auto source = Source(buffer);
+    std::unique_ptr<ILexer> lexer;
+    if (options.parallelLexing)
+        lexer = std::make_unique<ParallelLexer>(source, Lexer::Comments::SKIP);
+    else
+        lexer = std::make_unique<Lexer>(source, Lexer::Comments::SKIP);
+    std::unique_ptr<ILexer> threadedLexer;
+    if (options.threadedLexing)
+        threadedLexer = std::make_unique<ThreadedLexer>(*lexer);
+
+    auto parser = Parser(threadedLexer ? *threadedLexer : *lexer, options.functionBodies);
+    if (!interpreter)
+        return parser.parseProgram();
+    return parser.parseProgram(
+        [interpreter](const Statement& statement) { interpreter->interpret(statement); });
+}
 
 int main(int argc, char* argv[]) {
     if (argc < 2)
         return -1;
 
-    std::ifstream ifs(argv[1]);
-    auto source = Source(ifs);
+    ParseOptions options;
+    bool streaming{false};
+    bool useCache{true};
+    auto typeChecks = Interpreter::TypeChecks::RUNTIME;
+    auto cacheDirectory = AstCache::getDefaultDirectory();
+    for (int i{2}; i < argc; ++i) {
+        const std::string_view option(argv[i]);
+        if (option == "--parallel-lex")
+            options.parallelLexing = true;
+        else if (option == "--threaded-lex")
+            options.threadedLexing = true;
+        else if (option == "--stream")
+            streaming = true;
+        else if (option == "--lazy-functions")
+            options.functionBodies = Parser::FunctionBodies::LAZY;
+        else if (option == "--check-types")
+            typeChecks = Interpreter::TypeChecks::STATIC;
+        else if (option == "--no-cache")
+            useCache = false;
+        else if (option == "--cache-dir" && i + 1 < argc)
+            cacheDirectory = argv[++i];
+    }
 
-    try {
-        auto lexer = Lexer(source);
-        auto filter = Filter(lexer, Token::Type::CMT);
-        auto parser = Parser(filter);
-        const auto program = parser.parseProgram();
+    // A file that can not be opened is interpreted as an empty program, but not cached
+    std::optional<AstCache> cache;
+    if (useCache && std::ifstream(argv[1]))
+        cache.emplace(cacheDirectory);
 
-        Interpreter interpreter(std::cout);
-        interpreter.interpret(program);
+    const auto buffer = SourceBuffer::fromFile(argv[1]);
+
+    try {
+        Interpreter interpreter(std::cout, typeChecks);
+        auto program = cache ? cache->load(buffer->getText()) : std::nullopt;
+        if (program) {
+            interpreter.interpret(*program);
+        } else if (streaming) {
+            // Only the definitions are kept, so there is nothing to cache
+            parse(buffer, options, &interpreter);
+        } else {
+            program = parse(buffer, options, nullptr);
+            // Storing would parse all deferred bodies
+            if (cache && options.functionBodies == Parser::FunctionBodies::EAGER)
+                cache->store(buffer->getText(), *program);
+            interpreter.interpret(*program);
+        }
     } catch (const BaseException& e) {
         std::cerr << '\n' << e.describe() << '\n';
     }
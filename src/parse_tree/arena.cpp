@@ -0,0 +1,30 @@
+#include "arena.hpp"
+
+#include <algorithm>
+
+void* Arena::allocate(std::size_t size, std::size_t alignment) {
+    if (!std::align(alignment, size, next_, available_)) {
+        // Objects larger than a block get a block of their own
+        addBlock(std::max(blockSize_, size + alignment));
+        std::align(alignment, size, next_, available_);
+    }
+
+    const auto memory = next_;
+    next_ = static_cast<std::byte*>(next_) + size;
+    available_ -= size;
+    allocatedBytes_ += size;
+    return memory;
+}
+
+void Arena::addBlock(std::size_t size) {
+    blocks_.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+    next_ = blocks_.back().get();
+    available_ = size;
+}
+
+void Arena::rewind(const Mark& mark) {
+    blocks_.resize(mark.blockCount);
+    next_ = mark.next;
+    available_ = mark.available;
+    allocatedBytes_ = mark.allocatedBytes;
+}
@@ -0,0 +1,80 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/// @brief Deleter of nodes allocated in an Arena
+///
+/// Only runs the destructor, the memory is released together with the whole arena.
+struct NodeDeleter {
+    template <typename T>
+    void operator()(T* node) const {
+        std::destroy_at(node);
+    }
+};
+
+/// @brief Owning pointer to a node allocated in an Arena. The arena must outlive it
+template <typename T>
+using NodePtr = std::unique_ptr<T, NodeDeleter>;
+
+/// @brief Bump allocator of parse tree nodes
+///
+/// Nodes are placed one after another in large blocks, so nodes built together lie
+/// close to each other and freeing the whole tree releases just a few blocks.
+class Arena {
+   public:
+    static constexpr std::size_t defaultBlockSize{64 * 1024};
+
+    explicit Arena(std::size_t blockSize = defaultBlockSize)
+        : blockSize_(blockSize) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /// @brief Returns uninitialized memory valid until the arena is destroyed
+    /// @param size
+    /// @param alignment
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    /// @brief Constructs a node in the arena
+    template <typename T, typename... Args>
+    NodePtr<T> make(Args&&... args) {
+        const auto memory = allocate(sizeof(T), alignof(T));
+        return NodePtr<T>(::new (memory) T(std::forward<Args>(args)...));
+    }
+
+    /// @brief State of the arena to which it can be rewound
+    struct Mark {
+        std::size_t blockCount{0};
+        void* next{nullptr};
+        std::size_t available{0};
+        std::size_t allocatedBytes{0};
+    };
+
+    Mark getMark() const { return {blocks_.size(), next_, available_, allocatedBytes_}; }
+
+    /// @brief Releases the memory allocated since the mark was taken, so that it is
+    /// reused by the next allocations. Nodes placed there must be destroyed before
+    /// @param mark
+    void rewind(const Mark& mark);
+
+    /// @brief Returns number of bytes handed out by allocate()
+    std::size_t getAllocatedBytes() const { return allocatedBytes_; }
+
+    std::size_t getBlockCount() const { return blocks_.size(); }
+
+   private:
+    void addBlock(std::size_t size);
+
+    std::size_t blockSize_;
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    void* next_{nullptr};
+    std::size_t available_{0};
+    std::size_t allocatedBytes_{0};
+};
+
+#endif
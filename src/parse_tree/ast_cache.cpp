@@ -0,0 +1,94 @@
+#include "ast_cache.hpp"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#include "hash.hpp"
+#include "source.hpp"
+
+std::filesystem::path AstCache::getDefaultDirectory() {
+    static constexpr auto name = "raptor_lang";
+    if (const auto cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome && *cacheHome)
+        return std::filesystem::path(cacheHome) / name;
+    if (const auto home = std::getenv("HOME"); home && *home)
+        return std::filesystem::path(home) / ".cache" / name;
+
+    std::error_code error;
+    return std::filesystem::temp_directory_path(error) / name;
+}
+
+namespace {
+/// @brief Length of the source as stored before it at the start of an entry
+using SourceLength = std::uint64_t;
+}  // namespace
+
+std::filesystem::path AstCache::getPath(std::string_view source) const {
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << hashBytes(source)
+         << ".ast";
+    return directory_ / name.str();
+}
+
+std::optional<Program> AstCache::load(std::string_view source) const {
+    const auto path = getPath(source);
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error))
+        return std::nullopt;
+
+    // Mapped, so the nodes are copied straight from the page cache
+    const auto buffer = SourceBuffer::fromFile(path);
+    auto bytes = buffer->getText();
+
+    // The file name is only a weak hash, the source itself tells whether it is the entry
+    SourceLength length;
+    if (bytes.size() < sizeof(length))
+        return std::nullopt;
+    std::memcpy(&length, bytes.data(), sizeof(length));
+    bytes.remove_prefix(sizeof(length));
+    if (length != source.size() || !bytes.starts_with(source))
+        return std::nullopt;
+
+    const auto ast = FlatAst::deserialize(bytes.substr(source.size()));
+    if (!ast)
+        return std::nullopt;
+    return unflatten(*ast);
+}
+
+bool AstCache::store(std::string_view source, const Program& program) const {
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    if (error)
+        return false;
+
+    // Written aside and renamed, so that concurrent runs never read a partial file
+    const auto path = getPath(source);
+    auto temporaryPath = path;
+    temporaryPath += '.' + std::to_string(::getpid()) + ".tmp";
+
+    const SourceLength length{source.size()};
+    const auto bytes = flatten(program).serialize();
+    bool written{false};
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(source.data(), static_cast<std::streamsize>(source.size()));
+        written = static_cast<bool>(
+            file.write(bytes.data(), static_cast<std::streamsize>(bytes.size())));
+    }
+
+    if (written) {
+        std::filesystem::rename(temporaryPath, path, error);
+        if (!error)
+            return true;
+    }
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+}
@@ -0,0 +1,50 @@
+#ifndef AST_CACHE_H
+#define AST_CACHE_H
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include "flat_ast.hpp"
+#include "parse_tree.hpp"
+
+/// @brief Directory of serialized parse trees keyed by the hash of the source they were
+/// parsed from
+///
+/// A program whose source did not change since its last run is loaded from the cache
+/// instead of being lexed and parsed again. Failing to read or write the cache is not an
+/// error, the program is parsed then.
+///
+/// An entry starts with the source it was parsed from, preceded by its length. The hash
+/// only names the file, a tree is loaded only if the stored source equals the given one,
+/// so sources of colliding hashes just replace each other's entries.
+class AstCache {
+   public:
+    /// @param directory created when the first tree is stored
+    explicit AstCache(std::filesystem::path directory)
+        : directory_(std::move(directory)) {}
+
+    /// @brief Returns $XDG_CACHE_HOME/raptor_lang, falling back to ~/.cache/raptor_lang
+    /// and to the temporary directory
+    static std::filesystem::path getDefaultDirectory();
+
+    /// @brief Loads the tree of the given source if it is cached, i.e. the entry holds
+    /// the same source
+    /// @param source text of the program
+    std::optional<Program> load(std::string_view source) const;
+
+    /// @brief Stores the tree of the given source, replacing the cached one
+    /// @param source text of the program
+    /// @param program tree parsed from the source
+    /// @return Whether the tree was stored
+    bool store(std::string_view source, const Program& program) const;
+
+    /// @brief Returns path of the file holding the tree of the given source
+    /// @param source
+    std::filesystem::path getPath(std::string_view source) const;
+
+   private:
+    std::filesystem::path directory_;
+};
+
+#endif
@@ -1,75 +1,22 @@
 #include "expressions.hpp"
 
 template <typename T>
-auto getBinaryExprCtor() {
-    return [](auto lhs, auto rhs, const Position& position) {
-        return std::make_unique<T>(std::move(lhs), std::move(rhs), position);
-    };
+PExpression makeUnaryExpr(Arena& arena, PExpression expr, const Position& position) {
+    return arena.make<T>(std::move(expr), position);
 }
 
 template <typename T>
-auto getUnaryExprCtor() {
-    return [](auto expr, const Position& position) {
-        return std::make_unique<T>(std::move(expr), position);
-    };
-}
-
-std::optional<ComparisonExpression::Ctor> ComparisonExpression::getCtor(
-    Token::Type type) {
-    switch (type) {
-        case Token::Type::EQ_OP:
-            return getBinaryExprCtor<EqualExpression>();
-        case Token::Type::NEQ_OP:
-            return getBinaryExprCtor<NotEqualExpression>();
-        default:
-            return std::nullopt;
-    }
-}
-
-std::optional<RelationExpression::Ctor> RelationExpression::getCtor(Token::Type type) {
-    switch (type) {
-        case Token::Type::LT_OP:
-            return getBinaryExprCtor<LessThanExpression>();
-        case Token::Type::LTE_OP:
-            return getBinaryExprCtor<LessThanOrEqualExpression>();
-        case Token::Type::GT_OP:
-            return getBinaryExprCtor<GreaterThanExpression>();
-        case Token::Type::GTE_OP:
-            return getBinaryExprCtor<GreaterThanOrEqualExpression>();
-        default:
-            return std::nullopt;
-    }
-}
-
-std::optional<AdditiveExpression::Ctor> AdditiveExpression::getCtor(Token::Type type) {
-    switch (type) {
-        case Token::Type::ADD_OP:
-            return getBinaryExprCtor<AdditionExpression>();
-        case Token::Type::MIN_OP:
-            return getBinaryExprCtor<SubtractionExpression>();
-        default:
-            return std::nullopt;
-    }
-}
-
-std::optional<MultiplicativeExpression::Ctor> MultiplicativeExpression::getCtor(
-    Token::Type type) {
-    switch (type) {
-        case Token::Type::MULT_OP:
-            return getBinaryExprCtor<MultiplicationExpression>();
-        case Token::Type::DIV_OP:
-            return getBinaryExprCtor<DivisionExpression>();
-        default:
-            return std::nullopt;
-    }
+PExpression makeTypeExpr(Arena& arena, PExpression expr, Type type,
+                         const Position& position) {
+    return arena.make<T>(std::move(expr), std::move(type), position);
 }
 
 std::optional<NegationExpression::Ctor> NegationExpression::getCtor(Token::Type type) {
     switch (type) {
         case Token::Type::MIN_OP:
-            return getUnaryExprCtor<SignChangeExpression>();
+            return &makeUnaryExpr<SignChangeExpression>;
         case Token::Type::NOT_KW:
-            return getUnaryExprCtor<LogicalNegationExpression>();
+            return &makeUnaryExpr<LogicalNegationExpression>;
         default:
             return std::nullopt;
     }
@@ -78,9 +25,9 @@ std::optional<NegationExpression::Ctor> NegationExpression::getCtor(Token::Type
 std::optional<TypeExpression::Ctor> TypeExpression::getCtor(Token::Type type) {
     switch (type) {
         case Token::Type::AS_KW:
-            return getBinaryExprCtor<ConversionExpression>();
+            return &makeTypeExpr<ConversionExpression>;
         case Token::Type::IS_KW:
-            return getBinaryExprCtor<TypeCheckExpression>();
+            return &makeTypeExpr<TypeCheckExpression>;
         default:
             return std::nullopt;
     }
@@ -1,14 +1,17 @@
 #ifndef EXPRESSIONS_H
 #define EXPRESSIONS_H
 
-#include <functional>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <variant>
 #include <vector>
 
+#include "arena.hpp"
+#include "shared_string.hpp"
 #include "token.hpp"
+#include "type_registry.hpp"
 #include "types.hpp"
 
 struct StructInitExpression;
@@ -77,9 +80,13 @@ struct SyntaxNode {
 
 struct Expression : public virtual SyntaxNode {
     virtual void accept(const ExpressionVisitor& vis) const = 0;
+
+    /// Type of the values of the expression proven by the type checker, nullptr if not
+    /// known. Points to an interned type, see TypeChecker
+    mutable const Type* checkedType{nullptr};
 };
 
-using PExpression = std::unique_ptr<Expression>;
+using PExpression = NodePtr<Expression>;
 
 struct StructInitExpression : public Expression {
     std::vector<PExpression> exprs;
@@ -93,9 +100,21 @@ struct StructInitExpression : public Expression {
 struct BinaryExpression : public Expression {
     PExpression lhs;
     PExpression rhs;
+    /// Whether the type checker proved the operands to be of the same type, which the
+    /// operator accepts
+    mutable bool checked{false};
 
     BinaryExpression(PExpression lhs, PExpression rhs, const Position& position)
         : SyntaxNode{position}, lhs{std::move(lhs)}, rhs{std::move(rhs)} {}
+
+    using Ctor = PExpression (*)(Arena&, PExpression, PExpression, const Position&);
+
+    /// @brief Constructs a binary expression of type T in the arena, usable as a Ctor
+    template <typename T>
+    static PExpression make(Arena& arena, PExpression lhs, PExpression rhs,
+                            const Position& position) {
+        return arena.make<T>(std::move(lhs), std::move(rhs), position);
+    }
 };
 
 struct DisjunctionExpression : public BinaryExpression {
@@ -116,9 +135,6 @@ struct ConjunctionExpression : public BinaryExpression {
 
 struct ComparisonExpression : public BinaryExpression {
     using BinaryExpression::BinaryExpression;
-    using Ctor = std::function<PExpression(PExpression, PExpression, const Position&)>;
-
-    static std::optional<Ctor> getCtor(Token::Type type);
 };
 
 struct EqualExpression : public ComparisonExpression {
@@ -139,9 +155,6 @@ struct NotEqualExpression : public ComparisonExpression {
 
 struct RelationExpression : public BinaryExpression {
     using BinaryExpression::BinaryExpression;
-    using Ctor = std::function<PExpression(PExpression, PExpression, const Position&)>;
-
-    static std::optional<Ctor> getCtor(Token::Type type);
 };
 
 struct LessThanExpression : public RelationExpression {
@@ -179,9 +192,6 @@ struct GreaterThanOrEqualExpression : public RelationExpression {
 
 struct AdditiveExpression : public BinaryExpression {
     using BinaryExpression::BinaryExpression;
-    using Ctor = std::function<PExpression(PExpression, PExpression, const Position&)>;
-
-    static std::optional<Ctor> getCtor(Token::Type type);
 };
 
 struct AdditionExpression : public AdditiveExpression {
@@ -202,9 +212,6 @@ struct SubtractionExpression : public AdditiveExpression {
 
 struct MultiplicativeExpression : public BinaryExpression {
     using BinaryExpression::BinaryExpression;
-    using Ctor = std::function<PExpression(PExpression, PExpression, const Position&)>;
-
-    static std::optional<Ctor> getCtor(Token::Type type);
 };
 
 struct MultiplicationExpression : public MultiplicativeExpression {
@@ -228,7 +235,7 @@ struct NegationExpression : public Expression {
     NegationExpression(PExpression expr, const Position& position)
         : SyntaxNode{position}, expr{std::move(expr)} {}
 
-    using Ctor = std::function<PExpression(PExpression, const Position&)>;
+    using Ctor = PExpression (*)(Arena&, PExpression, const Position&);
 
     static std::optional<Ctor> getCtor(Token::Type type);
 };
@@ -250,11 +257,15 @@ struct LogicalNegationExpression : public NegationExpression {
 struct TypeExpression : public Expression {
     PExpression expr;
     Type type;
+    TypeId typeId;
 
     TypeExpression(PExpression expr, Type type, const Position& position)
-        : SyntaxNode{position}, expr{std::move(expr)}, type{std::move(type)} {}
+        : SyntaxNode{position},
+          expr{std::move(expr)},
+          type{std::move(type)},
+          typeId{TypeRegistry::getId(this->type)} {}
 
-    using Ctor = std::function<PExpression(PExpression, Type, const Position&)>;
+    using Ctor = PExpression (*)(Arena&, PExpression, Type, const Position&);
 
     static std::optional<Ctor> getCtor(Token::Type type);
 };
@@ -275,18 +286,29 @@ struct TypeCheckExpression : public TypeExpression {
     void accept(const ExpressionVisitor& vis) const override { vis(*this); }
 };
 
+struct StructDef;
+
+/// @brief Index of an accessed field in the structure in which the interpreter last
+/// found it. Structures of the same name defined in different scopes may order their
+/// fields differently, so the index is valid only for that definition
+struct FieldIndex {
+    const StructDef* structDef{nullptr};
+    std::uint32_t index{0};
+};
+
 struct FieldAccessExpression : public Expression {
     PExpression expr;
-    std::string field;
+    Symbol field;
+    mutable FieldIndex fieldIndex;
 
-    FieldAccessExpression(PExpression expr, std::string field, const Position& position)
-        : SyntaxNode{position}, expr{std::move(expr)}, field{std::move(field)} {}
+    FieldAccessExpression(PExpression expr, Symbol field, const Position& position)
+        : SyntaxNode{position}, expr{std::move(expr)}, field{field} {}
 
     void accept(const ExpressionVisitor& vis) const override { vis(*this); }
 };
 
 struct Constant : public Expression {
-    using Value = std::variant<int, float, bool, std::string>;
+    using Value = std::variant<int, float, bool, SharedString>;
 
     Value value;
 
@@ -296,11 +318,22 @@ struct Constant : public Expression {
     void accept(const ExpressionVisitor& vis) const override { vis(*this); }
 };
 
+/// @brief Location of a variable in the call contexts, assigned by the interpreter's
+/// name resolution before the node is executed
+struct VariableSlot {
+    /// Number of function contexts between the one of the use and the one of the
+    /// definition, 0 for the variables of the current function
+    std::uint32_t depth{0};
+    /// Index of the variable in the slots of its context
+    std::uint32_t index{0};
+};
+
 struct VariableAccess : public Expression {
-    std::string name;
+    Symbol name;
+    mutable VariableSlot slot;
 
-    VariableAccess(std::string name, const Position& position)
-        : SyntaxNode{position}, name{std::move(name)} {}
+    VariableAccess(Symbol name, const Position& position)
+        : SyntaxNode{position}, name{name} {}
 
     void accept(const ExpressionVisitor& vis) const override { vis(*this); }
 };
@@ -0,0 +1,767 @@
+#include "flat_ast.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+#include "hash.hpp"
+
+FlatAst::NodeIndex FlatAst::addNode(const FlatNode& node, const Position& position) {
+    nodes_.push_back(node);
+    positions_.push_back(position);
+    return static_cast<NodeIndex>(nodes_.size() - 1);
+}
+
+FlatAst::ListIndex FlatAst::addList(std::span<const std::uint32_t> elements) {
+    const auto index = static_cast<ListIndex>(lists_.size());
+    lists_.push_back(static_cast<std::uint32_t>(elements.size()));
+    lists_.insert(lists_.end(), elements.begin(), elements.end());
+    return index;
+}
+
+std::uint32_t FlatAst::addString(SharedString text) {
+    strings_.push_back(std::move(text));
+    return static_cast<std::uint32_t>(strings_.size() - 1);
+}
+
+std::uint32_t FlatAst::addType(Type type) {
+    // Programs use few distinct types
+    auto it = std::ranges::find(types_, type);
+    if (it == types_.end())
+        it = types_.insert(it, std::move(type));
+    return static_cast<std::uint32_t>(it - types_.begin());
+}
+
+std::uint32_t FlatAst::addSignature(Signature signature) {
+    signatures_.push_back(std::move(signature));
+    return static_cast<std::uint32_t>(signatures_.size() - 1);
+}
+
+std::size_t FlatAst::getMemoryUsage() const {
+    return nodes_.size() * sizeof(FlatNode) + positions_.size() * sizeof(Position)
+           + lists_.size() * sizeof(std::uint32_t)
+           + strings_.size() * sizeof(SharedString) + types_.size() * sizeof(Type)
+           + signatures_.size() * sizeof(Signature);
+}
+
+namespace {
+constexpr std::string_view formatMagic{"RPTRAST", 8};
+constexpr std::uint32_t formatVersion{1};
+constexpr std::uint32_t byteOrderMark{0x01020304};
+
+/// Encoding of Type and ReturnType
+struct EncodedType {
+    enum class Kind : std::uint8_t { NAMED, BUILT_IN, VOID };
+
+    Kind kind;
+    /// Name index or BuiltInType
+    std::uint32_t value{0};
+};
+
+class ByteWriter {
+   public:
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        bytes_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(static_cast<std::uint32_t>(values.size()));
+        bytes_.append(reinterpret_cast<const char*>(values.data()),
+                      values.size() * sizeof(T));
+    }
+
+    void writeType(EncodedType type) {
+        write(type.kind);
+        write(type.value);
+    }
+
+    void writeText(std::string_view text) {
+        write(static_cast<std::uint32_t>(text.size()));
+        bytes_.append(text);
+    }
+
+    std::string& getBytes() { return bytes_; }
+
+   private:
+    std::string bytes_;
+};
+
+/// Thrown while decoding bytes that are not a valid encoding
+struct InvalidData {};
+
+class ByteReader {
+   public:
+    explicit ByteReader(std::string_view bytes)
+        : bytes_{bytes} {}
+
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> readArray() {
+        const auto count = read<std::uint32_t>();
+        if (count > bytes_.size() / sizeof(T))
+            throw InvalidData();
+        std::vector<T> values(count);
+        if (count > 0)
+            std::memcpy(values.data(), take(count * sizeof(T)).data(), count * sizeof(T));
+        return values;
+    }
+
+    EncodedType readType() {
+        const auto kind = read<EncodedType::Kind>();
+        return {kind, read<std::uint32_t>()};
+    }
+
+    std::string_view readText() { return take(read<std::uint32_t>()); }
+
+    std::string_view getRest() const { return bytes_; }
+
+   private:
+    std::string_view take(std::size_t size) {
+        if (size > bytes_.size())
+            throw InvalidData();
+        const auto taken = bytes_.substr(0, size);
+        bytes_.remove_prefix(size);
+        return taken;
+    }
+
+    std::string_view bytes_;
+};
+
+/// Numbers the distinct names in the order of their first use
+class NameTable {
+   public:
+    std::uint32_t add(std::string_view name) {
+        const auto [it, added] =
+            indices_.emplace(name, static_cast<std::uint32_t>(names_.size()));
+        if (added)
+            names_.push_back(name);
+        return it->second;
+    }
+
+    const std::vector<std::string_view>& getNames() const { return names_; }
+
+   private:
+    std::unordered_map<std::string_view, std::uint32_t> indices_;
+    std::vector<std::string_view> names_;
+};
+
+struct TypeEncoder {
+    EncodedType operator()(const std::string& name) const {
+        return {EncodedType::Kind::NAMED, names.add(name)};
+    }
+    EncodedType operator()(BuiltInType type) const {
+        return {EncodedType::Kind::BUILT_IN, static_cast<std::uint32_t>(type)};
+    }
+    EncodedType operator()(VoidType) const { return {EncodedType::Kind::VOID}; }
+
+    NameTable& names;
+};
+
+ReturnType decodeReturnType(EncodedType type, std::span<const std::string_view> names) {
+    switch (type.kind) {
+        case EncodedType::Kind::NAMED:
+            if (type.value >= names.size())
+                throw InvalidData();
+            return std::string(names[type.value]);
+        case EncodedType::Kind::BUILT_IN:
+            if (type.value > static_cast<std::uint32_t>(BuiltInType::STR))
+                throw InvalidData();
+            return static_cast<BuiltInType>(type.value);
+        case EncodedType::Kind::VOID:
+            return VoidType();
+    }
+    throw InvalidData();
+}
+
+Type decodeType(EncodedType type, std::span<const std::string_view> names) {
+    return std::visit(
+        []<typename T>(T decoded) -> Type {
+            if constexpr (std::is_same_v<T, VoidType>)
+                throw InvalidData();
+            else
+                return decoded;
+        },
+        decodeReturnType(type, names));
+}
+}  // namespace
+
+std::string FlatAst::serialize() const {
+    NameTable names;
+    const TypeEncoder encode{names};
+
+    auto nodes = nodes_;
+    for (auto& node : nodes) {
+        if (hasName(node.kind))
+            node.data = names.add(Symbol::fromId(node.data).getText());
+    }
+
+    ByteWriter payload;
+    payload.writeArray(nodes);
+    payload.writeArray(positions_);
+    payload.writeArray(lists_);
+    payload.write(statements_);
+
+    payload.write(static_cast<std::uint32_t>(types_.size()));
+    for (const auto& type : types_)
+        payload.writeType(std::visit(encode, type));
+
+    payload.write(static_cast<std::uint32_t>(signatures_.size()));
+    for (const auto& signature : signatures_) {
+        payload.writeType(std::visit(encode, signature.returnType));
+        payload.write(names.add(signature.name.getText()));
+    }
+
+    payload.write(static_cast<std::uint32_t>(strings_.size()));
+    for (const auto& string : strings_)
+        payload.writeText(string.getText());
+
+    payload.write(static_cast<std::uint32_t>(names.getNames().size()));
+    for (const auto name : names.getNames())
+        payload.writeText(name);
+
+    ByteWriter writer;
+    writer.getBytes().append(formatMagic);
+    writer.write(formatVersion);
+    writer.write(byteOrderMark);
+    writer.write(static_cast<std::uint32_t>(sizeof(FlatNode)));
+    writer.write(hashBytes(payload.getBytes()));
+    writer.getBytes().append(payload.getBytes());
+    return std::move(writer.getBytes());
+}
+
+std::optional<FlatAst> FlatAst::deserialize(std::string_view bytes) {
+    if (!bytes.starts_with(formatMagic))
+        return std::nullopt;
+
+    try {
+        ByteReader header(bytes.substr(formatMagic.size()));
+        if (header.read<std::uint32_t>() != formatVersion
+            || header.read<std::uint32_t>() != byteOrderMark
+            || header.read<std::uint32_t>() != sizeof(FlatNode))
+            return std::nullopt;
+        const auto checksum = header.read<std::uint64_t>();
+
+        const auto payload = header.getRest();
+        if (hashBytes(payload) != checksum)
+            return std::nullopt;
+
+        ByteReader reader(payload);
+        FlatAst ast;
+        ast.nodes_ = reader.readArray<FlatNode>();
+        ast.positions_ = reader.readArray<Position>();
+        ast.lists_ = reader.readArray<std::uint32_t>();
+        ast.statements_ = reader.read<ListIndex>();
+
+        std::vector<EncodedType> types(reader.read<std::uint32_t>());
+        for (auto& type : types)
+            type = reader.readType();
+
+        std::vector<std::pair<EncodedType, std::uint32_t>> signatures(
+            reader.read<std::uint32_t>());
+        for (auto& [returnType, name] : signatures) {
+            returnType = reader.readType();
+            name = reader.read<std::uint32_t>();
+        }
+
+        ast.strings_.resize(reader.read<std::uint32_t>());
+        for (auto& string : ast.strings_)
+            string = SharedString(reader.readText());
+
+        std::vector<std::string_view> names(reader.read<std::uint32_t>());
+        for (auto& name : names)
+            name = reader.readText();
+        if (!reader.getRest().empty() || ast.positions_.size() != ast.nodes_.size()
+            || ast.statements_ >= ast.lists_.size())
+            return std::nullopt;
+
+        std::vector<std::uint32_t> symbols;
+        symbols.reserve(names.size());
+        for (const auto name : names)
+            symbols.push_back(Symbol(name).getId());
+
+        for (auto& node : ast.nodes_) {
+            if (hasName(node.kind))
+                node.data = symbols.at(node.data);
+        }
+        for (const auto type : types)
+            ast.types_.push_back(decodeType(type, names));
+        for (const auto& [returnType, name] : signatures) {
+            ast.signatures_.push_back({.returnType = decodeReturnType(returnType, names),
+                                       .name = Symbol::fromId(symbols.at(name))});
+        }
+        return ast;
+    } catch (const InvalidData&) {
+        return std::nullopt;
+    } catch (const std::out_of_range&) {
+        return std::nullopt;
+    }
+}
+
+class ExpressionFlattener : public ExpressionVisitor {
+   public:
+    explicit ExpressionFlattener(FlatAst& ast)
+        : ast_{ast} {}
+
+    FlatAst::NodeIndex flatten(const Expression* expr) const {
+        if (!expr)
+            return FlatAst::none;
+        expr->accept(*this);
+        return result_;
+    }
+
+    void operator()(const StructInitExpression& expr) const override {
+        std::vector<std::uint32_t> exprs;
+        for (const auto& element : expr.exprs)
+            exprs.push_back(flatten(element.get()));
+        add({.kind = NodeKind::STRUCT_INIT, .lhs = ast_.addList(exprs)}, expr);
+    }
+    void operator()(const DisjunctionExpression& expr) const override {
+        addBinary(NodeKind::DISJUNCTION, expr);
+    }
+    void operator()(const ConjunctionExpression& expr) const override {
+        addBinary(NodeKind::CONJUNCTION, expr);
+    }
+    void operator()(const EqualExpression& expr) const override {
+        addBinary(NodeKind::EQUAL, expr);
+    }
+    void operator()(const NotEqualExpression& expr) const override {
+        addBinary(NodeKind::NOT_EQUAL, expr);
+    }
+    void operator()(const LessThanExpression& expr) const override {
+        addBinary(NodeKind::LESS_THAN, expr);
+    }
+    void operator()(const LessThanOrEqualExpression& expr) const override {
+        addBinary(NodeKind::LESS_THAN_OR_EQUAL, expr);
+    }
+    void operator()(const GreaterThanExpression& expr) const override {
+        addBinary(NodeKind::GREATER_THAN, expr);
+    }
+    void operator()(const GreaterThanOrEqualExpression& expr) const override {
+        addBinary(NodeKind::GREATER_THAN_OR_EQUAL, expr);
+    }
+    void operator()(const AdditionExpression& expr) const override {
+        addBinary(NodeKind::ADDITION, expr);
+    }
+    void operator()(const SubtractionExpression& expr) const override {
+        addBinary(NodeKind::SUBTRACTION, expr);
+    }
+    void operator()(const MultiplicationExpression& expr) const override {
+        addBinary(NodeKind::MULTIPLICATION, expr);
+    }
+    void operator()(const DivisionExpression& expr) const override {
+        addBinary(NodeKind::DIVISION, expr);
+    }
+    void operator()(const SignChangeExpression& expr) const override {
+        add({.kind = NodeKind::SIGN_CHANGE, .lhs = flatten(expr.expr.get())}, expr);
+    }
+    void operator()(const LogicalNegationExpression& expr) const override {
+        add({.kind = NodeKind::LOGICAL_NEGATION, .lhs = flatten(expr.expr.get())}, expr);
+    }
+    void operator()(const ConversionExpression& expr) const override {
+        addTypeExpression(NodeKind::CONVERSION, expr);
+    }
+    void operator()(const TypeCheckExpression& expr) const override {
+        addTypeExpression(NodeKind::TYPE_CHECK, expr);
+    }
+    void operator()(const FieldAccessExpression& expr) const override {
+        add({.kind = NodeKind::FIELD_ACCESS,
+             .data = expr.field.getId(),
+             .lhs = flatten(expr.expr.get())},
+            expr);
+    }
+    void operator()(const Constant& expr) const override {
+        add(std::visit(*this, expr.value), expr);
+    }
+
+    FlatNode operator()(int value) const {
+        return {.kind = NodeKind::INT_CONSTANT,
+                .data = std::bit_cast<std::uint32_t>(value)};
+    }
+    FlatNode operator()(float value) const {
+        return {.kind = NodeKind::FLOAT_CONSTANT,
+                .data = std::bit_cast<std::uint32_t>(value)};
+    }
+    FlatNode operator()(bool value) const {
+        return {.kind = NodeKind::BOOL_CONSTANT, .data = value};
+    }
+    FlatNode operator()(const SharedString& value) const {
+        return {.kind = NodeKind::STR_CONSTANT, .data = ast_.addString(value)};
+    }
+    void operator()(const FuncCall& funcCall) const override {
+        std::vector<std::uint32_t> arguments;
+        for (const auto& argument : funcCall.arguments) {
+            const FlatNode node{.kind = NodeKind::ARGUMENT,
+                                .flag = argument.ref,
+                                .lhs = flatten(argument.value.get())};
+            arguments.push_back(ast_.addNode(node, argument.position));
+        }
+        add({.kind = NodeKind::FUNC_CALL,
+             .data = funcCall.name.getId(),
+             .lhs = ast_.addList(arguments)},
+            funcCall);
+    }
+    void operator()(const VariableAccess& expr) const override {
+        add({.kind = NodeKind::VARIABLE_ACCESS, .data = expr.name.getId()}, expr);
+    }
+
+   private:
+    void add(const FlatNode& node, const SyntaxNode& syntaxNode) const {
+        result_ = ast_.addNode(node, syntaxNode.position);
+    }
+
+    void addBinary(NodeKind kind, const BinaryExpression& expr) const {
+        const auto lhs = flatten(expr.lhs.get());
+        const auto rhs = flatten(expr.rhs.get());
+        add({.kind = kind, .lhs = lhs, .rhs = rhs}, expr);
+    }
+
+    void addTypeExpression(NodeKind kind, const TypeExpression& expr) const {
+        const auto operand = flatten(expr.expr.get());
+        add({.kind = kind, .data = ast_.addType(expr.type), .lhs = operand}, expr);
+    }
+
+    FlatAst& ast_;
+    mutable FlatAst::NodeIndex result_{FlatAst::none};
+};
+
+struct LValueFlattener {
+    FlatAst::NodeIndex operator()(Symbol name) const {
+        return ast.addNode({.kind = NodeKind::VARIABLE_LVALUE, .data = name.getId()},
+                           position);
+    }
+    FlatAst::NodeIndex operator()(const NodePtr<FieldAccess>& fieldAccess) const {
+        const auto container = std::visit(*this, fieldAccess->container);
+        const FlatNode node{.kind = NodeKind::FIELD_LVALUE,
+                            .data = fieldAccess->field.getId(),
+                            .lhs = container};
+        return ast.addNode(node, position);
+    }
+
+    FlatAst& ast;
+    Position position;
+};
+
+class StatementFlattener : public StatementVisitor {
+   public:
+    explicit StatementFlattener(FlatAst& ast)
+        : ast_{ast}, exprFlattener_{ast} {}
+
+    FlatAst::ListIndex flatten(const Statements& statements) {
+        std::vector<std::uint32_t> indices;
+        for (const auto& statement : statements) {
+            statement->accept(*this);
+            indices.push_back(result_);
+        }
+        return ast_.addList(indices);
+    }
+
+    void operator()(const IfStatement& stmt) override {
+        addConditional(NodeKind::IF, stmt);
+    }
+    void operator()(const WhileStatement& stmt) override {
+        addConditional(NodeKind::WHILE, stmt);
+    }
+    void operator()(const ReturnStatement& stmt) override {
+        const auto expr = exprFlattener_.flatten(stmt.expression.get());
+        add({.kind = NodeKind::RETURN, .lhs = expr}, stmt);
+    }
+    void operator()(const PrintStatement& stmt) override {
+        const auto expr = exprFlattener_.flatten(stmt.expression.get());
+        add({.kind = NodeKind::PRINT, .lhs = expr}, stmt);
+    }
+    void operator()(const FuncDef& stmt) override {
+        std::vector<std::uint32_t> parameters;
+        for (const auto& parameter : stmt.getParameters()) {
+            const FlatNode node{.kind = NodeKind::PARAMETER,
+                                .flag = parameter.ref,
+                                .data = parameter.name.getId(),
+                                .lhs = ast_.addType(parameter.type)};
+            parameters.push_back(ast_.addNode(node, parameter.position));
+        }
+        const auto signature = ast_.addSignature(
+            {.returnType = stmt.getReturnType(), .name = stmt.getName()});
+        const auto parameterList = ast_.addList(parameters);
+        const auto statements = flatten(stmt.getStatements());
+        add({.kind = NodeKind::FUNC_DEF,
+             .data = signature,
+             .lhs = parameterList,
+             .rhs = statements},
+            stmt);
+    }
+    void operator()(const Assignment& stmt) override {
+        const auto lhs = std::visit(LValueFlattener(ast_, stmt.position), stmt.lhs);
+        const auto rhs = exprFlattener_.flatten(stmt.rhs.get());
+        add({.kind = NodeKind::ASSIGNMENT, .lhs = lhs, .rhs = rhs}, stmt);
+    }
+    void operator()(const VarDef& stmt) override {
+        const auto expr = exprFlattener_.flatten(stmt.expression.get());
+        add({.kind = NodeKind::VAR_DEF,
+             .flag = stmt.isConst,
+             .data = stmt.name.getId(),
+             .lhs = expr,
+             .rhs = ast_.addType(stmt.type)},
+            stmt);
+    }
+    void operator()(const FuncCall& stmt) override {
+        result_ = exprFlattener_.flatten(&stmt);
+    }
+    void operator()(const StructDef& stmt) override {
+        std::vector<std::uint32_t> fields;
+        for (const auto& field : stmt.fields) {
+            const FlatNode node{.kind = NodeKind::FIELD,
+                                .data = field.name.getId(),
+                                .lhs = ast_.addType(field.type)};
+            fields.push_back(ast_.addNode(node, stmt.position));
+        }
+        add({.kind = NodeKind::STRUCT_DEF,
+             .data = Symbol(stmt.name).getId(),
+             .lhs = ast_.addList(fields)},
+            stmt);
+    }
+    void operator()(const VariantDef& stmt) override {
+        std::vector<std::uint32_t> types;
+        for (const auto& type : stmt.types)
+            types.push_back(ast_.addType(type));
+        add({.kind = NodeKind::VARIANT_DEF,
+             .data = Symbol(stmt.name).getId(),
+             .lhs = ast_.addList(types)},
+            stmt);
+    }
+
+   private:
+    void add(const FlatNode& node, const SyntaxNode& syntaxNode) {
+        result_ = ast_.addNode(node, syntaxNode.position);
+    }
+
+    void addConditional(NodeKind kind, const ConditionalStatement& stmt) {
+        const auto condition = exprFlattener_.flatten(stmt.condition.get());
+        const auto statements = flatten(stmt.statements);
+        add({.kind = kind, .lhs = condition, .rhs = statements}, stmt);
+    }
+
+    FlatAst& ast_;
+    ExpressionFlattener exprFlattener_;
+    FlatAst::NodeIndex result_{FlatAst::none};
+};
+
+FlatAst flatten(const Program& program) {
+    FlatAst ast;
+    ast.setStatements(StatementFlattener(ast).flatten(program.statements));
+    return ast;
+}
+
+/// @brief Builds parse tree nodes from the flat nodes
+class Unflattener {
+   public:
+    explicit Unflattener(const FlatAst& ast)
+        : ast_{ast}, arena_{std::make_unique<Arena>()} {}
+
+    Program build() {
+        auto statements = buildStatements(ast_.getStatements());
+        return Program(std::move(statements), std::move(literals_), std::move(arena_));
+    }
+
+   private:
+    Statements buildStatements(std::span<const std::uint32_t> indices) {
+        Statements statements;
+        for (const auto index : indices)
+            statements.push_back(buildStatement(index));
+        return statements;
+    }
+
+    PStatement buildStatement(FlatAst::NodeIndex index) {
+        const auto& node = ast_.getNode(index);
+        const auto& position = ast_.getPosition(index);
+
+        switch (node.kind) {
+            case NodeKind::IF:
+                return arena_->make<IfStatement>(
+                    buildExpression(node.lhs), buildStatements(ast_.getList(node.rhs)),
+                    position);
+            case NodeKind::WHILE:
+                return arena_->make<WhileStatement>(
+                    buildExpression(node.lhs), buildStatements(ast_.getList(node.rhs)),
+                    position);
+            case NodeKind::RETURN:
+                return arena_->make<ReturnStatement>(buildExpression(node.lhs), position);
+            case NodeKind::PRINT:
+                return arena_->make<PrintStatement>(buildExpression(node.lhs), position);
+            case NodeKind::FUNC_DEF: {
+                const auto& signature = ast_.getSignature(node.data);
+                return arena_->make<FuncDef>(signature.returnType, signature.name,
+                                             buildParameters(ast_.getList(node.lhs)),
+                                             buildStatements(ast_.getList(node.rhs)),
+                                             position);
+            }
+            case NodeKind::ASSIGNMENT:
+                return arena_->make<Assignment>(buildLValue(node.lhs),
+                                                buildExpression(node.rhs), position);
+            case NodeKind::VAR_DEF:
+                return arena_->make<VarDef>(node.flag, ast_.getType(node.rhs),
+                                            Symbol::fromId(node.data),
+                                            buildExpression(node.lhs), position);
+            case NodeKind::FUNC_CALL:
+                return buildFuncCall(node, position);
+            case NodeKind::STRUCT_DEF: {
+                std::vector<Field> fields;
+                for (const auto field : ast_.getList(node.lhs)) {
+                    const auto& fieldNode = ast_.getNode(field);
+                    fields.push_back({.type = ast_.getType(fieldNode.lhs),
+                                      .name = Symbol::fromId(fieldNode.data)});
+                }
+                return arena_->make<StructDef>(getName(node), std::move(fields),
+                                               position);
+            }
+            case NodeKind::VARIANT_DEF: {
+                std::vector<Type> types;
+                for (const auto type : ast_.getList(node.lhs))
+                    types.push_back(ast_.getType(type));
+                return arena_->make<VariantDef>(getName(node), std::move(types),
+                                                position);
+            }
+            default:
+                throw std::logic_error("Flat node is not a statement");
+        }
+    }
+
+    PExpression buildExpression(FlatAst::NodeIndex index) {
+        if (index == FlatAst::none)
+            return nullptr;
+
+        const auto& node = ast_.getNode(index);
+        const auto& position = ast_.getPosition(index);
+
+        switch (node.kind) {
+            case NodeKind::STRUCT_INIT: {
+                std::vector<PExpression> exprs;
+                for (const auto expr : ast_.getList(node.lhs))
+                    exprs.push_back(buildExpression(expr));
+                return arena_->make<StructInitExpression>(std::move(exprs), position);
+            }
+            case NodeKind::DISJUNCTION:
+                return buildBinary<DisjunctionExpression>(node, position);
+            case NodeKind::CONJUNCTION:
+                return buildBinary<ConjunctionExpression>(node, position);
+            case NodeKind::EQUAL:
+                return buildBinary<EqualExpression>(node, position);
+            case NodeKind::NOT_EQUAL:
+                return buildBinary<NotEqualExpression>(node, position);
+            case NodeKind::LESS_THAN:
+                return buildBinary<LessThanExpression>(node, position);
+            case NodeKind::LESS_THAN_OR_EQUAL:
+                return buildBinary<LessThanOrEqualExpression>(node, position);
+            case NodeKind::GREATER_THAN:
+                return buildBinary<GreaterThanExpression>(node, position);
+            case NodeKind::GREATER_THAN_OR_EQUAL:
+                return buildBinary<GreaterThanOrEqualExpression>(node, position);
+            case NodeKind::ADDITION:
+                return buildBinary<AdditionExpression>(node, position);
+            case NodeKind::SUBTRACTION:
+                return buildBinary<SubtractionExpression>(node, position);
+            case NodeKind::MULTIPLICATION:
+                return buildBinary<MultiplicationExpression>(node, position);
+            case NodeKind::DIVISION:
+                return buildBinary<DivisionExpression>(node, position);
+            case NodeKind::SIGN_CHANGE:
+                return arena_->make<SignChangeExpression>(buildExpression(node.lhs),
+                                                          position);
+            case NodeKind::LOGICAL_NEGATION:
+                return arena_->make<LogicalNegationExpression>(buildExpression(node.lhs),
+                                                               position);
+            case NodeKind::CONVERSION:
+                return arena_->make<ConversionExpression>(
+                    buildExpression(node.lhs), ast_.getType(node.data), position);
+            case NodeKind::TYPE_CHECK:
+                return arena_->make<TypeCheckExpression>(
+                    buildExpression(node.lhs), ast_.getType(node.data), position);
+            case NodeKind::FIELD_ACCESS:
+                return arena_->make<FieldAccessExpression>(
+                    buildExpression(node.lhs), Symbol::fromId(node.data), position);
+            case NodeKind::INT_CONSTANT:
+                return buildConstant(std::bit_cast<int>(node.data), position);
+            case NodeKind::FLOAT_CONSTANT:
+                return buildConstant(std::bit_cast<float>(node.data), position);
+            case NodeKind::BOOL_CONSTANT:
+                return buildConstant(node.data != 0, position);
+            case NodeKind::STR_CONSTANT: {
+                const auto& text = ast_.getString(node.data).getText();
+                return buildConstant(literals_.intern(text), position);
+            }
+            case NodeKind::FUNC_CALL:
+                return buildFuncCall(node, position);
+            case NodeKind::VARIABLE_ACCESS:
+                return arena_->make<VariableAccess>(Symbol::fromId(node.data), position);
+            default:
+                throw std::logic_error("Flat node is not an expression");
+        }
+    }
+
+    template <typename T>
+    PExpression buildBinary(const FlatNode& node, const Position& position) {
+        auto lhs = buildExpression(node.lhs);
+        auto rhs = buildExpression(node.rhs);
+        return arena_->make<T>(std::move(lhs), std::move(rhs), position);
+    }
+
+    NodePtr<FuncCall> buildFuncCall(const FlatNode& node, const Position& position) {
+        Arguments arguments;
+        for (const auto argument : ast_.getList(node.lhs)) {
+            const auto& argumentNode = ast_.getNode(argument);
+            arguments.push_back({.value = buildExpression(argumentNode.lhs),
+                                 .ref = argumentNode.flag,
+                                 .position = ast_.getPosition(argument)});
+        }
+        return arena_->make<FuncCall>(Symbol::fromId(node.data), std::move(arguments),
+                                      position);
+    }
+
+    Parameters buildParameters(std::span<const std::uint32_t> indices) const {
+        Parameters parameters;
+        for (const auto index : indices) {
+            const auto& node = ast_.getNode(index);
+            parameters.push_back({.type = ast_.getType(node.lhs),
+                                  .name = Symbol::fromId(node.data),
+                                  .ref = node.flag,
+                                  .position = ast_.getPosition(index)});
+        }
+        return parameters;
+    }
+
+    LValue buildLValue(FlatAst::NodeIndex index) {
+        const auto& node = ast_.getNode(index);
+        if (node.kind == NodeKind::VARIABLE_LVALUE)
+            return Symbol::fromId(node.data);
+        auto container = buildLValue(node.lhs);
+        return arena_->make<FieldAccess>(std::move(container), Symbol::fromId(node.data));
+    }
+
+    PExpression buildConstant(Constant::Value value, const Position& position) {
+        return arena_->make<Constant>(std::move(value), position);
+    }
+
+    static std::string getName(const FlatNode& node) {
+        return std::string(Symbol::fromId(node.data).getText());
+    }
+
+    const FlatAst& ast_;
+    std::unique_ptr<Arena> arena_;
+    LiteralPool literals_;
+};
+
+Program unflatten(const FlatAst& ast) {
+    return Unflattener(ast).build();
+}
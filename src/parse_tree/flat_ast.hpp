@@ -0,0 +1,196 @@
+#ifndef FLAT_AST_H
+#define FLAT_AST_H
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parse_tree.hpp"
+
+/// @brief Kind of a FlatNode, one per concrete parse tree node
+enum class NodeKind : std::uint8_t {
+    IF,
+    WHILE,
+    RETURN,
+    PRINT,
+    FUNC_DEF,
+    ASSIGNMENT,
+    VAR_DEF,
+    FUNC_CALL,
+    STRUCT_DEF,
+    VARIANT_DEF,
+
+    VARIABLE_LVALUE,
+    FIELD_LVALUE,
+
+    STRUCT_INIT,
+    DISJUNCTION,
+    CONJUNCTION,
+    EQUAL,
+    NOT_EQUAL,
+    LESS_THAN,
+    LESS_THAN_OR_EQUAL,
+    GREATER_THAN,
+    GREATER_THAN_OR_EQUAL,
+    ADDITION,
+    SUBTRACTION,
+    MULTIPLICATION,
+    DIVISION,
+    SIGN_CHANGE,
+    LOGICAL_NEGATION,
+    CONVERSION,
+    TYPE_CHECK,
+    FIELD_ACCESS,
+    INT_CONSTANT,
+    FLOAT_CONSTANT,
+    BOOL_CONSTANT,
+    STR_CONSTANT,
+    VARIABLE_ACCESS,
+
+    ARGUMENT,
+    PARAMETER,
+    FIELD,
+};
+
+/// @brief Node of the FlatAst
+///
+/// The meaning of the operands depends on the kind:
+///  - IF, WHILE: lhs condition, rhs list of statements
+///  - RETURN, PRINT: lhs expression or FlatAst::none
+///  - FUNC_DEF: data signature index, lhs list of PARAMETERs, rhs list of statements
+///  - ASSIGNMENT: lhs lvalue, rhs expression
+///  - VAR_DEF: flag const, data name, lhs expression, rhs type index
+///  - FUNC_CALL: data name, lhs list of ARGUMENTs
+///  - STRUCT_DEF: data name, lhs list of FIELDs
+///  - VARIANT_DEF: data name, lhs list of type indices
+///  - VARIABLE_LVALUE: data name
+///  - FIELD_LVALUE: data field name, lhs container lvalue
+///  - STRUCT_INIT: lhs list of expressions
+///  - binary expressions: lhs, rhs operands
+///  - SIGN_CHANGE, LOGICAL_NEGATION: lhs operand
+///  - CONVERSION, TYPE_CHECK: data type index, lhs operand
+///  - FIELD_ACCESS: data field name, lhs operand
+///  - INT_CONSTANT, FLOAT_CONSTANT, BOOL_CONSTANT: data bits of the value
+///  - STR_CONSTANT: data string index
+///  - VARIABLE_ACCESS: data name
+///  - ARGUMENT: flag ref, lhs expression
+///  - PARAMETER: flag ref, data name, lhs type index
+///  - FIELD: data name, lhs type index
+///
+/// Names are Symbol ids.
+struct FlatNode {
+    NodeKind kind;
+    bool flag{false};
+    /// Keeps the padding initialized, so that equal trees serialize to equal bytes
+    std::uint16_t reserved{0};
+    std::uint32_t data{0};
+    std::uint32_t lhs{0};
+    std::uint32_t rhs{0};
+};
+
+static_assert(sizeof(FlatNode) == 16);
+
+/// @brief Whether data of nodes of the kind is a name
+constexpr bool hasName(NodeKind kind) {
+    switch (kind) {
+        case NodeKind::VAR_DEF:
+        case NodeKind::FUNC_CALL:
+        case NodeKind::STRUCT_DEF:
+        case NodeKind::VARIANT_DEF:
+        case NodeKind::VARIABLE_LVALUE:
+        case NodeKind::FIELD_LVALUE:
+        case NodeKind::FIELD_ACCESS:
+        case NodeKind::VARIABLE_ACCESS:
+        case NodeKind::PARAMETER:
+        case NodeKind::FIELD:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// @brief Parse tree stored in contiguous arrays instead of separately allocated nodes
+///
+/// Children are referenced by indices into the node array, so nodes carry no vtables
+/// and no pointers. Lists of children are stored one after another in a single array,
+/// positions and payloads that do not fit into a node (strings, types) in side tables.
+/// Equal types are stored once.
+///
+/// The form is meant for serialization, e.g. to cache parsed programs. It is built from a
+/// parsed tree by flatten() and the interpreter runs on the tree rebuilt by unflatten().
+class FlatAst {
+   public:
+    using NodeIndex = std::uint32_t;
+    using ListIndex = std::uint32_t;
+
+    static constexpr NodeIndex none{std::numeric_limits<NodeIndex>::max()};
+
+    struct Signature {
+        ReturnType returnType;
+        Symbol name;
+    };
+
+    NodeIndex addNode(const FlatNode& node, const Position& position);
+    ListIndex addList(std::span<const std::uint32_t> elements);
+    std::uint32_t addString(SharedString text);
+    std::uint32_t addType(Type type);
+    std::uint32_t addSignature(Signature signature);
+    void setStatements(ListIndex statements) { statements_ = statements; }
+
+    const FlatNode& getNode(NodeIndex index) const { return nodes_[index]; }
+    const Position& getPosition(NodeIndex index) const { return positions_[index]; }
+    std::span<const std::uint32_t> getList(ListIndex index) const {
+        return {lists_.data() + index + 1, lists_[index]};
+    }
+    const SharedString& getString(std::uint32_t index) const { return strings_[index]; }
+    const Type& getType(std::uint32_t index) const { return types_[index]; }
+    const Signature& getSignature(std::uint32_t index) const {
+        return signatures_[index];
+    }
+
+    /// @brief Returns top level statements of the program
+    std::span<const std::uint32_t> getStatements() const { return getList(statements_); }
+
+    std::size_t getNodeCount() const { return nodes_.size(); }
+
+    /// @brief Returns number of bytes used by the nodes and the side tables, excluding
+    /// the texts of strings
+    std::size_t getMemoryUsage() const;
+
+    /// @brief Encodes the tree in a binary form readable by any process on a machine of
+    /// the same architecture
+    ///
+    /// The arrays of nodes, positions and lists are stored as they are in memory, names
+    /// as texts, since ids of symbols differ between processes.
+    std::string serialize() const;
+
+    /// @brief Decodes the tree encoded by serialize()
+    /// @param bytes
+    /// @return Tree or std::nullopt if the bytes are not a valid encoding, e.g. they
+    /// were written by another version of the interpreter or are damaged
+    static std::optional<FlatAst> deserialize(std::string_view bytes);
+
+   private:
+    std::vector<FlatNode> nodes_;
+    std::vector<Position> positions_;
+    /// Each list is its length followed by its elements. Starts with an empty list
+    std::vector<std::uint32_t> lists_{0};
+    std::vector<SharedString> strings_;
+    std::vector<Type> types_;
+    std::vector<Signature> signatures_;
+    ListIndex statements_{0};
+};
+
+/// @brief Converts the parse tree of the program to the flat form
+/// @param program
+FlatAst flatten(const Program& program);
+
+/// @brief Rebuilds the parse tree, e.g. for the interpreter or the printer
+/// @param ast
+Program unflatten(const FlatAst& ast);
+
+#endif
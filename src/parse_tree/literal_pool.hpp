@@ -0,0 +1,33 @@
+#ifndef LITERAL_POOL_H
+#define LITERAL_POOL_H
+
+#include <string_view>
+#include <unordered_map>
+
+#include "shared_string.hpp"
+
+/// @brief Strings of the literals of a program, each distinct text stored once
+///
+/// All constants with the same text share one SharedString, so evaluating them never
+/// copies the characters.
+class LiteralPool {
+   public:
+    /// @brief Returns the stored string with the given text, adding it if needed
+    /// @param text
+    SharedString intern(std::string_view text) {
+        if (const auto it = literals_.find(text); it != literals_.end())
+            return it->second;
+
+        SharedString literal{text};
+        literals_.emplace(literal.getText(), literal);
+        return literal;
+    }
+
+    std::size_t size() const { return literals_.size(); }
+
+   private:
+    /// Keys view the texts of their values
+    std::unordered_map<std::string_view, SharedString> literals_;
+};
+
+#endif
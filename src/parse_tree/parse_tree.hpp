@@ -1,11 +1,37 @@
 #ifndef PARSE_TREE_H
 #define PARSE_TREE_H
 
+#include <memory>
+
+#include "arena.hpp"
+#include "literal_pool.hpp"
 #include "position.hpp"
 #include "statements.hpp"
 
+/// @brief Parsed program owning the arena all its nodes are allocated in
 struct Program {
+    Program() = default;
+
+    Program(Statements statements, LiteralPool literals, std::unique_ptr<Arena> arena)
+        : arena{std::move(arena)},
+          statements{std::move(statements)},
+          literals{std::move(literals)} {}
+
+    Program(Program&&) noexcept = default;
+
+    /// @brief Destroys the current nodes before the arena they live in
+    Program& operator=(Program&& other) noexcept {
+        statements = std::move(other.statements);
+        literals = std::move(other.literals);
+        arena = std::move(other.arena);
+        return *this;
+    }
+
+    /// Declared first, so that it is destroyed after the nodes
+    std::unique_ptr<Arena> arena;
     Statements statements;
+    /// @brief Strings of the string constants of the statements
+    LiteralPool literals;
 };
 
 #endif
@@ -203,14 +203,14 @@ void StatementPrinter::operator()(const VariantDef& stmt) {
                   << std::visit(TypePrinter(indent_ + indentWidth_), type) << '\n';
 }
 
-std::string LValuePrinter::operator()(const std::unique_ptr<FieldAccess>& lvalue) const {
+std::string LValuePrinter::operator()(const NodePtr<FieldAccess>& lvalue) const {
     return getPrefix() + "FieldAcces\n"
            + std::visit(LValuePrinter(indent_ + indentWidth_), lvalue->container) + '\n'
-           + getPrefix() + "  field: " + lvalue->field;
+           + getPrefix() + "  field: " + std::string(lvalue->field.getText());
 }
 
-std::string LValuePrinter::operator()(const std::string& lvalue) const {
-    return getPrefix() + "variable: " + lvalue;
+std::string LValuePrinter::operator()(Symbol lvalue) const {
+    return getPrefix() + "variable: " + std::string(lvalue.getText());
 }
 
 std::string TypePrinter::operator()(const std::string& type) const {
@@ -229,6 +229,10 @@ std::string ValuePrinter::operator()(const std::string& type) const {
     return type;
 }
 
+std::string ValuePrinter::operator()(const SharedString& type) const {
+    return type.getText();
+}
+
 std::string ValuePrinter::operator()(const auto& type) const {
     return std::to_string(type);
 }
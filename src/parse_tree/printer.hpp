@@ -75,8 +75,8 @@ class LValuePrinter : public BasePrinter {
    public:
     using BasePrinter::BasePrinter;
 
-    std::string operator()(const std::unique_ptr<FieldAccess>& lvalue) const;
-    std::string operator()(const std::string& lvalue) const;
+    std::string operator()(const NodePtr<FieldAccess>& lvalue) const;
+    std::string operator()(Symbol lvalue) const;
 };
 
 class TypePrinter : public BasePrinter {
@@ -90,6 +90,7 @@ class TypePrinter : public BasePrinter {
 struct ValuePrinter {
     std::string operator()(const std::monostate&) const;
     std::string operator()(const std::string& type) const;
+    std::string operator()(const SharedString& type) const;
     std::string operator()(const auto& type) const;
 };
 
@@ -1,6 +1,10 @@
 #ifndef STATEMENTS_H
 #define STATEMENTS_H
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+
 #include "expressions.hpp"
 
 struct IfStatement;
@@ -34,7 +38,7 @@ struct Statement : public virtual SyntaxNode {
     virtual void accept(StatementVisitor& vis) const = 0;
 };
 
-using PStatement = std::unique_ptr<Statement>;
+using PStatement = NodePtr<Statement>;
 using Statements = std::vector<PStatement>;
 
 struct ConditionalStatement : public Statement {
@@ -46,6 +50,8 @@ struct ConditionalStatement : public Statement {
 
     PExpression condition;
     Statements statements;
+    /// Whether the type checker proved the condition to be a bool
+    mutable bool checked{false};
 };
 
 struct IfStatement : public ConditionalStatement {
@@ -84,45 +90,118 @@ struct PrintStatement : public Statement {
 
 struct Parameter {
     Type type{""};
-    std::string name;
+    Symbol name;
     bool ref{false};
     Position position;
+    /// Id of the type, assigned by the function definition
+    TypeId typeId{TypeRegistry::NONE};
+    /// Slot of the parameter in the context of the call, see VariableSlot
+    mutable std::uint32_t slot{0};
 };
 
 using Parameters = std::vector<Parameter>;
 
 class FuncDef : public Statement {
    public:
-    FuncDef(const ReturnType& returnType, const std::string& name,
-            const Parameters& parameters, Statements statements, const Position& position)
+    /// @brief Parses the body, allocating its nodes in the given arena
+    using BodyParser = std::function<Statements(Arena&)>;
+
+    FuncDef(const ReturnType& returnType, Symbol name, const Parameters& parameters,
+            Statements statements, const Position& position)
         : SyntaxNode{position},
           returnType_{returnType},
           name_{name},
           parameters_{parameters},
-          statements_{std::move(statements)} {}
+          statements_{std::move(statements)} {
+        assignTypeIds();
+    }
+
+    /// @brief Constructs a function whose body is parsed when it is first needed
+    FuncDef(const ReturnType& returnType, Symbol name, const Parameters& parameters,
+            BodyParser bodyParser, const Position& position)
+        : SyntaxNode{position},
+          returnType_{returnType},
+          name_{name},
+          parameters_{parameters},
+          bodyParser_{std::move(bodyParser)} {
+        assignTypeIds();
+    }
 
     void accept(StatementVisitor& vis) const override { vis(*this); }
 
     const ReturnType& getReturnType() const { return returnType_; }
-    const std::string& getName() const { return name_; }
+    /// @brief Returns the id of the return type, TypeRegistry::NONE for void
+    TypeId getReturnTypeId() const { return returnTypeId_; }
+    Symbol getName() const { return name_; }
     const Parameters& getParameters() const { return parameters_; }
-    const Statements& getStatements() const { return statements_; }
+
+    /// @brief Returns statements of the body, parsing it first if it was deferred.
+    /// Throws syntax errors of the deferred body on every call until it parses
+    const Statements& getStatements() const {
+        if (bodyParser_)
+            parseBody();
+        return statements_;
+    }
+
+    /// @brief Whether the body was not parsed yet
+    bool isBodyDeferred() const { return static_cast<bool>(bodyParser_); }
+
+    /// @brief Variable slots of the function's call context
+    struct Frame {
+        std::uint32_t size{0};
+        /// Id of the name resolution which assigned the slots of the body, 0 if none did
+        std::uint32_t resolution{0};
+        /// For each slot, the slot of the same name in the enclosing contexts, relative
+        /// to the function's context. It is used while the function's own slot is empty
+        std::vector<VariableSlot> outerSlots;
+    };
+
+    const Frame& getFrame() const { return frame_; }
+    void setFrame(Frame frame) const { frame_ = std::move(frame); }
+
+    /// @brief Whether the type checker proved all returned values to be of the return
+    /// type. Whether a non-void function returns at all is still checked at runtime
+    bool areReturnsChecked() const { return returnsChecked_; }
+    void setReturnsChecked(bool checked) const { returnsChecked_ = checked; }
 
    private:
+    void assignTypeIds() {
+        returnTypeId_ = TypeRegistry::getId(returnType_);
+        for (auto& parameter : parameters_)
+            parameter.typeId = TypeRegistry::getId(parameter.type);
+    }
+
+    void parseBody() const {
+        auto arena = std::make_unique<Arena>();
+        statements_ = bodyParser_(*arena);
+        bodyArena_ = std::move(arena);
+        bodyParser_ = nullptr;
+    }
+
     ReturnType returnType_{""};
-    std::string name_;
+    TypeId returnTypeId_{TypeRegistry::NONE};
+    Symbol name_;
     Parameters parameters_;
-    Statements statements_;
+    mutable BodyParser bodyParser_;
+    /// Declared before the statements, so that it outlives their nodes
+    mutable std::unique_ptr<Arena> bodyArena_;
+    mutable Statements statements_;
+    mutable Frame frame_;
+    mutable bool returnsChecked_{false};
 };
 
 struct FieldAccess;
 
 /// @brief Left hand side of the assignment statement
-using LValue = std::variant<std::string, std::unique_ptr<FieldAccess>>;
+using LValue = std::variant<Symbol, NodePtr<FieldAccess>>;
 
 struct FieldAccess {
+    FieldAccess(LValue container, Symbol field)
+        : container{std::move(container)}, field{field} {}
+
     LValue container;
-    std::string field;
+    Symbol field;
+    mutable FieldIndex fieldIndex;
 };
 
 struct Assignment : public Statement {
@@ -133,39 +212,65 @@ struct Assignment : public Statement {
 
     LValue lhs;
     PExpression rhs;
+    /// Slot of the assigned variable, or of the outermost container of the field
+    mutable VariableSlot slot;
+    /// Whether the type checker proved the value to be of the type of the target
+    mutable bool checked{false};
 };
 
 struct VarDef : public Statement {
-    VarDef(bool isConst, Type type, std::string name, PExpression expression,
+    VarDef(bool isConst, Type type, Symbol name, PExpression expression,
            const Position& position)
         : SyntaxNode{position},
           isConst{isConst},
           type{std::move(type)},
-          name{std::move(name)},
+          typeId{TypeRegistry::getId(this->type)},
+          name{name},
           expression{std::move(expression)} {}
 
     void accept(StatementVisitor& vis) const override { vis(*this); }
 
     bool isConst;
     Type type;
-    std::string name;
+    TypeId typeId;
+    Symbol name;
     PExpression expression;
+    /// Slot of the defined variable in the current context
+    mutable std::uint32_t slot{0};
+    /// Whether the type checker proved the value to be of the variable's type
+    mutable bool checked{false};
 };
 
 struct Argument {
     PExpression value;
     bool ref{false};
     Position position;
+    /// Whether the type checker proved the value to be of the parameter's type
+    mutable bool checked{false};
 };
 
 using Arguments = std::vector<Argument>;
 
+class CallContext;
+
+/// @brief Function to which the interpreter last resolved a call
+struct CallTarget {
+    const FuncDef* funcDef{nullptr};
+    /// Context in which the function is defined
+    const CallContext* context{nullptr};
+    /// Number of contexts between the one of the call and the defining one
+    std::uint32_t depth{0};
+    /// Version of the interpreter's visible functions the target was resolved at
+    std::uint64_t version{0};
+};
+
 struct FuncCall : public Expression, public Statement {
-    std::string name;
+    Symbol name;
     Arguments arguments;
+    mutable CallTarget target;
 
-    FuncCall(std::string name, Arguments arguments, const Position& position)
-        : SyntaxNode{position}, name{std::move(name)}, arguments{std::move(arguments)} {}
+    FuncCall(Symbol name, Arguments arguments, const Position& position)
+        : SyntaxNode{position}, name{name}, arguments{std::move(arguments)} {}
 
     void accept(const ExpressionVisitor& vis) const override { vis(*this); }
     void accept(StatementVisitor& vis) const override { vis(*this); }
@@ -173,27 +278,43 @@ struct FuncCall : public Expression, public Statement {
 
 struct Field {
     Type type{""};
-    std::string name;
+    Symbol name;
+    /// Id of the type, assigned by the structure definition
+    TypeId typeId{TypeRegistry::NONE};
 };
 
 struct StructDef : public Statement {
     StructDef(std::string name, std::vector<Field> fields, const Position& position)
-        : SyntaxNode{position}, name{std::move(name)}, fields{std::move(fields)} {}
+        : SyntaxNode{position},
+          name{std::move(name)},
+          fields{std::move(fields)},
+          typeId{TypeRegistry::getNameId(this->name)} {
+        for (auto& field : this->fields)
+            field.typeId = TypeRegistry::getId(field.type);
+    }
 
     void accept(StatementVisitor& vis) const override { vis(*this); }
 
     std::string name;
     std::vector<Field> fields;
+    TypeId typeId;
 };
 
 struct VariantDef : public Statement {
     VariantDef(std::string name, std::vector<Type> types, const Position& position)
-        : SyntaxNode{position}, name{std::move(name)}, types{std::move(types)} {}
+        : SyntaxNode{position},
+          name{std::move(name)},
+          types{std::move(types)},
+          typeId{TypeRegistry::getNameId(this->name)},
+          typeIds{this->types} {}
 
     void accept(StatementVisitor& vis) const override { vis(*this); }
 
     std::string name;
     std::vector<Type> types;
+    TypeId typeId;
+    /// Ids of the types of values the variant can hold
+    TypeSet typeIds;
 };
 
 #endif
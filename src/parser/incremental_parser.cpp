@@ -0,0 +1,238 @@
+#include "incremental_parser.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "lexer.hpp"
+#include "parser.hpp"
+
+namespace {
+/// @brief Moves all nodes of a tree by a number of lines
+///
+/// The nodes are owned by the IncrementalParser, which hands out only const references
+/// to them. They are not const objects, so their positions can be adjusted through the
+/// const references the visitors get.
+class LineShifter : public StatementVisitor, public ExpressionVisitor {
+   public:
+    explicit LineShifter(int lines)
+        : lines_(lines) {}
+
+    void shift(const Statement& statement) { statement.accept(*this); }
+
+    void operator()(const IfStatement& stmt) override { shiftConditional(stmt); }
+    void operator()(const WhileStatement& stmt) override { shiftConditional(stmt); }
+    void operator()(const ReturnStatement& stmt) override {
+        shiftNode(stmt);
+        shiftExpression(stmt.expression);
+    }
+    void operator()(const PrintStatement& stmt) override {
+        shiftNode(stmt);
+        shiftExpression(stmt.expression);
+    }
+    void operator()(const FuncDef& stmt) override {
+        shiftNode(stmt);
+        for (const auto& parameter : stmt.getParameters())
+            shiftPosition(parameter.position);
+        shiftStatements(stmt.getStatements());
+    }
+    void operator()(const Assignment& stmt) override {
+        shiftNode(stmt);
+        shiftExpression(stmt.rhs);
+    }
+    void operator()(const VarDef& stmt) override {
+        shiftNode(stmt);
+        shiftExpression(stmt.expression);
+    }
+    void operator()(const FuncCall& stmt) override {
+        static_cast<const LineShifter&>(*this)(stmt);
+    }
+    void operator()(const StructDef& stmt) override { shiftNode(stmt); }
+    void operator()(const VariantDef& stmt) override { shiftNode(stmt); }
+
+    void operator()(const StructInitExpression& expr) const override {
+        shiftNode(expr);
+        for (const auto& element : expr.exprs)
+            shiftExpression(element);
+    }
+    void operator()(const DisjunctionExpression& expr) const override {
+        shiftBinary(expr);
+    }
+    void operator()(const ConjunctionExpression& expr) const override {
+        shiftBinary(expr);
+    }
+    void operator()(const EqualExpression& expr) const override { shiftBinary(expr); }
+    void operator()(const NotEqualExpression& expr) const override { shiftBinary(expr); }
+    void operator()(const LessThanExpression& expr) const override { shiftBinary(expr); }
+    void operator()(const LessThanOrEqualExpression& expr) const override {
+        shiftBinary(expr);
+    }
+    void operator()(const GreaterThanExpression& expr) const override {
+        shiftBinary(expr);
+    }
+    void operator()(const GreaterThanOrEqualExpression& expr) const override {
+        shiftBinary(expr);
+    }
+    void operator()(const AdditionExpression& expr) const override { shiftBinary(expr); }
+    void operator()(const SubtractionExpression& expr) const override {
+        shiftBinary(expr);
+    }
+    void operator()(const MultiplicationExpression& expr) const override {
+        shiftBinary(expr);
+    }
+    void operator()(const DivisionExpression& expr) const override { shiftBinary(expr); }
+    void operator()(const SignChangeExpression& expr) const override {
+        shiftNode(expr);
+        shiftExpression(expr.expr);
+    }
+    void operator()(const LogicalNegationExpression& expr) const override {
+        shiftNode(expr);
+        shiftExpression(expr.expr);
+    }
+    void operator()(const ConversionExpression& expr) const override {
+        shiftNode(expr);
+        shiftExpression(expr.expr);
+    }
+    void operator()(const TypeCheckExpression& expr) const override {
+        shiftNode(expr);
+        shiftExpression(expr.expr);
+    }
+    void operator()(const FieldAccessExpression& expr) const override {
+        shiftNode(expr);
+        shiftExpression(expr.expr);
+    }
+    void operator()(const Constant& expr) const override { shiftNode(expr); }
+    void operator()(const FuncCall& expr) const override {
+        shiftNode(expr);
+        for (const auto& argument : expr.arguments) {
+            shiftPosition(argument.position);
+            shiftExpression(argument.value);
+        }
+    }
+    void operator()(const VariableAccess& expr) const override { shiftNode(expr); }
+
+   private:
+    void shiftPosition(const Position& position) const {
+        auto& line = const_cast<Position&>(position).line;
+        line = static_cast<unsigned int>(static_cast<int>(line) + lines_);
+    }
+    void shiftNode(const SyntaxNode& node) const { shiftPosition(node.position); }
+
+    void shiftExpression(const PExpression& expr) const {
+        if (expr)
+            expr->accept(*this);
+    }
+    void shiftBinary(const BinaryExpression& expr) const {
+        shiftNode(expr);
+        shiftExpression(expr.lhs);
+        shiftExpression(expr.rhs);
+    }
+
+    void shiftStatements(const Statements& statements) {
+        for (const auto& statement : statements)
+            statement->accept(*this);
+    }
+    void shiftConditional(const ConditionalStatement& stmt) {
+        shiftNode(stmt);
+        shiftExpression(stmt.condition);
+        shiftStatements(stmt.statements);
+    }
+
+    int lines_;
+};
+}  // namespace
+
+IncrementalParser::IncrementalParser(std::string text)
+    : buffer_(std::make_shared<const SourceBuffer>(std::string())) {
+    applyEdit({.insertedText = std::move(text)});
+}
+
+void IncrementalParser::applyEdit(const TextEdit& edit) {
+    const auto oldText = getText();
+    if (edit.offset > oldText.size() || edit.removedLength > oldText.size() - edit.offset)
+        throw std::out_of_range("Edit outside of the text");
+
+    const auto removedEnd = edit.offset + edit.removedLength;
+    const auto insertedEnd = edit.offset + edit.insertedText.size();
+    const auto removedText = oldText.substr(edit.offset, edit.removedLength);
+
+    std::string newText;
+    newText.reserve(oldText.size() - removedText.size() + edit.insertedText.size());
+    newText.append(oldText.substr(0, edit.offset))
+        .append(edit.insertedText)
+        .append(oldText.substr(removedEnd));
+    auto buffer = std::make_shared<const SourceBuffer>(std::move(newText));
+    const auto text = buffer->getText();
+
+    // Text appended to a statement may extend it, so reparsing starts at the last
+    // statement starting before the edit
+    auto first = static_cast<std::size_t>(
+        std::ranges::lower_bound(entries_, edit.offset, {}, &Entry::begin) -
+        entries_.begin());
+    if (first > 0)
+        --first;
+    const auto start = first < entries_.size() && entries_[first].begin <= edit.offset
+                           ? entries_[first].begin
+                           : 0;
+
+    // Nodes take roughly as many bytes as their text
+    const auto arena = std::make_shared<Arena>(std::clamp(
+        edit.insertedText.size(), reparseBlockSize_, Arena::defaultBlockSize));
+    auto source = Source(buffer, start);
+    auto lexer = Lexer(source, Lexer::Comments::SKIP);
+    auto parser = Parser(lexer, Parser::FunctionBodies::EAGER, *arena);
+
+    Statements parsed;
+    std::vector<std::size_t> begins;
+    auto resume = entries_.size();
+    auto next = first;
+    while (true) {
+        const std::size_t offset = parser.getCurrentOffset();
+        // The text after the edit is unchanged, so an old statement starting here
+        // parses the same. Its columns are unchanged only if it starts on a later line
+        if (offset >= insertedEnd) {
+            const auto oldOffset = offset - insertedEnd + removedEnd;
+            while (next < entries_.size() && entries_[next].begin < oldOffset)
+                ++next;
+            if (next < entries_.size() && entries_[next].begin == oldOffset &&
+                text.substr(insertedEnd, offset - insertedEnd).contains('\n')) {
+                resume = next;
+                break;
+            }
+        }
+
+        auto statement = parser.parseTopLevelStatement();
+        if (!statement)
+            break;
+        begins.push_back(offset);
+        parsed.push_back(std::move(statement));
+    }
+
+    const auto lineShift = static_cast<int>(std::ranges::count(edit.insertedText, '\n') -
+                                            std::ranges::count(removedText, '\n'));
+    LineShifter shifter(lineShift);
+    for (auto i{resume}; i < entries_.size(); ++i) {
+        entries_[i].begin = entries_[i].begin - removedEnd + insertedEnd;
+        if (lineShift != 0)
+            shifter.shift(*program_.statements[i]);
+    }
+
+    auto& statements = program_.statements;
+    const auto replacedBegin = statements.begin() + static_cast<std::ptrdiff_t>(first);
+    const auto replacedEnd = statements.begin() + static_cast<std::ptrdiff_t>(resume);
+    statements.erase(replacedBegin, replacedEnd);
+    statements.insert(statements.begin() + static_cast<std::ptrdiff_t>(first),
+                      std::make_move_iterator(parsed.begin()),
+                      std::make_move_iterator(parsed.end()));
+
+    // Erased after the statements, so that the arenas outlive their nodes
+    const auto entriesBegin = entries_.begin() + static_cast<std::ptrdiff_t>(first);
+    entries_.erase(entriesBegin, entries_.begin() + static_cast<std::ptrdiff_t>(resume));
+    std::vector<Entry> added;
+    for (const auto begin : begins)
+        added.push_back({begin, arena});
+    entries_.insert(entries_.begin() + static_cast<std::ptrdiff_t>(first), added.begin(),
+                    added.end());
+
+    buffer_ = std::move(buffer);
+    reparsedCount_ = parsed.size();
+}
@@ -0,0 +1,63 @@
+#ifndef INCREMENTAL_PARSER_H
+#define INCREMENTAL_PARSER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parse_tree.hpp"
+#include "source.hpp"
+
+/// @brief Replacement of a range of the text by another text
+struct TextEdit {
+    std::size_t offset{0};
+    std::size_t removedLength{0};
+    std::string insertedText;
+};
+
+/// @brief Keeps the parse tree of a script up to date with edits of its text
+///
+/// An edit reparses the text from the top level statement it touches until the parser
+/// reaches the start of an old statement lying on a line after the edit. From there the
+/// old statements are reused, only their line numbers are shifted by the number of lines
+/// the edit added or removed. Syntax errors leave the text and the tree unchanged.
+class IncrementalParser {
+   public:
+    /// @brief Parses the whole text
+    /// @param text
+    explicit IncrementalParser(std::string text);
+
+    IncrementalParser(const IncrementalParser&) = delete;
+    IncrementalParser& operator=(const IncrementalParser&) = delete;
+
+    /// @brief Applies the edit to the text and updates the tree accordingly
+    /// @param edit
+    void applyEdit(const TextEdit& edit);
+
+    const Program& getProgram() const { return program_; }
+    std::string_view getText() const { return buffer_->getText(); }
+
+    /// @brief Returns number of top level statements parsed by the last update
+    std::size_t getReparsedCount() const { return reparsedCount_; }
+
+   private:
+    static constexpr std::size_t reparseBlockSize_{4 * 1024};
+
+    /// @brief Top level statement, stored at the same index as its node
+    struct Entry {
+        /// Offset of the first token. The statement owns the text up to the next one
+        std::size_t begin{0};
+        /// Shared by the statements parsed together, released with the last of them
+        std::shared_ptr<Arena> arena;
+    };
+
+    std::shared_ptr<const SourceBuffer> buffer_;
+    /// Declared before the program, so that the arenas outlive the nodes
+    std::vector<Entry> entries_;
+    Program program_;
+    std::size_t reparsedCount_{0};
+};
+
+#endif
@@ -1,21 +1,77 @@
 #include "parser.hpp"
 
+#include "lexer.hpp"
 #include "magic_enum/magic_enum.hpp"
 
-std::optional<BuiltInType> Parser::getCurrentTokenBuiltInType() const {
-    auto name = magic_enum::enum_name(currentToken_.getType());
+/// @brief Maps type keywords to the built-in types they name
+constexpr std::optional<BuiltInType> toBuiltInType(Token::Type type) {
+    switch (type) {
+        case Token::Type::INT_KW:
+            return BuiltInType::INT;
+        case Token::Type::FLOAT_KW:
+            return BuiltInType::FLOAT;
+        case Token::Type::BOOL_KW:
+            return BuiltInType::BOOL;
+        case Token::Type::STR_KW:
+            return BuiltInType::STR;
+        default:
+            return std::nullopt;
+    }
+}
 
-    static constexpr std::size_t suffixSize{3};
-    if (name.size() < suffixSize)
-        return std::nullopt;
+static_assert(toBuiltInType(Token::Type::STR_KW) == BuiltInType::STR);
+static_assert(!toBuiltInType(Token::Type::VOID_KW));
+
+const Parser::BinaryOperator& Parser::getBinaryOperator(Token::Type type) {
+    // Indexed by the token types
+    static constexpr auto binaryOperators = [] {
+        using Operator = BinaryOperator;
+        std::array<Operator, magic_enum::enum_count<Token::Type>()> operators{};
+        const auto add = [&](Token::Type token, Operator op) {
+            operators[static_cast<std::size_t>(token)] = op;
+        };
+
+        const auto& orMessage = "Expected expression after 'or' keyword";
+        const auto& andMessage = "Expected expression after 'and' keyword";
+        const auto& eqMessage = "Expected expression after (not)equal operator";
+        const auto& relMessage = "Expected expression after relation operator";
+        const auto& addMessage = "Expected expression after additive operator";
+        const auto& multMessage = "Expected expression after multiplicative operator";
+
+        using enum Token::Type;
+        add(OR_KW, {1, true, &Operator::make<DisjunctionExpression>, orMessage});
+        add(AND_KW, {2, true, &Operator::make<ConjunctionExpression>, andMessage});
+        add(EQ_OP, {3, false, &Operator::make<EqualExpression>, eqMessage});
+        add(NEQ_OP, {3, false, &Operator::make<NotEqualExpression>, eqMessage});
+        add(LT_OP, {4, false, &Operator::make<LessThanExpression>, relMessage});
+        add(LTE_OP,
+            {4, false, &Operator::make<LessThanOrEqualExpression>, relMessage});
+        add(GT_OP, {4, false, &Operator::make<GreaterThanExpression>, relMessage});
+        add(GTE_OP,
+            {4, false, &Operator::make<GreaterThanOrEqualExpression>, relMessage});
+        add(ADD_OP, {5, true, &Operator::make<AdditionExpression>, addMessage});
+        add(MIN_OP, {5, true, &Operator::make<SubtractionExpression>, addMessage});
+        add(MULT_OP, {6, true, &Operator::make<MultiplicationExpression>, multMessage});
+        add(DIV_OP, {6, true, &Operator::make<DivisionExpression>, multMessage});
+        return operators;
+    }();
+
+    constexpr auto precedence = [](Token::Type token) {
+        return binaryOperators[static_cast<std::size_t>(token)].precedence;
+    };
+    static_assert(precedence(Token::Type::MULT_OP) > precedence(Token::Type::ADD_OP));
+    static_assert(precedence(Token::Type::SEMI) == 0);
+
+    return binaryOperators[static_cast<std::size_t>(type)];
+}
 
-    name.remove_suffix(suffixSize);
-    return magic_enum::enum_cast<BuiltInType>(name);
+std::optional<BuiltInType> Parser::getCurrentTokenBuiltInType() const {
+    return toBuiltInType(currentToken_.getType());
 }
 
 std::optional<Type> Parser::getCurrentTokenType() const {
     if (currentToken_.getType() == Token::Type::ID)
-        return std::get<std::string>(currentToken_.getValue());
+        return std::string(currentToken_.getSymbol().getText());
     return getCurrentTokenBuiltInType();
 }
 
@@ -27,12 +83,90 @@ ReturnType typeToReturnType(const Type& type) {
 Program Parser::parseProgram() {
     auto statements = parseStatements();
     expectEndOfFile();
-    return {.statements = std::move(statements)};
+    return Program(std::move(statements), std::move(literals_), std::move(ownedArena_));
+}
+
+namespace {
+/// @brief Checks whether a statement defines a function, structure or variant, also
+/// in a block at any depth, as values may outlive the block and refer to the definition
+class DefinitionCheck : public StatementVisitor {
+   public:
+    static bool isDefinition(const Statement& statement) {
+        DefinitionCheck check;
+        statement.accept(check);
+        return check.isDefinition_;
+    }
+
+    void operator()(const IfStatement& stmt) override { checkBlock(stmt.statements); }
+    void operator()(const WhileStatement& stmt) override { checkBlock(stmt.statements); }
+    void operator()(const ReturnStatement&) override {}
+    void operator()(const PrintStatement&) override {}
+    void operator()(const FuncDef&) override { isDefinition_ = true; }
+    void operator()(const Assignment&) override {}
+    void operator()(const VarDef&) override {}
+    void operator()(const FuncCall&) override {}
+    void operator()(const StructDef&) override { isDefinition_ = true; }
+    void operator()(const VariantDef&) override { isDefinition_ = true; }
+
+   private:
+    void checkBlock(const Statements& statements) {
+        for (const auto& statement : statements) {
+            if (isDefinition_)
+                return;
+            statement->accept(*this);
+        }
+    }
+
+    bool isDefinition_{false};
+};
+}  // namespace
+
+Program Parser::parseProgram(const StatementHandler& handleStatement) {
+    Statements definitions;
+    while (true) {
+        const auto mark = arena_->getMark();
+        auto statement = parseTopLevelStatement();
+        if (!statement)
+            break;
+
+        handleStatement(*statement);
+        if (DefinitionCheck::isDefinition(*statement)) {
+            definitions.push_back(std::move(statement));
+        } else {
+            statement.reset();
+            arena_->rewind(mark);
+        }
+    }
+    return Program(std::move(definitions), std::move(literals_), std::move(ownedArena_));
+}
+
+PStatement Parser::parseTopLevelStatement() {
+    auto statement = parseStatement();
+    if (!statement)
+        expectEndOfFile();
+    return statement;
+}
+
+void Parser::refillTokens() {
+    nextToken_ = 0;
+    bufferedTokens_ = lexer_.getCompactTokens(tokens_);
+}
+
+Symbol Parser::expectSymbol(const char* message) {
+    if (currentToken_.getType() != Token::Type::ID)
+        throwSyntaxException(message);
+    const auto symbol = currentToken_.getSymbol();
+    consumeToken();
+    return symbol;
+}
+
+void Parser::throwSyntaxException(const char* message) const {
+    throw SyntaxException(getCurrentPosition(), message);
 }
 
 void Parser::expectEndOfFile() const {
     if (currentToken_.getType() != Token::Type::ETX)
-        throw SyntaxException(currentToken_.getPosition(), "Unknown statement");
+        throw SyntaxException(getCurrentPosition(), "Unknown statement");
 }
 
 /// STMTS = { STMT }
@@ -55,16 +189,43 @@ Statements Parser::parseStatements() {
 ///      | VNT_DEF
 PStatement Parser::parseStatement() {
     auto prevPosition = statementPosition_;
-    statementPosition_ = currentToken_.getPosition();
+    statementPosition_ = getCurrentPosition();
 
-    for (const auto& parser : statementParsers_) {
-        if (auto statement = parser(*this)) {
-            statementPosition_ = prevPosition;
-            return statement;
-        }
-    }
+    auto statement = parseStatementStartingWithCurrentToken();
     statementPosition_ = prevPosition;
-    return nullptr;
+    return statement;
+}
+
+/// @brief Selects the statement parser by the first token of the statement, so that
+/// only one of them is tried
+PStatement Parser::parseStatementStartingWithCurrentToken() {
+    switch (currentToken_.getType()) {
+        case Token::Type::IF_KW:
+            return parseIfStatement();
+        case Token::Type::WHILE_KW:
+            return parseWhileStatement();
+        case Token::Type::RETURN_KW:
+            return parseReturnStatement();
+        case Token::Type::PRINT_KW:
+            return parsePrintStatement();
+        case Token::Type::CONST_KW:
+            return parseConstVarDef();
+        case Token::Type::VOID_KW:
+            return parseVoidFunc();
+        case Token::Type::ID:
+            return parseDefOrAssignment();
+        case Token::Type::INT_KW:
+        case Token::Type::FLOAT_KW:
+        case Token::Type::BOOL_KW:
+        case Token::Type::STR_KW:
+            return parseBuiltInDef();
+        case Token::Type::STRUCT_KW:
+            return parseStructDef();
+        case Token::Type::VARIANT_KW:
+            return parseVariantDef();
+        default:
+            return nullptr;
+    }
 }
 
 /// IF_STMT = if DISJ '{' STMTS '}'
@@ -73,21 +234,19 @@ PStatement Parser::parseIfStatement() {
         return nullptr;
     consumeToken();
 
-    auto condition = parseDisjunctionExpression();
+    auto condition = parseBinaryExpression();
     if (!condition)
-        throw SyntaxException(currentToken_.getPosition(),
+        throw SyntaxException(getCurrentPosition(),
                               "Expected if-statement condition");
 
-    expect(Token::Type::L_C_BR,
-           SyntaxException(currentToken_.getPosition(), "Missing left curly brace"));
+    expect(Token::Type::L_C_BR, "Missing left curly brace");
 
     auto statements = parseStatements();
 
-    expect(Token::Type::R_C_BR,
-           SyntaxException(currentToken_.getPosition(), "Missing right curly brace"));
+    expect(Token::Type::R_C_BR, "Missing right curly brace");
 
-    return std::make_unique<IfStatement>(std::move(condition), std::move(statements),
-                                         statementPosition_);
+    return makeNode<IfStatement>(std::move(condition), std::move(statements),
+                                 statementPosition_);
 }
 
 /// WHILE_STMT = while DISJ '{' STMTS '}'
@@ -96,21 +255,19 @@ PStatement Parser::parseWhileStatement() {
         return nullptr;
     consumeToken();
 
-    auto condition = parseDisjunctionExpression();
+    auto condition = parseBinaryExpression();
     if (!condition)
-        throw SyntaxException(currentToken_.getPosition(),
+        throw SyntaxException(getCurrentPosition(),
                               "Expected while-statement condition");
 
-    expect(Token::Type::L_C_BR,
-           SyntaxException(currentToken_.getPosition(), "Missing left curly brace"));
+    expect(Token::Type::L_C_BR, "Missing left curly brace");
 
     auto statements = parseStatements();
 
-    expect(Token::Type::R_C_BR,
-           SyntaxException(currentToken_.getPosition(), "Missing right curly brace"));
+    expect(Token::Type::R_C_BR, "Missing right curly brace");
 
-    return std::make_unique<WhileStatement>(std::move(condition), std::move(statements),
-                                            statementPosition_);
+    return makeNode<WhileStatement>(std::move(condition), std::move(statements),
+                                    statementPosition_);
 }
 
 /// RET_STMT = return [ EXPR ] ';'
@@ -121,11 +278,9 @@ PStatement Parser::parseReturnStatement() {
 
     auto expression = parseExpression();
 
-    expect(Token::Type::SEMI,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing semicolon after return statement"));
+    expect(Token::Type::SEMI, "Missing semicolon after return statement");
 
-    return std::make_unique<ReturnStatement>(std::move(expression), statementPosition_);
+    return makeNode<ReturnStatement>(std::move(expression), statementPosition_);
 }
 
 /// PRINT_STMT = print [ EXPR ] ';'
@@ -136,32 +291,29 @@ PStatement Parser::parsePrintStatement() {
 
     auto expression = parseExpression();
 
-    expect(Token::Type::SEMI, SyntaxException(currentToken_.getPosition(),
-                                              "Missing semicolon after print statement"));
+    expect(Token::Type::SEMI, "Missing semicolon after print statement");
 
-    return std::make_unique<PrintStatement>(std::move(expression), statementPosition_);
+    return makeNode<PrintStatement>(std::move(expression), statementPosition_);
 }
 
 /// CONST_VAR_DEF = const TYPE ID ASGN
 PStatement Parser::parseConstVarDef() {
     if (currentToken_.getType() != Token::Type::CONST_KW)
         return nullptr;
-    const auto position = currentToken_.getPosition();
+    const auto position = getCurrentPosition();
     consumeToken();
 
     const auto type = getCurrentTokenType();
     if (!type)
-        throw SyntaxException(currentToken_.getPosition(), "Expected variable type");
+        throw SyntaxException(getCurrentPosition(), "Expected variable type");
     consumeToken();
 
-    auto name = expectAndReturnValue<std::string>(
-        Token::Type::ID,
-        SyntaxException(currentToken_.getPosition(), "Expected variable name"));
+    auto name = expectSymbol("Expected variable name");
 
     auto assignment = parseAssignment(name);
 
-    return std::make_unique<VarDef>(true, *type, std::move(name),
-                                    std::move(assignment->rhs), std::move(position));
+    return makeNode<VarDef>(true, *type, std::move(name), std::move(assignment->rhs),
+                            std::move(position));
 }
 
 /// VOID_FUNC = void ID FUNC_DEF
@@ -170,9 +322,7 @@ PStatement Parser::parseVoidFunc() {
         return nullptr;
     consumeToken();
 
-    const auto name = expectAndReturnValue<std::string>(
-        Token::Type::ID,
-        SyntaxException(currentToken_.getPosition(), "Expected function name"));
+    const auto name = expectSymbol("Expected function name");
 
     return parseFuncDef(VoidType(), name);
 }
@@ -184,53 +334,47 @@ PStatement Parser::parseDefOrAssignment() {
     if (currentToken_.getType() != Token::Type::ID)
         return nullptr;
 
-    auto name = std::get<std::string>(currentToken_.getValue());
+    auto name = currentToken_.getSymbol();
     consumeToken();
 
-    if (auto def = parseDef(name))
-        return def;
+    // Checked before parseDef to build the type name only for definitions
+    if (currentToken_.getType() == Token::Type::ID)
+        return parseDef(std::string(name.getText()));
     if (auto funcCall = parseFuncCall(name)) {
-        expect(Token::Type::SEMI,
-               SyntaxException(currentToken_.getPosition(),
-                               "Missing semicolon after function call"));
+        expect(Token::Type::SEMI, "Missing semicolon after function call");
         return funcCall;
     }
     return parseFieldAssignment(name);
 }
 
 /// FIELD_ASGN = { '.' ID } ASGN
-PStatement Parser::parseFieldAssignment(const std::string& name) {
+PStatement Parser::parseFieldAssignment(Symbol name) {
     LValue lvalue{name};
 
     while (currentToken_.getType() == Token::Type::DOT) {
         consumeToken();
 
-        auto field = expectAndReturnValue<std::string>(
-            Token::Type::ID, SyntaxException(currentToken_.getPosition(),
-                                             "Expected field name after dot operator"));
+        auto field = expectSymbol("Expected field name after dot operator");
 
-        lvalue = std::unique_ptr<FieldAccess>(
-            new FieldAccess{.container = std::move(lvalue), .field = std::move(field)});
+        lvalue = makeNode<FieldAccess>(std::move(lvalue), field);
     }
 
     return parseAssignment(std::move(lvalue));
 }
 
 /// ASGN = '=' EXPR ';'
-std::unique_ptr<Assignment> Parser::parseAssignment(LValue lvalue) {
-    expect(Token::Type::ASGN_OP,
-           SyntaxException(currentToken_.getPosition(), "Expected assignment operator"));
+NodePtr<Assignment> Parser::parseAssignment(LValue lvalue) {
+    expect(Token::Type::ASGN_OP, "Expected assignment operator");
 
     auto expression = parseExpression();
     if (!expression)
-        throw SyntaxException(currentToken_.getPosition(),
+        throw SyntaxException(getCurrentPosition(),
                               "Expected expression after assignment");
 
-    expect(Token::Type::SEMI,
-           SyntaxException(currentToken_.getPosition(), "Missing semicolon"));
+    expect(Token::Type::SEMI, "Missing semicolon");
 
-    return std::make_unique<Assignment>(std::move(lvalue), std::move(expression),
-                                        statementPosition_);
+    return makeNode<Assignment>(std::move(lvalue), std::move(expression),
+                                statementPosition_);
 }
 
 /// BUILT_IN_DEF = BUILT_IN_TYPE DEF
@@ -247,44 +391,69 @@ PStatement Parser::parseBuiltInDef() {
 PStatement Parser::parseDef(const Type& type) {
     if (currentToken_.getType() != Token::Type::ID)
         return nullptr;
-    const auto name = std::get<std::string>(currentToken_.getValue());
+    const auto name = currentToken_.getSymbol();
     consumeToken();
 
     const auto returnType = typeToReturnType(type);
     if (auto def = parseFuncDef(returnType, name))
         return def;
     auto assignment = parseAssignment(name);
-    return std::make_unique<VarDef>(false, type, std::get<std::string>(assignment->lhs),
-                                    std::move(assignment->rhs), statementPosition_);
+    return makeNode<VarDef>(false, type, std::get<Symbol>(assignment->lhs),
+                            std::move(assignment->rhs), statementPosition_);
 }
 
 /// FUNC_DEF = '(' PARAMS ')' '{' STMTS '}'
-PStatement Parser::parseFuncDef(const ReturnType& returnType, const std::string& name) {
+PStatement Parser::parseFuncDef(const ReturnType& returnType, Symbol name) {
     if (currentToken_.getType() != Token::Type::L_PAR)
         return nullptr;
     consumeToken();
 
     auto parameters = parseList<Parameter>(&Parser::parseParameter);
 
-    expect(Token::Type::R_PAR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing right parenthesis after function parameter list"));
-    expect(Token::Type::L_C_BR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing left curly brace before function body"));
+    expect(Token::Type::R_PAR, "Missing right parenthesis after function parameter list");
+    expect(Token::Type::L_C_BR, "Missing left curly brace before function body");
 
+    if (functionBodies_ == FunctionBodies::LAZY && tokenTable_.getBuffer()) {
+        return makeNode<FuncDef>(returnType, name, std::move(parameters), skipFuncBody(),
+                                 statementPosition_);
+    }
+    return makeNode<FuncDef>(returnType, name, std::move(parameters), parseFuncBody(),
+                             statementPosition_);
+}
+
+/// @brief Parses statements of a function body and its closing brace
+Statements Parser::parseFuncBody() {
     auto statements = parseStatements();
 
-    expect(Token::Type::R_C_BR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing right curly brace after function body"));
-    return std::make_unique<FuncDef>(returnType, name, std::move(parameters),
-                                     std::move(statements), statementPosition_);
+    expect(Token::Type::R_C_BR, "Missing right curly brace after function body");
+    return statements;
+}
+
+/// @brief Skips a function body by matching braces only
+/// @return Parser of the body, lexing it again from the source
+FuncDef::BodyParser Parser::skipFuncBody() {
+    const auto bodyOffset = currentToken_.getOffset();
+
+    std::size_t depth{0};
+    while (currentToken_.getType() != Token::Type::ETX) {
+        if (currentToken_.getType() == Token::Type::L_C_BR)
+            ++depth;
+        else if (currentToken_.getType() == Token::Type::R_C_BR && depth-- == 0)
+            break;
+        consumeToken();
+    }
+    expect(Token::Type::R_C_BR, "Missing right curly brace after function body");
+
+    return [buffer = tokenTable_.getBuffer(), bodyOffset](Arena& arena) {
+        auto source = Source(buffer, bodyOffset);
+        Lexer lexer(source, Lexer::Comments::SKIP);
+        return Parser(lexer, FunctionBodies::LAZY, arena).parseFuncBody();
+    };
 }
 
 /// PARAM = [ ref ] TYPE ID
 std::optional<Parameter> Parser::parseParameter() {
-    const auto position = currentToken_.getPosition();
+    const auto position = getCurrentPosition();
 
     const bool ref{currentToken_.getType() == Token::Type::REF_KW};
     if (ref)
@@ -293,31 +462,27 @@ std::optional<Parameter> Parser::parseParameter() {
     const auto type = getCurrentTokenType();
     if (!type) {
         if (ref)
-            throw SyntaxException(currentToken_.getPosition(),
+            throw SyntaxException(getCurrentPosition(),
                                   "Expected parameter type after ref keyword");
         return std::nullopt;
     }
     consumeToken();
 
-    const auto name = expectAndReturnValue<std::string>(
-        Token::Type::ID,
-        SyntaxException(currentToken_.getPosition(), "Expected parameter name"));
+    const auto name = expectSymbol("Expected parameter name");
 
     return Parameter{.type = *type, .name = name, .ref = ref, .position = position};
 }
 
 /// FUNC_CALL = '(' ARGS ')'
-std::unique_ptr<FuncCall> Parser::parseFuncCall(const std::string& name) {
+NodePtr<FuncCall> Parser::parseFuncCall(Symbol name) {
     if (currentToken_.getType() != Token::Type::L_PAR)
         return nullptr;
     consumeToken();
 
     auto arguments = parseList<Argument>(&Parser::parseArgument);
 
-    expect(Token::Type::R_PAR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing right parenthesis after function call arguments"));
-    return std::make_unique<FuncCall>(name, std::move(arguments), statementPosition_);
+    expect(Token::Type::R_PAR, "Missing right parenthesis after function call arguments");
+    return makeNode<FuncCall>(name, std::move(arguments), statementPosition_);
 }
 
 /// STRUCT_DEF = struct ID '{' FIELDS '}'
@@ -326,21 +491,15 @@ PStatement Parser::parseStructDef() {
         return nullptr;
     consumeToken();
 
-    auto name = expectAndReturnValue<std::string>(
-        Token::Type::ID,
-        SyntaxException(currentToken_.getPosition(), "Expected struct name"));
+    auto name = expectSymbol("Expected struct name");
 
-    expect(Token::Type::L_C_BR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing left curly brace in struct difinition"));
+    expect(Token::Type::L_C_BR, "Missing left curly brace in struct difinition");
 
     auto fields = parseList<Field>(&Parser::parseField);
 
-    expect(Token::Type::R_C_BR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing right curly brace in struct difinition"));
-    return std::make_unique<StructDef>(std::move(name), std::move(fields),
-                                       statementPosition_);
+    expect(Token::Type::R_C_BR, "Missing right curly brace in struct difinition");
+    return makeNode<StructDef>(std::string(name.getText()), std::move(fields),
+                               statementPosition_);
 }
 
 /// VNT_DEF = variant ID '{' TYPES '}'
@@ -349,24 +508,18 @@ PStatement Parser::parseVariantDef() {
         return nullptr;
     consumeToken();
 
-    auto name = expectAndReturnValue<std::string>(
-        Token::Type::ID,
-        SyntaxException(currentToken_.getPosition(), "Expected variant name"));
+    auto name = expectSymbol("Expected variant name");
 
-    expect(Token::Type::L_C_BR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing left curly brace in variant difinition"));
+    expect(Token::Type::L_C_BR, "Missing left curly brace in variant difinition");
 
     auto types = parseList<Type>(&Parser::parseType);
     if (types.empty())
-        throw NoTypesInVariant{currentToken_.getPosition()};
+        throw NoTypesInVariant{getCurrentPosition()};
 
-    expect(Token::Type::R_C_BR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Missing right curly brace in variant difinition"));
+    expect(Token::Type::R_C_BR, "Missing right curly brace in variant difinition");
 
-    return std::make_unique<VariantDef>(std::move(name), std::move(types),
-                                        statementPosition_);
+    return makeNode<VariantDef>(std::string(name.getText()), std::move(types),
+                                statementPosition_);
 }
 
 std::optional<Type> Parser::parseType() {
@@ -384,9 +537,7 @@ std::optional<Field> Parser::parseField() {
         return std::nullopt;
     consumeToken();
 
-    auto name = expectAndReturnValue<std::string>(
-        Token::Type::ID,
-        SyntaxException(currentToken_.getPosition(), "Expected field name"));
+    auto name = expectSymbol("Expected field name");
 
     return Field{.type = *type, .name = std::move(name)};
 }
@@ -395,23 +546,21 @@ std::optional<Field> Parser::parseField() {
 PExpression Parser::parseExpression() {
     if (auto expr = parseStructInitExpression())
         return expr;
-    return parseDisjunctionExpression();
+    return parseBinaryExpression();
 }
 
 /// STRUCT_INIT = '{' { EXPRS } '}'
 PExpression Parser::parseStructInitExpression() {
     if (currentToken_.getType() != Token::Type::L_C_BR)
         return nullptr;
-    const auto position = currentToken_.getPosition();
+    const auto position = getCurrentPosition();
     consumeToken();
 
     auto exprs = parseExpressionList();
 
-    expect(
-        Token::Type::R_C_BR,
-        SyntaxException(currentToken_.getPosition(),
-                        "Missing right curly brace at the end of struct initialization"));
-    return std::make_unique<StructInitExpression>(std::move(exprs), position);
+    expect(Token::Type::R_C_BR,
+           "Missing right curly brace at the end of struct initialization");
+    return makeNode<StructInitExpression>(std::move(exprs), position);
 }
 
 /// EXPRS = [ EXPR { ',' EXPR } ]
@@ -428,7 +577,7 @@ std::vector<PExpression> Parser::parseExpressionList() {
         consumeToken();
         expr = parseExpression();
         if (!expr)
-            throw SyntaxException(currentToken_.getPosition(),
+            throw SyntaxException(getCurrentPosition(),
                                   "Expected expression after comma");
         exprs.push_back(std::move(expr));
     }
@@ -436,140 +585,59 @@ std::vector<PExpression> Parser::parseExpressionList() {
 }
 
 /// DISJ = CONJ { or CONJ }
-PExpression Parser::parseDisjunctionExpression() {
-    const auto position = currentToken_.getPosition();
-    PExpression leftLogicFactor = parseConjunctionExpression();
-    if (!leftLogicFactor)
-        return nullptr;
-
-    while (currentToken_.getType() == Token::Type::OR_KW) {
-        consumeToken();
-        auto rightLogicFactor = parseConjunctionExpression();
-        if (!rightLogicFactor)
-            throw SyntaxException(currentToken_.getPosition(),
-                                  "Expected expression after 'or' keyword");
-        leftLogicFactor = std::make_unique<DisjunctionExpression>(
-            std::move(leftLogicFactor), std::move(rightLogicFactor), position);
-    }
-
-    return leftLogicFactor;
-}
-
 /// CONJ = EQ { and EQ }
-PExpression Parser::parseConjunctionExpression() {
-    const auto position = currentToken_.getPosition();
-    auto leftLogicFactor = parseEqualExpression();
-    if (!leftLogicFactor)
-        return nullptr;
-
-    while (currentToken_.getType() == Token::Type::AND_KW) {
-        consumeToken();
-        auto rightLogicFactor = parseEqualExpression();
-        if (!rightLogicFactor)
-            throw SyntaxException(currentToken_.getPosition(),
-                                  "Expected expression after 'and' keyword");
-        leftLogicFactor = std::make_unique<ConjunctionExpression>(
-            std::move(leftLogicFactor), std::move(rightLogicFactor), position);
-    }
-
-    return leftLogicFactor;
-}
-
-/// EQ = REL [ '==' REL ]
-///    | REL [ '!=' REL ]
-PExpression Parser::parseEqualExpression() {
-    const auto position = currentToken_.getPosition();
-    auto leftEqFactor = parseRelExpression();
-    if (!leftEqFactor)
-        return nullptr;
-
-    if (const auto& ctor = ComparisonExpression::getCtor(currentToken_.getType())) {
-        consumeToken();
-        auto rightEqFactor = parseRelExpression();
-        if (!rightEqFactor)
-            throw SyntaxException(currentToken_.getPosition(),
-                                  "Expected expression after (not)equal operator");
-        leftEqFactor =
-            (*ctor)(std::move(leftEqFactor), std::move(rightEqFactor), position);
-    }
-
-    return leftEqFactor;
-}
-
-/// REL = ADD [ '<' ADD ]
-///     | ADD [ '>' ADD ]
-///     | ADD [ '<=' ADD ]
-///     | ADD [ '>=' ADD ]
-PExpression Parser::parseRelExpression() {
-    const auto position = currentToken_.getPosition();
-    auto leftRelFactor = parseAdditiveExpression();
-    if (!leftRelFactor)
-        return nullptr;
-
-    if (const auto& ctor = RelationExpression::getCtor(currentToken_.getType())) {
-        consumeToken();
-        auto rightRelFactor = parseAdditiveExpression();
-        if (!rightRelFactor)
-            throw SyntaxException(currentToken_.getPosition(),
-                                  "Expected expression after relation operator");
-        leftRelFactor =
-            (*ctor)(std::move(leftRelFactor), std::move(rightRelFactor), position);
-    }
-
-    return leftRelFactor;
-}
-
-/// ADD = TERM { '+' TERM }
-///     | TERM { '-' TERM }
-PExpression Parser::parseAdditiveExpression() {
-    const auto position = currentToken_.getPosition();
-    auto leftTerm = parseMultiplicativeExpression();
-    if (!leftTerm)
-        return nullptr;
-
-    while (const auto& ctor = AdditionExpression::getCtor(currentToken_.getType())) {
-        consumeToken();
-        auto rightTerm = parseMultiplicativeExpression();
-        if (!rightTerm)
-            throw SyntaxException(currentToken_.getPosition(),
-                                  "Expected expression after additive operator");
-        leftTerm = (*ctor)(std::move(leftTerm), std::move(rightTerm), position);
-    }
-
-    return leftTerm;
-}
-
+/// EQ   = REL [ '==' REL ]
+///      | REL [ '!=' REL ]
+/// REL  = ADD [ '<' ADD ]
+///      | ADD [ '>' ADD ]
+///      | ADD [ '<=' ADD ]
+///      | ADD [ '>=' ADD ]
+/// ADD  = TERM { '+' TERM }
+///      | TERM { '-' TERM }
 /// TERM = FACTOR { '*' FACTOR }
 ///      | FACTOR { '/' FACTOR }
-PExpression Parser::parseMultiplicativeExpression() {
-    const auto position = currentToken_.getPosition();
-    auto leftFactor = parseNegationExpression();
-    if (!leftFactor)
+///
+/// All levels are parsed by one precedence climbing loop. Operators binding at least as
+/// strongly as minPrecedence are consumed, their right operands are parsed by a
+/// recursive call accepting only stronger operators.
+PExpression Parser::parseBinaryExpression(std::uint8_t minPrecedence) {
+    const auto position = getCurrentPosition();
+    auto lhs = parseNegationExpression();
+    if (!lhs)
         return nullptr;
 
-    while (const auto& ctor =
-               MultiplicativeExpression::getCtor(currentToken_.getType())) {
+    auto lhsPrecedence = BinaryOperator::factorPrecedence;
+    while (true) {
+        const auto& op = getBinaryOperator(currentToken_.getType());
+        if (op.precedence < minPrecedence)
+            break;
+        // Operands of non-associative operators cannot be chained. Once such a chain
+        // stopped a nested call, the operator it left behind binds stronger than lhs
+        if (op.precedence > lhsPrecedence ||
+            (op.precedence == lhsPrecedence && !op.associative))
+            break;
         consumeToken();
-        auto rightFactor = parseNegationExpression();
-        if (!rightFactor)
-            throw SyntaxException(currentToken_.getPosition(),
-                                  "Expected expression after multiplicative operator");
-        leftFactor = (*ctor)(std::move(leftFactor), std::move(rightFactor), position);
+
+        auto rhs = parseBinaryExpression(op.precedence + 1);
+        if (!rhs)
+            throw SyntaxException(getCurrentPosition(), op.missingOperandMessage);
+        lhs = op.ctor(*arena_, std::move(lhs), std::move(rhs), position);
+        lhsPrecedence = op.precedence;
     }
 
-    return leftFactor;
+    return lhs;
 }
 
 /// FACTOR = [ '-' | not ] UNARY
 PExpression Parser::parseNegationExpression() {
-    const auto position = currentToken_.getPosition();
+    const auto position = getCurrentPosition();
     const auto& ctor = NegationExpression::getCtor(currentToken_.getType());
     if (ctor)
         consumeToken();
 
     auto expr = parseTypeExpression();
     if (ctor)
-        return (*ctor)(std::move(expr), position);
+        return (*ctor)(*arena_, std::move(expr), position);
     return expr;
 }
 
@@ -581,34 +649,32 @@ PExpression Parser::parseTypeExpression() {
         return nullptr;
 
     if (const auto& ctor = TypeExpression::getCtor(currentToken_.getType())) {
-        const auto position = currentToken_.getPosition();
+        const auto position = getCurrentPosition();
         consumeToken();
 
         auto type = getCurrentTokenType();
         consumeToken();
         if (!type)
-            throw SyntaxException(currentToken_.getPosition(),
+            throw SyntaxException(getCurrentPosition(),
                                   "Expected type after is/as keyword");
 
-        expr = (*ctor)(std::move(expr), *type, position);
+        expr = (*ctor)(*arena_, std::move(expr), *type, position);
     }
     return expr;
 }
 
 /// SRC = CNTNR { '.' ID }
 PExpression Parser::parseFieldAccessExpression() {
-    const auto position = currentToken_.getPosition();
+    const auto position = getCurrentPosition();
     auto expr = parseContainerExpression();
     if (!expr)
         return nullptr;
 
     while (currentToken_.getType() == Token::Type::DOT) {
         consumeToken();
-        auto field = expectAndReturnValue<std::string>(
-            Token::Type::ID, SyntaxException(currentToken_.getPosition(),
-                                             "Expected field name after dot operator"));
-        expr = std::make_unique<FieldAccessExpression>(std::move(expr), std::move(field),
-                                                       position);
+        auto field = expectSymbol("Expected field name after dot operator");
+        expr =
+            makeNode<FieldAccessExpression>(std::move(expr), std::move(field), position);
     }
 
     return expr;
@@ -632,9 +698,7 @@ PExpression Parser::parseNestedExpression() {
 
     auto expr = parseExpression();
 
-    expect(Token::Type::R_PAR,
-           SyntaxException(currentToken_.getPosition(),
-                           "Expected right parenthesis after nested expression"));
+    expect(Token::Type::R_PAR, "Expected right parenthesis after nested expression");
     return expr;
 }
 
@@ -642,6 +706,9 @@ struct TokenValueToConstantValue {
     Constant::Value operator()(const std::monostate&) const {
         throw std::runtime_error("Expected token to have value");
     }
+    Constant::Value operator()(Symbol) const {
+        throw std::runtime_error("Expected token to have constant value");
+    }
     Constant::Value operator()(const auto& v) const { return v; }
 };
 
@@ -649,10 +716,14 @@ PExpression Parser::parseConstant() {
     if (!currentToken_.isConstant())
         return nullptr;
 
-    const auto value = std::visit(TokenValueToConstantValue(), currentToken_.getValue());
-    const auto position = currentToken_.getPosition();
+    // Equal string literals share one string, taken from the token without a copy
+    auto value = currentToken_.hasString()
+                     ? literals_.intern(tokenTable_.getString(currentToken_))
+                     : std::visit(TokenValueToConstantValue(),
+                                  tokenTable_.getValue(currentToken_));
+    const auto position = getCurrentPosition();
     consumeToken();
-    return std::make_unique<Constant>(value, position);
+    return makeNode<Constant>(std::move(value), position);
 }
 
 /// CALL_OR_VAR = ID [ '(' ARGS ')' ]
@@ -660,13 +731,13 @@ PExpression Parser::parseVariableAccessOrFuncCall() {
     if (currentToken_.getType() != Token::Type::ID)
         return nullptr;
 
-    const auto name = std::get<std::string>(currentToken_.getValue());
-    auto position = currentToken_.getPosition();
+    const auto name = currentToken_.getSymbol();
+    auto position = getCurrentPosition();
     consumeToken();
 
     if (auto funcCall = parseFuncCall(name))
         return funcCall;
-    return std::make_unique<VariableAccess>(name, std::move(position));
+    return makeNode<VariableAccess>(name, std::move(position));
 }
 
 /// ARG = [ ref ] EXPR
@@ -675,12 +746,12 @@ std::optional<Argument> Parser::parseArgument() {
     if (ref)
         consumeToken();
 
-    auto argPosition = currentToken_.getPosition();
+    auto argPosition = getCurrentPosition();
 
     auto expr = parseExpression();
     if (!expr) {
         if (ref)
-            throw SyntaxException(currentToken_.getPosition(),
+            throw SyntaxException(getCurrentPosition(),
                                   "Expected function call argument expression");
         return std::nullopt;
     }
@@ -689,15 +760,3 @@ std::optional<Argument> Parser::parseArgument() {
         .value = std::move(expr), .ref = ref, .position = std::move(argPosition)};
 }
 
-Parser::StatementParsers Parser::statementParsers_{
-    [](Parser& p) { return p.parseIfStatement(); },
-    [](Parser& p) { return p.parseWhileStatement(); },
-    [](Parser& p) { return p.parseReturnStatement(); },
-    [](Parser& p) { return p.parsePrintStatement(); },
-    [](Parser& p) { return p.parseConstVarDef(); },
-    [](Parser& p) { return p.parseVoidFunc(); },
-    [](Parser& p) { return p.parseDefOrAssignment(); },
-    [](Parser& p) { return p.parseBuiltInDef(); },
-    [](Parser& p) { return p.parseStructDef(); },
-    [](Parser& p) { return p.parseVariantDef(); },
-};
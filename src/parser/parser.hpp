@@ -1,10 +1,14 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <optional>
 
 #include "ILexer.hpp"
+#include "compact_token.hpp"
 #include "parse_tree.hpp"
 #include "parser_errors.hpp"
 #include "token.hpp"
@@ -12,8 +16,32 @@
 /// @brief Parser building parse tree from tokens
 class Parser {
    public:
-    explicit Parser(ILexer& lexer)
-        : lexer_(lexer) {
+    /// @brief When bodies of function definitions are parsed
+    enum class FunctionBodies {
+        EAGER,
+        /// Only braces are matched while parsing the program. A body is parsed when
+        /// its statements are first requested, e.g. when the function is called, so
+        /// its syntax errors are reported then. Requires tokens lexed from a source,
+        /// bodies are parsed eagerly otherwise
+        LAZY,
+    };
+
+    explicit Parser(ILexer& lexer, FunctionBodies functionBodies = FunctionBodies::EAGER)
+        : lexer_(lexer),
+          tokenTable_(lexer.getTokenTable()),
+          functionBodies_(functionBodies),
+          ownedArena_(std::make_unique<Arena>()),
+          arena_(ownedArena_.get()) {
+        consumeToken();
+    }
+
+    /// @brief Constructs a parser allocating nodes in an arena it does not own, e.g. for
+    /// parts of a program parsed separately, such as deferred function bodies
+    Parser(ILexer& lexer, FunctionBodies functionBodies, Arena& arena)
+        : lexer_(lexer),
+          tokenTable_(lexer.getTokenTable()),
+          functionBodies_(functionBodies),
+          arena_(&arena) {
         consumeToken();
     }
 
@@ -21,23 +49,93 @@ class Parser {
     /// @return Parse tree
     Program parseProgram();
 
-    const Token& getCurrentToken() { return currentToken_; }
+    using StatementHandler = std::function<void(const Statement&)>;
+
+    /// @brief Parses the program one top level statement at a time, handing each to the
+    /// handler as soon as it is parsed, e.g. to execute it
+    ///
+    /// Once the handler returns, the memory of the statement is reused for the next one
+    /// unless it defines a function, structure or variant, also in a nested block, so
+    /// the whole tree is never built. Syntax errors are thrown after the preceding statements were handled.
+    /// @param handleStatement
+    /// @return Program with the top level definitions, which the handler may keep
+    /// referring to
+    Program parseProgram(const StatementHandler& handleStatement);
+
+    /// @brief Parses a single top level statement
+    /// @return Statement or nullptr after the last one
+    PStatement parseTopLevelStatement();
+
+    Token getCurrentToken() const { return tokenTable_.getToken(currentToken_); }
+
+    /// @brief Returns the source offset of the current token, e.g. the start of the next
+    /// top level statement
+    std::uint32_t getCurrentOffset() const { return currentToken_.getOffset(); }
 
    private:
-    void consumeToken() { currentToken_ = lexer_.getToken(); };
+    /// @brief Binary operator of the expression grammar
+    struct BinaryOperator {
+        /// Precedence of operands that are not binary expressions
+        static constexpr std::uint8_t factorPrecedence{
+            std::numeric_limits<std::uint8_t>::max()};
+
+        /// Higher binds stronger, 0 for tokens that are not binary operators
+        std::uint8_t precedence{0};
+        /// Whether chains of operators of this precedence are allowed and grouped from
+        /// the left, e.g. 'a - b - c' but not 'a == b == c'
+        bool associative{false};
+        BinaryExpression::Ctor ctor{nullptr};
+        const char* missingOperandMessage{nullptr};
+
+        template <typename T>
+        static PExpression make(Arena& arena, PExpression lhs, PExpression rhs,
+                                const Position& position) {
+            return BinaryExpression::make<T>(arena, std::move(lhs), std::move(rhs),
+                                             position);
+        }
+    };
+
+    /// @brief Advances to the next token, refilling the token buffer from the lexer when
+    /// all buffered tokens have been consumed
+    void consumeToken() {
+        if (nextToken_ == bufferedTokens_)
+            refillTokens();
+        currentToken_ = tokens_[nextToken_++];
+    }
+    void refillTokens();
+    Position getCurrentPosition() const { return tokenTable_.getPosition(currentToken_); }
     void expectEndOfFile() const;
 
-    template <typename Exception>
-    void expect(Token::Type expected, const Exception& exception);
+    /// @brief Constructs a node in the arena of the parsed program
+    template <typename T, typename... Args>
+    NodePtr<T> makeNode(Args&&... args) {
+        return arena_->make<T>(std::forward<Args>(args)...);
+    }
+
+    /// @brief Consumes the current token if it is of the expected type
+    /// @param expected
+    /// @param message of the SyntaxException thrown otherwise, which is constructed only
+    /// on failure, so that matching tokens cost no allocation
+    void expect(Token::Type expected, const char* message) {
+        if (currentToken_.getType() != expected)
+            throwSyntaxException(message);
+        consumeToken();
+    }
+
+    /// @brief Consumes the current token if it is an identifier
+    /// @param message of the SyntaxException thrown otherwise
+    /// @return Name of the identifier
+    Symbol expectSymbol(const char* message);
 
-    template <typename T, typename Exception>
-    T expectAndReturnValue(Token::Type expected, const Exception& exception);
+    [[noreturn]] void throwSyntaxException(const char* message) const;
 
+    static const BinaryOperator& getBinaryOperator(Token::Type type);
     std::optional<BuiltInType> getCurrentTokenBuiltInType() const;
     std::optional<Type> getCurrentTokenType() const;
 
     Statements parseStatements();
     PStatement parseStatement();
+    PStatement parseStatementStartingWithCurrentToken();
     PStatement parseIfStatement();
     PStatement parseWhileStatement();
     PStatement parseReturnStatement();
@@ -45,25 +143,22 @@ class Parser {
     PStatement parseConstVarDef();
     PStatement parseVoidFunc();
     PStatement parseDefOrAssignment();
-    PStatement parseFieldAssignment(const std::string& name);
-    std::unique_ptr<Assignment> parseAssignment(LValue lvalue);
+    PStatement parseFieldAssignment(Symbol name);
+    NodePtr<Assignment> parseAssignment(LValue lvalue);
     PStatement parseBuiltInDef();
     PStatement parseDef(const Type& type);
-    PStatement parseFuncDef(const ReturnType& returnType, const std::string& name);
+    PStatement parseFuncDef(const ReturnType& returnType, Symbol name);
+    Statements parseFuncBody();
+    FuncDef::BodyParser skipFuncBody();
     std::optional<Parameter> parseParameter();
-    std::unique_ptr<FuncCall> parseFuncCall(const std::string& name);
+    NodePtr<FuncCall> parseFuncCall(Symbol name);
     PStatement parseStructDef();
     std::optional<Field> parseField();
     PStatement parseVariantDef();
     std::optional<Type> parseType();
     PExpression parseExpression();
     PExpression parseStructInitExpression();
-    PExpression parseDisjunctionExpression();
-    PExpression parseConjunctionExpression();
-    PExpression parseEqualExpression();
-    PExpression parseRelExpression();
-    PExpression parseAdditiveExpression();
-    PExpression parseMultiplicativeExpression();
+    PExpression parseBinaryExpression(std::uint8_t minPrecedence = 1);
     PExpression parseNegationExpression();
     PExpression parseTypeExpression();
     PExpression parseFieldAccessExpression();
@@ -77,12 +172,20 @@ class Parser {
     std::vector<T> parseList(ElementParser elementParser);
     std::vector<PExpression> parseExpressionList();
 
-    using StatementParsers = std::initializer_list<std::function<PStatement(Parser&)>>;
-    static StatementParsers statementParsers_;
+    static constexpr std::size_t tokenBufferSize_{64};
 
     ILexer& lexer_;
-    Token currentToken_;
+    const TokenTable& tokenTable_;
+    FunctionBodies functionBodies_;
+    std::array<CompactToken, tokenBufferSize_> tokens_;
+    std::size_t nextToken_{0};
+    std::size_t bufferedTokens_{0};
+    CompactToken currentToken_;
     Position statementPosition_;
+    /// Null for parsers of deferred function bodies
+    std::unique_ptr<Arena> ownedArena_;
+    Arena* arena_;
+    LiteralPool literals_;
 };
 
 #include "parser.tpp"
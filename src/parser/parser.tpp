@@ -1,22 +1,9 @@
 #ifndef PARSER_TPP
 #define PARSER_TPP
 
-#include "parser.hpp"
-
-template <typename Exception>
-void Parser::expect(Token::Type expected, const Exception& exception) {
-    if (currentToken_.getType() != expected)
-        throw exception;
-
-    consumeToken();
-}
+#include <functional>
 
-template <typename T, typename Exception>
-T Parser::expectAndReturnValue(Token::Type expected, const Exception& exception) {
-    const auto value = currentToken_.getValue();
-    expect(expected, exception);
-    return std::get<T>(value);
-}
+#include "parser.hpp"
 
 /// LIST = [ ELEM { ',' ELEM } ]
 template <typename T, typename ElementParser>
@@ -33,7 +20,7 @@ std::vector<T> Parser::parseList(ElementParser elementParser) {
         consumeToken();
         element = std::invoke(elementParser, this);
         if (!element)
-            throw SyntaxException(currentToken_.getPosition(),
+            throw SyntaxException(getCurrentPosition(),
                                   "Expected element after comma");
         elements.push_back(std::move(*element));
     }
@@ -0,0 +1,32 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/// @brief 64-bit hash of the bytes, mixing 8 bytes at a time. Fast and stable between
+/// runs on the same architecture, but not meant to resist deliberate collisions
+/// @param bytes
+inline std::uint64_t hashBytes(std::string_view bytes) {
+    static constexpr std::uint64_t multiplier{0x9e3779b97f4a7c15};
+    const auto mix = [](std::uint64_t hash, std::uint64_t word) {
+        hash = (hash ^ word) * multiplier;
+        return hash ^ (hash >> 32);
+    };
+
+    std::uint64_t hash{0xcbf29ce484222325 ^ bytes.size()};
+    std::uint64_t word;
+    while (bytes.size() >= sizeof(word)) {
+        std::memcpy(&word, bytes.data(), sizeof(word));
+        hash = mix(hash, word);
+        bytes.remove_prefix(sizeof(word));
+    }
+
+    word = 0;
+    if (!bytes.empty())
+        std::memcpy(&word, bytes.data(), bytes.size());
+    return mix(mix(hash, word), 0);
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef SHARED_STRING_H
+#define SHARED_STRING_H
+
+#include <compare>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/// @brief Immutable string whose characters are shared by all its copies
+///
+/// Copying increments a reference count instead of copying the text, so string values
+/// can be handed out and stored repeatedly, e.g. every time a literal is evaluated.
+class SharedString {
+   public:
+    SharedString() = default;
+
+    SharedString(std::string text)
+        : text_(std::make_shared<const std::string>(std::move(text))) {}
+
+    SharedString(const char* text)
+        : SharedString(std::string(text)) {}
+
+    explicit SharedString(std::string_view text)
+        : SharedString(std::string(text)) {}
+
+    const std::string& getText() const { return text_ ? *text_ : empty_; }
+
+    /// @brief Whether both strings share the same characters
+    /// @param other
+    bool sharesTextWith(const SharedString& other) const { return text_ == other.text_; }
+
+    friend SharedString operator+(const SharedString& lhs, const SharedString& rhs) {
+        return lhs.getText() + rhs.getText();
+    }
+
+    friend bool operator==(const SharedString& lhs, const SharedString& rhs) {
+        return lhs.text_ == rhs.text_ || lhs.getText() == rhs.getText();
+    }
+
+    friend std::strong_ordering operator<=>(const SharedString& lhs,
+                                            const SharedString& rhs) {
+        return lhs.getText() <=> rhs.getText();
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const SharedString& str) {
+        return out << str.getText();
+    }
+
+   private:
+    std::shared_ptr<const std::string> text_;
+
+    static inline const std::string empty_{};
+};
+
+#endif
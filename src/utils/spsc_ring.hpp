@@ -0,0 +1,114 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Bounded lock-free queue passing elements from one producer thread to one
+/// consumer thread
+///
+/// Elements are copied in batches and each batch is published with a single atomic
+/// store. A side blocks (without spinning) only while the ring is full or empty. Either
+/// side may close the ring, which wakes the other one.
+template <typename T>
+class SpscRing {
+   public:
+    /// @param capacity rounded up to a power of two
+    explicit SpscRing(std::size_t capacity)
+        : slots_(std::bit_ceil(std::max<std::size_t>(capacity, 1))),
+          mask_(slots_.size() - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /// @brief Appends the items, waiting while the ring is full. Called by the producer
+    /// @param items
+    /// @return False if the consumer closed the ring, the rest of the items is dropped
+    bool push(std::span<const T> items) {
+        while (!items.empty()) {
+            const auto seen = signal_.load(std::memory_order_acquire);
+            if (closed_.load(std::memory_order_acquire))
+                return false;
+
+            const auto tail = tail_.load(std::memory_order_relaxed);
+            const auto head = head_.load(std::memory_order_acquire);
+            const auto free = slots_.size() - (tail - head);
+            if (free == 0) {
+                signal_.wait(seen, std::memory_order_acquire);
+                continue;
+            }
+
+            const auto count = std::min(free, items.size());
+            for (std::size_t i{0}; i < count; ++i)
+                slots_[(tail + i) & mask_] = items[i];
+            tail_.store(tail + count, std::memory_order_release);
+            notify();
+            items = items.subspan(count);
+        }
+        return true;
+    }
+
+    /// @brief Removes up to items.size() items, waiting while the ring is empty. Called
+    /// by the consumer
+    /// @param items
+    /// @return Number of items removed, 0 only if the ring is empty and closed
+    std::size_t pop(std::span<T> items) {
+        while (true) {
+            const auto seen = signal_.load(std::memory_order_acquire);
+            const auto closed = closed_.load(std::memory_order_acquire);
+
+            const auto head = head_.load(std::memory_order_relaxed);
+            const auto available = tail_.load(std::memory_order_acquire) - head;
+            if (available == 0) {
+                // Items pushed before closing are visible once the closing is
+                if (closed)
+                    return 0;
+                signal_.wait(seen, std::memory_order_acquire);
+                continue;
+            }
+
+            const auto count = std::min(available, items.size());
+            for (std::size_t i{0}; i < count; ++i)
+                items[i] = slots_[(head + i) & mask_];
+            head_.store(head + count, std::memory_order_release);
+            notify();
+            return count;
+        }
+    }
+
+    /// @brief Wakes the other side and makes further pushes fail. Items already pushed
+    /// can still be popped
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        notify();
+    }
+
+    std::size_t capacity() const { return slots_.size(); }
+
+   private:
+    static constexpr std::size_t cacheLineSize{64};
+
+    /// Tells the other side that an index moved or the ring was closed. Both sides never
+    /// wait at the same time, since the ring cannot be full and empty at once
+    void notify() {
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_one();
+    }
+
+    std::vector<T> slots_;
+    std::size_t mask_;
+
+    /// Indices grow without wrapping, slots are indexed modulo the capacity. Each is
+    /// written by one side only, so they live on separate cache lines
+    alignas(cacheLineSize) std::atomic<std::size_t> head_{0};
+    alignas(cacheLineSize) std::atomic<std::size_t> tail_{0};
+    alignas(cacheLineSize) std::atomic<std::uint32_t> signal_{0};
+    std::atomic<bool> closed_{false};
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Process-wide table of interned identifiers
+///
+/// Every distinct text is stored once and never released, so the returned views stay
+/// valid for the lifetime of the program. Safe to use from multiple threads.
+class SymbolTable {
+   public:
+    static SymbolTable& instance() {
+        static SymbolTable table;
+        return table;
+    }
+
+    /// @brief Returns id of the given text, adding the text to the table if needed
+    /// @param text
+    std::uint32_t intern(std::string_view text) {
+        const Key key{text, std::hash<std::string_view>()(text)};
+
+        // Identifiers repeat a lot, so each thread remembers the ones it has already
+        // seen and takes the lock only for the first occurrence
+        thread_local Ids seen;
+        if (const auto it = seen.find(key); it != seen.end())
+            return it->second;
+
+        const auto [stored, id] = internShared(key);
+        seen.emplace(stored, id);
+        return id;
+    }
+
+    std::string_view getText(std::uint32_t id) const {
+        const std::shared_lock lock(mutex_);
+        return texts_[id];
+    }
+
+   private:
+    SymbolTable() { intern(""); }
+
+    /// Text with its hash computed once, before taking the lock
+    struct Key {
+        std::string_view text;
+        std::size_t hash;
+
+        bool operator==(const Key& other) const { return text == other.text; }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const { return key.hash; }
+    };
+
+    using Ids = std::unordered_map<Key, std::uint32_t, KeyHash>;
+
+    /// Returns the key pointing to the stored text along with its id
+    std::pair<Key, std::uint32_t> internShared(const Key& key) {
+        {
+            const std::shared_lock lock(mutex_);
+            if (const auto it = ids_.find(key); it != ids_.end())
+                return *it;
+        }
+
+        const std::unique_lock lock(mutex_);
+        if (const auto it = ids_.find(key); it != ids_.end())
+            return *it;
+
+        const auto id = static_cast<std::uint32_t>(texts_.size());
+        const Key stored{storage_.emplace_back(key.text), key.hash};
+        texts_.push_back(stored.text);
+        ids_.emplace(stored, id);
+        return {stored, id};
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::deque<std::string> storage_;
+    std::vector<std::string_view> texts_;
+    Ids ids_;
+};
+
+/// @brief Interned identifier. Symbols are equal if and only if their texts are equal
+class Symbol {
+   public:
+    /// @brief Constructs an empty symbol
+    Symbol() = default;
+
+    explicit Symbol(std::string_view text)
+        : id_{SymbolTable::instance().intern(text)} {}
+
+    /// @brief Returns the symbol with the given id
+    /// @param id id previously returned by getId()
+    static Symbol fromId(std::uint32_t id) {
+        Symbol symbol;
+        symbol.id_ = id;
+        return symbol;
+    }
+
+    std::uint32_t getId() const { return id_; }
+    std::string_view getText() const { return SymbolTable::instance().getText(id_); }
+
+    friend bool operator==(Symbol lhs, Symbol rhs) = default;
+    friend bool operator==(Symbol lhs, std::string_view rhs) {
+        return lhs.getText() == rhs;
+    }
+
+    friend std::ostream& operator<<(std::ostream& stream, Symbol symbol) {
+        return stream << symbol.getText();
+    }
+
+   private:
+    std::uint32_t id_{0};
+};
+
+template <>
+struct std::hash<Symbol> {
+    std::size_t operator()(Symbol symbol) const { return symbol.getId(); }
+};
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef TYPE_REGISTRY_H
+#define TYPE_REGISTRY_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "types.hpp"
+
+/// @brief Dense integer id of a type
+using TypeId = std::uint32_t;
+
+/// @brief Process-wide registry of type ids
+///
+/// Values of structures and variants match a type by the name of their definition, so
+/// all definitions with the same name share one id. Built-in types take the first ids,
+/// names get the following ones in the order they are first seen and keep them for the
+/// lifetime of the program. Safe to use from multiple threads.
+class TypeRegistry {
+   public:
+    /// @brief Id of no type, e.g. of anonymous structs and of void
+    static constexpr TypeId NONE{0};
+
+    static constexpr TypeId getId(BuiltInType type) {
+        return static_cast<TypeId>(type) + 1;
+    }
+
+    /// @brief Returns the id of the user defined type with the given name, assigning one
+    /// if the name is new
+    /// @param name
+    static TypeId getNameId(std::string_view name) {
+        auto& registry = instance();
+        const std::scoped_lock lock(registry.mutex_);
+        const auto nextId = static_cast<TypeId>(FIRST_NAME_ID + registry.names_.size());
+        const auto [it, inserted] = registry.ids_.try_emplace(std::string(name), nextId);
+        if (inserted)
+            registry.names_.push_back(&it->first);
+        return it->second;
+    }
+
+    static TypeId getId(const Type& type) {
+        if (const auto name = std::get_if<std::string>(&type))
+            return getNameId(*name);
+        return getId(std::get<BuiltInType>(type));
+    }
+
+    /// @brief Returns the id of the return type, NONE for void
+    static TypeId getId(const ReturnType& type) {
+        if (const auto name = std::get_if<std::string>(&type))
+            return getNameId(*name);
+        if (const auto builtIn = std::get_if<BuiltInType>(&type))
+            return getId(*builtIn);
+        return NONE;
+    }
+
+    /// @brief Whether the id is one of a structure or variant name
+    static constexpr bool isUserDefined(TypeId id) { return id >= FIRST_NAME_ID; }
+
+    /// @brief Returns the type with the given id, which must not be NONE
+    /// @param id
+    static Type getType(TypeId id) {
+        if (id < FIRST_NAME_ID)
+            return static_cast<BuiltInType>(id - 1);
+        auto& registry = instance();
+        const std::scoped_lock lock(registry.mutex_);
+        return *registry.names_[id - FIRST_NAME_ID];
+    }
+
+   private:
+    static constexpr TypeId FIRST_NAME_ID{static_cast<TypeId>(BuiltInType::STR) + 2};
+
+    static TypeRegistry& instance() {
+        static TypeRegistry registry;
+        return registry;
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, TypeId> ids_;
+    /// Names indexed by their ids, without the built-in ones
+    std::vector<const std::string*> names_;
+};
+
+/// @brief Set of type ids stored as a bitset
+class TypeSet {
+   public:
+    TypeSet() = default;
+
+    explicit TypeSet(const std::vector<Type>& types) {
+        for (const auto& type : types)
+            insert(TypeRegistry::getId(type));
+    }
+
+    void insert(TypeId id) {
+        if (id / WORD_BITS >= words_.size())
+            words_.resize(id / WORD_BITS + 1);
+        words_[id / WORD_BITS] |= std::uint64_t{1} << id % WORD_BITS;
+    }
+
+    bool contains(TypeId id) const {
+        return id / WORD_BITS < words_.size() &&
+               (words_[id / WORD_BITS] >> id % WORD_BITS & 1) != 0;
+    }
+
+   private:
+    static constexpr TypeId WORD_BITS{64};
+
+    std::vector<std::uint64_t> words_;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include <vector>
 
 #include "ILexer.hpp"
+#include "token_conversion.hpp"
 
 /// @brief FakeLexer implementing the same interface as Lexer. Used for testing
 class FakeLexer : public ILexer {
@@ -29,15 +30,26 @@ class FakeLexer : public ILexer {
     /// @brief Returns token of subsequent type from the sequence. When all token types
     /// are used returns the end-of-text token
     /// @return Token of type from the typeSequence
-    Token getToken() {
+    Token getToken() override {
         if (current_ != tokenSequence_.end())
             return *current_++;
         return Token(default_, {}, {});
     }
 
+    std::size_t getTokens(std::span<Token> tokens) override {
+        return getTokensOneByOne(*this, tokens);
+    }
+    std::size_t getCompactTokens(std::span<CompactToken> tokens) override {
+        return converter_.getCompactTokens(*this, tokens);
+    }
+    const TokenTable& getTokenTable() const override {
+        return converter_.getTokenTable();
+    }
+
    private:
     TypeSequence tokenSequence_;
     TypeSequence::iterator current_;
+    CompactTokenConverter converter_;
 
     static constexpr Token::Type default_ = Token::Type::ETX;
 };
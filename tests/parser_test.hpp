@@ -6,11 +6,12 @@
 
 class ParserTest : public testing::Test {
    protected:
-    void Init(std::string input) {
+    void Init(std::string input,
+              Parser::FunctionBodies functionBodies = Parser::FunctionBodies::EAGER) {
         stream_ = std::istringstream(input);
         source_ = std::make_unique<Source>(stream_);
         lexer_ = std::make_unique<Lexer>(*source_);
-        parser_ = std::make_unique<Parser>(*lexer_);
+        parser_ = std::make_unique<Parser>(*lexer_, functionBodies);
     }
 
     template <typename Exception>
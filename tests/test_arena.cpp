@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+
+#include "arena.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+
+namespace {
+struct Counted {
+    explicit Counted(int& destroyed)
+        : destroyed{destroyed} {}
+    ~Counted() { ++destroyed; }
+
+    int& destroyed;
+};
+
+struct alignas(64) OverAligned {
+    char data[64];
+};
+}  // namespace
+
+TEST(ArenaTest, allocations_are_aligned) {
+    Arena arena(256);
+
+    arena.allocate(1, 1);
+    const auto aligned = arena.allocate(sizeof(double), alignof(double));
+    const auto overAligned = arena.make<OverAligned>();
+
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % alignof(double), 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(overAligned.get()) % 64, 0);
+}
+
+TEST(ArenaTest, nodes_share_blocks) {
+    Arena arena(1024);
+
+    for (int i{0}; i < 16; ++i)
+        arena.allocate(32, 8);
+
+    EXPECT_EQ(arena.getBlockCount(), 1);
+    EXPECT_EQ(arena.getAllocatedBytes(), 16 * 32);
+}
+
+TEST(ArenaTest, large_allocation_gets_own_block) {
+    Arena arena(64);
+
+    const auto memory = static_cast<char*>(arena.allocate(1000, 8));
+    memory[999] = 'x';
+
+    EXPECT_EQ(arena.getBlockCount(), 1);
+    EXPECT_EQ(memory[999], 'x');
+}
+
+TEST(ArenaTest, rewind_reuses_memory) {
+    Arena arena(256);
+    arena.allocate(16, 8);
+    const auto mark = arena.getMark();
+
+    const auto first = arena.allocate(32, 8);
+    arena.allocate(1000, 8);
+    arena.rewind(mark);
+
+    EXPECT_EQ(arena.getBlockCount(), 1);
+    EXPECT_EQ(arena.getAllocatedBytes(), 16);
+    EXPECT_EQ(arena.allocate(32, 8), first);
+}
+
+TEST(ArenaTest, node_pointer_runs_destructor) {
+    Arena arena;
+    int destroyed{0};
+
+    {
+        auto node = arena.make<Counted>(destroyed);
+        EXPECT_EQ(destroyed, 0);
+    }
+
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST(ArenaTest, program_owns_arena_of_its_nodes) {
+    std::istringstream stream("int a = 1 + 2; print a;");
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+    auto parser = Parser(lexer);
+
+    Program program;
+    program = parser.parseProgram();
+
+    ASSERT_TRUE(program.arena);
+    EXPECT_EQ(program.statements.size(), 2);
+    EXPECT_GT(program.arena->getAllocatedBytes(), 0);
+
+    std::istringstream otherStream("print 3;");
+    auto otherSource = Source(otherStream);
+    auto otherLexer = Lexer(otherSource);
+    program = Parser(otherLexer).parseProgram();
+
+    EXPECT_EQ(program.statements.size(), 1);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <sstream>
+
+#include "ast_cache.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "printer.hpp"
+
+namespace {
+constexpr std::string_view source{R"(
+struct Point { int x, int y }
+int norm(Point p) {
+    return p.x * p.x + p.y * p.y;
+}
+Point p = { 3, -4 };
+print "norm: " + norm(p) as str;
+)"};
+
+Program parse(std::string_view text) {
+    std::istringstream stream{std::string(text)};
+    auto sourceReader = Source(stream);
+    auto lexer = Lexer(sourceReader);
+    return Parser(lexer).parseProgram();
+}
+
+std::string print(const Program& program) {
+    testing::internal::CaptureStdout();
+    std::cout << program;
+    return testing::internal::GetCapturedStdout();
+}
+
+class AstCacheTest : public testing::Test {
+   protected:
+    AstCacheTest()
+        : directory_{std::filesystem::temp_directory_path() / "raptor_lang_test"
+                     / testing::UnitTest::GetInstance()->current_test_info()->name()},
+          cache_{directory_} {
+        std::filesystem::remove_all(directory_);
+    }
+
+    ~AstCacheTest() { std::filesystem::remove_all(directory_); }
+
+    std::filesystem::path directory_;
+    AstCache cache_;
+};
+}  // namespace
+
+TEST_F(AstCacheTest, load_misses_before_store) {
+    EXPECT_FALSE(cache_.load(source));
+}
+
+TEST_F(AstCacheTest, load_returns_stored_tree) {
+    const auto program = parse(source);
+
+    ASSERT_TRUE(cache_.store(source, program));
+    const auto loaded = cache_.load(source);
+
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(print(*loaded), print(program));
+}
+
+TEST_F(AstCacheTest, changed_source_misses) {
+    ASSERT_TRUE(cache_.store(source, parse(source)));
+
+    const std::string changed = std::string(source) + "print 1;";
+
+    EXPECT_NE(cache_.getPath(changed), cache_.getPath(source));
+    EXPECT_FALSE(cache_.load(changed));
+}
+
+TEST_F(AstCacheTest, store_leaves_only_the_cached_tree) {
+    ASSERT_TRUE(cache_.store(source, parse(source)));
+    ASSERT_TRUE(cache_.store(source, parse(source)));
+
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_))
+        files.push_back(entry.path());
+
+    ASSERT_EQ(files.size(), 1);
+    EXPECT_EQ(files[0], cache_.getPath(source));
+}
+
+TEST_F(AstCacheTest, damaged_file_misses) {
+    ASSERT_TRUE(cache_.store(source, parse(source)));
+    std::filesystem::resize_file(cache_.getPath(source), 100);
+
+    EXPECT_FALSE(cache_.load(source));
+}
+
+TEST_F(AstCacheTest, entry_of_colliding_source_misses) {
+    // Simulates a hash collision by storing the tree of one source under the name of
+    // another of the same length
+    std::string other(source);
+    other.back() = ' ';
+    ASSERT_TRUE(cache_.store(source, parse(source)));
+    std::filesystem::rename(cache_.getPath(source), cache_.getPath(other));
+
+    EXPECT_FALSE(cache_.load(other));
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "char_scan.hpp"
+
+TEST(CharScanTest, skipWhiteSpace_no_whitespace) {
+    EXPECT_EQ(skipWhiteSpace("abc", 0), 0);
+    EXPECT_EQ(skipWhiteSpace("", 0), 0);
+}
+
+TEST(CharScanTest, skipWhiteSpace_all_kinds) {
+    EXPECT_EQ(skipWhiteSpace(" \t\n\v\f\rx", 0), 6);
+}
+
+TEST(CharScanTest, skipWhiteSpace_ends_at_text_end) {
+    const std::string text(70, ' ');
+
+    EXPECT_EQ(skipWhiteSpace(text, 0), text.size());
+}
+
+TEST(CharScanTest, skipWhiteSpace_every_run_length) {
+    for (std::size_t length{0}; length < 100; ++length) {
+        auto text = std::string(length + 1, '\t') + std::string(40, ' ');
+        text.front() = 'x';
+        text[length + 1] = 'y';
+
+        EXPECT_EQ(skipWhiteSpace(text, 1), length + 1) << "Run length " << length;
+    }
+}
+
+TEST(CharScanTest, skipWhiteSpace_other_control_characters) {
+    EXPECT_EQ(skipWhiteSpace(std::string(20, ' ') + '\b', 0), 20);
+    EXPECT_EQ(skipWhiteSpace(std::string(20, ' ') + '\x0E', 0), 20);
+    EXPECT_EQ(skipWhiteSpace(std::string(20, ' ') + '\xA0', 0), 20);
+}
+
+TEST(CharScanTest, findLineEnd) {
+    for (std::size_t length{0}; length < 100; ++length) {
+        auto text = std::string(length, '#') + std::string(40, 'a');
+        text[length] = '\n';
+
+        EXPECT_EQ(findLineEnd(text, 0), length) << "Line length " << length;
+    }
+}
+
+TEST(CharScanTest, findLineEnd_without_new_line) {
+    const std::string text(50, '#');
+
+    EXPECT_EQ(findLineEnd(text, 3), text.size());
+    EXPECT_EQ(findLineEnd(text, text.size()), text.size());
+}
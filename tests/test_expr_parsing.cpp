@@ -144,6 +144,51 @@ TEST_F(ParserTest, parse_invalid_adjacent_equal_expressions) {
     parseAndExpectThrowAt<SyntaxException>({1, 26});
 }
 
+TEST_F(ParserTest, parse_invalid_adjacent_equal_expressions_in_disjunction) {
+    Init("bool var = a or b == c == d;");
+    parseAndExpectThrowAt<SyntaxException>({1, 24});
+}
+
+TEST_F(ParserTest, parse_invalid_adjacent_rel_expressions) {
+    Init("bool var = 1 < 2 >= 3;");
+    parseAndExpectThrowAt<SyntaxException>({1, 18});
+}
+
+TEST_F(FullyParsedTest, parse_expression_with_mixed_precedence) {
+    Init("bool var = 1 + 2 * 3 - 4 < 5 and true;");
+
+    const auto prog = parser_->parseProgram();
+
+    ASSERT_EQ(prog.statements.size(), 1);
+    const auto varDef = dynamic_cast<VarDef*>(prog.statements.at(0).get());
+    ASSERT_TRUE(varDef);
+
+    const auto conjunction =
+        dynamic_cast<ConjunctionExpression*>(varDef->expression.get());
+    ASSERT_TRUE(conjunction);
+    EXPECT_TRUE(dynamic_cast<Constant*>(conjunction->rhs.get()));
+
+    const auto lessThan = dynamic_cast<LessThanExpression*>(conjunction->lhs.get());
+    ASSERT_TRUE(lessThan);
+    EXPECT_TRUE(dynamic_cast<Constant*>(lessThan->rhs.get()));
+
+    const auto subtraction = dynamic_cast<SubtractionExpression*>(lessThan->lhs.get());
+    ASSERT_TRUE(subtraction);
+    EXPECT_TRUE(dynamic_cast<Constant*>(subtraction->rhs.get()));
+
+    const auto addition = dynamic_cast<AdditionExpression*>(subtraction->lhs.get());
+    ASSERT_TRUE(addition);
+    EXPECT_TRUE(dynamic_cast<Constant*>(addition->lhs.get()));
+
+    const auto multiplication =
+        dynamic_cast<MultiplicationExpression*>(addition->rhs.get());
+    ASSERT_TRUE(multiplication);
+
+    EXPECT_EQ(conjunction->position.column, 12);
+    EXPECT_EQ(addition->position.column, 12);
+    EXPECT_EQ(multiplication->position.column, 16);
+}
+
 TEST_F(FullyParsedTest, parse_not_equal_expression) {
     Init("bool var = true != false;");
 
@@ -496,3 +541,30 @@ TEST_F(FullyParsedTest, parse_struct_init_expr) {
     ASSERT_TRUE(std::holds_alternative<bool>(secondConstant->value));
     EXPECT_FALSE(std::get<bool>(secondConstant->value));
 }
+
+TEST_F(FullyParsedTest, equal_string_constants_share_text) {
+    Init(R"(MyStruct var = {"ab", "a\tb", "ab"};)");
+
+    const auto prog = parser_->parseProgram();
+
+    ASSERT_EQ(prog.statements.size(), 1);
+    const auto varDef = dynamic_cast<VarDef*>(prog.statements.at(0).get());
+    ASSERT_TRUE(varDef);
+    const auto structInitExpr =
+        dynamic_cast<StructInitExpression*>(varDef->expression.get());
+    ASSERT_TRUE(structInitExpr);
+    ASSERT_EQ(structInitExpr->exprs.size(), 3);
+
+    std::vector<SharedString> strings;
+    for (const auto& expr : structInitExpr->exprs) {
+        const auto constant = dynamic_cast<Constant*>(expr.get());
+        ASSERT_TRUE(constant);
+        ASSERT_TRUE(std::holds_alternative<SharedString>(constant->value));
+        strings.push_back(std::get<SharedString>(constant->value));
+    }
+
+    EXPECT_EQ(strings[0], "ab");
+    EXPECT_EQ(strings[1], "a\tb");
+    EXPECT_TRUE(strings[0].sharesTextWith(strings[2]));
+    EXPECT_EQ(prog.literals.size(), 2);
+}
@@ -17,3 +17,29 @@ TEST(FilterTest, forbid_etx_filtering) {
     auto lexer = FakeLexer({Token::Type::ETX});
     EXPECT_THROW(Filter(lexer, Token::Type::ETX), InvalidFilterType);
 }
+
+TEST(FilterTest, batched_filtering) {
+    auto lexer = FakeLexer({Token::Type::CMT, Token::Type::SEMI, Token::Type::CMT,
+                            Token::Type::CMT, Token::Type::DOT});
+    auto filter = Filter(lexer, Token::Type::CMT);
+
+    std::array<Token, 3> tokens;
+
+    ASSERT_EQ(filter.getTokens(tokens), 1);
+    EXPECT_EQ(tokens[0].getType(), Token::Type::SEMI);
+
+    ASSERT_EQ(filter.getTokens(tokens), 2);
+    EXPECT_EQ(tokens[0].getType(), Token::Type::DOT);
+    EXPECT_EQ(tokens[1].getType(), Token::Type::ETX);
+}
+
+TEST(FilterTest, batched_filtering_skips_batches_of_ignored_tokens) {
+    auto lexer = FakeLexer({Token::Type::CMT, Token::Type::CMT, Token::Type::SEMI});
+    auto filter = Filter(lexer, Token::Type::CMT);
+
+    std::array<Token, 2> tokens;
+
+    ASSERT_EQ(filter.getTokens(tokens), 2);
+    EXPECT_EQ(tokens[0].getType(), Token::Type::SEMI);
+    EXPECT_EQ(tokens[1].getType(), Token::Type::ETX);
+}
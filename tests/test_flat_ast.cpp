@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "flat_ast.hpp"
+#include "interpreter.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "printer.hpp"
+
+namespace {
+constexpr auto program = R"(
+struct Point { int x, int y }
+struct Line { Point a, Point b }
+variant Number { int, float }
+
+const float pi = 3.14;
+str greeting = "Hello" + "\n";
+Line l = { { 1, 2 }, { 3, -4 } };
+l.b.y = l.a.x * 2 - 1;
+
+int add(ref int a, int b) {
+    a = a + b;
+    return a;
+}
+
+void show(Number n) {
+    if n is int and not (n as int >= 10) {
+        print n;
+    }
+}
+
+int i = 0;
+while i < 3 or false {
+    i = add(ref i, 1);
+    show(i as Number);
+}
+print (l.b.y / 2 > 0) == true;
+print i != 4;
+print i <= 3;
+print greeting;
+print pi;
+)";
+
+Program parse(std::istringstream& stream) {
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+    return Parser(lexer).parseProgram();
+}
+
+std::string print(const Program& program) {
+    testing::internal::CaptureStdout();
+    std::cout << program;
+    return testing::internal::GetCapturedStdout();
+}
+
+std::string interpret(const Program& program) {
+    std::ostringstream out;
+    Interpreter interpreter(out);
+    interpreter.interpret(program);
+    return out.str();
+}
+}  // namespace
+
+TEST(FlatAstTest, flatten_keeps_statements_and_kinds) {
+    std::istringstream stream("int a = 1 + 2; print a;");
+
+    const auto ast = flatten(parse(stream));
+
+    const auto statements = ast.getStatements();
+    ASSERT_EQ(statements.size(), 2);
+
+    const auto& varDef = ast.getNode(statements[0]);
+    EXPECT_EQ(varDef.kind, NodeKind::VAR_DEF);
+    EXPECT_FALSE(varDef.flag);
+    EXPECT_EQ(Symbol::fromId(varDef.data), "a");
+    EXPECT_EQ(std::get<BuiltInType>(ast.getType(varDef.rhs)), BuiltInType::INT);
+
+    const auto& addition = ast.getNode(varDef.lhs);
+    EXPECT_EQ(addition.kind, NodeKind::ADDITION);
+    EXPECT_EQ(ast.getNode(addition.lhs).kind, NodeKind::INT_CONSTANT);
+    EXPECT_EQ(ast.getNode(addition.rhs).data, 2);
+
+    const auto& print = ast.getNode(statements[1]);
+    EXPECT_EQ(print.kind, NodeKind::PRINT);
+    EXPECT_EQ(ast.getNode(print.lhs).kind, NodeKind::VARIABLE_ACCESS);
+    EXPECT_EQ(ast.getPosition(statements[1]).line, 1);
+    EXPECT_EQ(ast.getPosition(statements[1]).column, 16);
+}
+
+TEST(FlatAstTest, round_trip_prints_the_same_tree) {
+    std::istringstream stream(program);
+    const auto tree = parse(stream);
+
+    const auto rebuilt = unflatten(flatten(tree));
+
+    EXPECT_EQ(print(rebuilt), print(tree));
+}
+
+TEST(FlatAstTest, round_trip_interprets_the_same) {
+    std::istringstream stream(program);
+    const auto tree = parse(stream);
+
+    const auto rebuilt = unflatten(flatten(tree));
+
+    EXPECT_EQ(interpret(rebuilt), interpret(tree));
+}
+
+TEST(FlatAstTest, smaller_than_tree) {
+    std::istringstream stream(program);
+    const auto tree = parse(stream);
+
+    const auto ast = flatten(tree);
+
+    EXPECT_LT(ast.getMemoryUsage(), tree.arena->getAllocatedBytes());
+}
+
+TEST(FlatAstTest, serialization_round_trip_prints_the_same_tree) {
+    std::istringstream stream(program);
+    const auto tree = parse(stream);
+
+    const auto ast = FlatAst::deserialize(flatten(tree).serialize());
+
+    ASSERT_TRUE(ast);
+    EXPECT_EQ(ast->getNodeCount(), flatten(tree).getNodeCount());
+    EXPECT_EQ(print(unflatten(*ast)), print(tree));
+}
+
+TEST(FlatAstTest, serialization_round_trip_of_empty_program) {
+    std::istringstream stream("");
+    const auto tree = parse(stream);
+
+    const auto ast = FlatAst::deserialize(flatten(tree).serialize());
+
+    ASSERT_TRUE(ast);
+    EXPECT_EQ(unflatten(*ast).statements.size(), 0);
+}
+
+TEST(FlatAstTest, equal_trees_serialize_to_equal_bytes) {
+    std::istringstream first(program);
+    std::istringstream second(program);
+
+    EXPECT_EQ(flatten(parse(first)).serialize(), flatten(parse(second)).serialize());
+}
+
+TEST(FlatAstTest, deserialize_rejects_invalid_bytes) {
+    std::istringstream stream(program);
+    const auto bytes = flatten(parse(stream)).serialize();
+
+    auto damaged = bytes;
+    damaged[damaged.size() / 2] ^= 1;
+    auto otherMagic = bytes;
+    otherMagic[0] = 'X';
+
+    EXPECT_FALSE(FlatAst::deserialize(""));
+    EXPECT_FALSE(FlatAst::deserialize(bytes.substr(0, bytes.size() - 1)));
+    EXPECT_FALSE(FlatAst::deserialize(bytes + '\0'));
+    EXPECT_FALSE(FlatAst::deserialize(damaged));
+    EXPECT_FALSE(FlatAst::deserialize(otherMagic));
+}
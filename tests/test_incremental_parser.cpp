@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "base_errors.hpp"
+#include "flat_ast.hpp"
+#include "incremental_parser.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+
+/// Applies edits incrementally and expects the same tree, positions included, as when
+/// the edited text is parsed from scratch
+class IncrementalParserTest : public testing::Test {
+   protected:
+    static constexpr auto program_ =
+        "# leading comment\n"
+        "int a = 1;\n"
+        "struct Point { int x, int y }\n"
+        "int f(ref Point p) {\n"
+        "    while p.x > 0 {\n"
+        "        p.x = p.x - 1;\n"
+        "    }\n"
+        "    return p.y * 2;\n"
+        "}\n"
+        "Point p = {3, 4};\n"
+        "print f(ref p) + a;\n"
+        "if a == 1 { print \"one\"; }\n";
+
+    static std::string parseFromScratch(std::string_view text) {
+        auto source = Source(std::make_shared<const SourceBuffer>(std::string(text)));
+        auto lexer = Lexer(source, Lexer::Comments::SKIP);
+        return flatten(Parser(lexer).parseProgram()).serialize();
+    }
+
+    void Init(std::string text) { parser_ = std::make_unique<IncrementalParser>(text); }
+
+    void edit(std::string_view replaced, std::string inserted) {
+        const auto offset = parser_->getText().find(replaced);
+        ASSERT_NE(offset, std::string_view::npos) << replaced;
+        parser_->applyEdit({offset, replaced.size(), std::move(inserted)});
+        expectSameAsFromScratch();
+    }
+
+    void expectSameAsFromScratch() const {
+        EXPECT_EQ(flatten(parser_->getProgram()).serialize(),
+                  parseFromScratch(parser_->getText()));
+    }
+
+    std::unique_ptr<IncrementalParser> parser_;
+};
+
+TEST_F(IncrementalParserTest, initial_parse) {
+    Init(program_);
+    EXPECT_EQ(parser_->getProgram().statements.size(), 6);
+    EXPECT_EQ(parser_->getReparsedCount(), 6);
+    expectSameAsFromScratch();
+}
+
+TEST_F(IncrementalParserTest, edit_within_line) {
+    Init(program_);
+    edit("{3, 4}", "{30, 4 + a}");
+    EXPECT_EQ(parser_->getReparsedCount(), 1);
+}
+
+TEST_F(IncrementalParserTest, edit_in_function_body) {
+    Init(program_);
+    edit("p.x - 1", "p.x - 2");
+    EXPECT_EQ(parser_->getReparsedCount(), 1);
+}
+
+TEST_F(IncrementalParserTest, inserted_lines_shift_following_statements) {
+    Init(program_);
+    edit("struct Point", "int b = 2;\nprint b;\n\nstruct Point");
+    EXPECT_LE(parser_->getReparsedCount(), 4);
+}
+
+TEST_F(IncrementalParserTest, removed_lines_shift_following_statements) {
+    Init(program_);
+    edit("        p.x = p.x - 1;\n", "");
+    edit("Point p = {3, 4};\n", "");
+    EXPECT_LE(parser_->getReparsedCount(), 2);
+}
+
+TEST_F(IncrementalParserTest, edit_at_start_and_end) {
+    Init(program_);
+    edit("# leading comment\n", "print 0;\n");
+    edit("print \"one\"; }\n", "print \"one\"; }\nprint \"end\";");
+    edit("print 0;", "");
+}
+
+TEST_F(IncrementalParserTest, edit_merging_statements) {
+    Init("print 1;\nprint 2;\nprint 3;\n");
+    edit("1;\nprint", "1 +");
+    EXPECT_EQ(parser_->getProgram().statements.size(), 2);
+}
+
+TEST_F(IncrementalParserTest, edit_joining_lines_of_following_statement) {
+    Init("print 1;\nprint 2;\nprint 3;\n");
+    edit("1;\n", "1; ");
+    edit("2;\n", "2;");
+}
+
+TEST_F(IncrementalParserTest, syntax_error_keeps_previous_tree) {
+    Init(program_);
+    const std::string text(parser_->getText());
+
+    EXPECT_THROW(parser_->applyEdit({text.find("p.y * 2"), 1, "("}), BaseException);
+    EXPECT_THROW(parser_->applyEdit({text.find("int a"), 0, "\""}), BaseException);
+
+    EXPECT_EQ(parser_->getText(), text);
+    expectSameAsFromScratch();
+    edit("int a = 1;", "int a = 2;");
+}
+
+TEST_F(IncrementalParserTest, edit_outside_of_text) {
+    Init("print 1;");
+    EXPECT_THROW(parser_->applyEdit({9, 0, "x"}), std::out_of_range);
+    EXPECT_THROW(parser_->applyEdit({5, 4, ""}), std::out_of_range);
+}
+
+TEST_F(IncrementalParserTest, random_edits) {
+    Init(program_);
+    std::mt19937 random(42);
+    const std::array<std::string, 6> insertions{
+        "print 1;\n", "\n", "int z = 5;", " ", "# comment\n", "void g() {\n}\n"};
+
+    for (int i{0}; i < 300; ++i) {
+        const std::string text(parser_->getText());
+        const auto offset =
+            std::uniform_int_distribution<std::size_t>(0, text.size())(random);
+        const auto removed = std::uniform_int_distribution<std::size_t>(
+            0, std::min<std::size_t>(3, text.size() - offset))(random);
+        const auto& inserted = insertions[random() % insertions.size()];
+        try {
+            parser_->applyEdit({offset, removed, random() % 2 ? inserted : ""});
+        } catch (const BaseException&) {
+            EXPECT_EQ(parser_->getText(), text);
+        }
+        expectSameAsFromScratch();
+    }
+}
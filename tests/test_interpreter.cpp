@@ -5,18 +5,32 @@
 #include "interpreter_errors.hpp"
 #include "lexer.hpp"
 #include "parser.hpp"
+#include "parser_errors.hpp"
 
 class InterpreterTest : public testing::Test {
    protected:
     InterpreterTest()
         : interpreter_{output_} {}
 
-    void Init(const std::string& input) {
+    void Init(const std::string& input,
+              Parser::FunctionBodies functionBodies = Parser::FunctionBodies::EAGER) {
+        createParser(input, functionBodies);
+        program_ = parser_->parseProgram();
+    }
+
+    /// @brief Executes each statement as soon as it is parsed
+    std::string streamAndGetOutput(const std::string& input) {
+        createParser(input, Parser::FunctionBodies::EAGER);
+        program_ = parser_->parseProgram(
+            [this](const Statement& statement) { interpreter_.interpret(statement); });
+        return output_.str();
+    }
+
+    void createParser(const std::string& input, Parser::FunctionBodies functionBodies) {
         stream_ = std::istringstream(input);
         source_ = std::make_unique<Source>(stream_);
         lexer_ = std::make_unique<Lexer>(*source_);
-        parser_ = std::make_unique<Parser>(*lexer_);
-        program_ = parser_->parseProgram();
+        parser_ = std::make_unique<Parser>(*lexer_, functionBodies);
     }
 
     std::string interpretAndGetOutput() {
@@ -102,6 +116,14 @@ TEST_F(InterpreterTest, var_redefinition) {
     interpretAndExpectThrowAt<VariableRedefinition>({2, 1});
 }
 
+TEST_F(InterpreterTest, var_redefinition_after_block_shadowing_it) {
+    Init(
+        "int x = 5;\n"
+        "if true { int x = 7; }\n"
+        "int x = 10;");
+    interpretAndExpectThrowAt<VariableRedefinition>({3, 1});
+}
+
 TEST_F(InterpreterTest, var_def_mismatched_types) {
     Init("int x = true;");
     interpretAndExpectThrowAt<TypeMismatch>({1, 1});
@@ -189,6 +211,32 @@ TEST_F(InterpreterTest, function_shadowing) {
     EXPECT_EQ(interpretAndGetOutput(), "2\n");
 }
 
+TEST_F(InterpreterTest, function_shadowing_in_block_of_caller) {
+    Init(
+        "void fun() { print 1; }"
+        "void call() { fun(); }"
+        "int i = 0;"
+        "while i < 2 {"
+        "    call();"
+        "    void fun() { print 2; }"
+        "    call();"
+        "    i = i + 1;"
+        "}"
+        "call();");
+    EXPECT_EQ(interpretAndGetOutput(), "1\n2\n1\n2\n1\n");
+}
+
+TEST_F(InterpreterTest, nested_function_of_each_activation) {
+    Init(
+        "void outer(int n) {"
+        "    void inner() { print n; }"
+        "    if n < 2 { outer(n + 1); }"
+        "    inner();"
+        "}"
+        "outer(0);");
+    EXPECT_EQ(interpretAndGetOutput(), "2\n1\n0\n");
+}
+
 TEST_F(InterpreterTest, variable_in_parent_context) {
     Init(
         "void parent() {"
@@ -202,6 +250,96 @@ TEST_F(InterpreterTest, variable_in_parent_context) {
     EXPECT_EQ(interpretAndGetOutput(), "24\n");
 }
 
+TEST_F(InterpreterTest, variable_shadowed_after_nested_function) {
+    Init(
+        "int x = 1;"
+        "if true {"
+        "    void h() { print x; }"
+        "    h();"
+        "    int x = 2;"
+        "    h();"
+        "}");
+    EXPECT_EQ(interpretAndGetOutput(), "1\n2\n");
+}
+
+TEST_F(InterpreterTest, variable_defined_in_block_of_caller) {
+    Init(
+        "void h() { print x; }"
+        "if true {"
+        "    int x = 3;"
+        "    h();"
+        "}");
+    EXPECT_EQ(interpretAndGetOutput(), "3\n");
+}
+
+TEST_F(InterpreterTest, shadowed_variable_restored_after_block) {
+    Init(
+        "int x = 1;"
+        "void f() {"
+        "    print x;"
+        "    int x = 2;"
+        "    if true { int x = 3; print x; }"
+        "    print x;"
+        "}"
+        "f();"
+        "print x;");
+    EXPECT_EQ(interpretAndGetOutput(), "1\n3\n2\n1\n");
+}
+
+TEST_F(InterpreterTest, global_variable_defined_after_function) {
+    Init(
+        "void foo() { print x; }"
+        "int x = 3;"
+        "foo();"
+        "x = 4;"
+        "foo();");
+    EXPECT_EQ(interpretAndGetOutput(), "3\n4\n");
+}
+
+TEST_F(InterpreterTest, global_variable_used_before_definition) {
+    Init(
+        "void foo() { print y; }\n"
+        "foo();\n"
+        "int y = 1;");
+    interpretAndExpectThrowAt<SymbolNotFound>({1, 20});
+}
+
+TEST_F(InterpreterTest, variable_of_enclosing_function_in_recursion) {
+    Init(
+        "int sum(int n) {"
+        "    int total = n;"
+        "    void add() { total = total + sum(n - 1); }"
+        "    if n > 0 { add(); }"
+        "    return total;"
+        "}"
+        "print sum(4);");
+    EXPECT_EQ(interpretAndGetOutput(), "10\n");
+}
+
+TEST_F(InterpreterTest, block_variables_defined_in_each_iteration) {
+    Init(
+        "int i = 0;"
+        "while i < 3 {"
+        "    int x = i * 2;"
+        "    print x;"
+        "    i = i + 1;"
+        "}");
+    EXPECT_EQ(interpretAndGetOutput(), "0\n2\n4\n");
+}
+
+TEST_F(InterpreterTest, ref_parameter_shadowed_by_variable) {
+    Init(
+        "void foo(ref int a) {"
+        "    a = 5;"
+        "    int a = 2;"
+        "    print a;"
+        "}"
+        "int x = 1;"
+        "foo(ref x);"
+        "print x;");
+    EXPECT_EQ(interpretAndGetOutput(), "2\n5\n");
+}
+
 TEST_F(InterpreterTest, function_in_parent_context) {
     Init(
         "void parent() {"
@@ -284,6 +422,68 @@ TEST_F(InterpreterTest, function_call_inside_a_function) {
     EXPECT_EQ(interpretAndGetOutput(), "2\n");
 }
 
+TEST_F(InterpreterTest, lazy_function_bodies) {
+    Init(
+        "void parent() {"
+        "    void nested(int a) {"
+        "        print a * 2;"
+        "    }"
+        "    nested(21);"
+        "}"
+        "parent();"
+        "parent();",
+        Parser::FunctionBodies::LAZY);
+    EXPECT_EQ(interpretAndGetOutput(), "42\n42\n");
+}
+
+TEST_F(InterpreterTest, lazy_function_body_error_reported_when_called) {
+    Init(
+        "void broken() {\n"
+        "    print (1;\n"
+        "}\n"
+        "print 1;\n"
+        "broken();",
+        Parser::FunctionBodies::LAZY);
+    interpretAndExpectThrowAt<SyntaxException>({2, 13});
+    EXPECT_EQ(output_.str(), "1\n");
+}
+
+TEST_F(InterpreterTest, streaming_keeps_definitions) {
+    const auto output = streamAndGetOutput(
+        "struct Point { int x, int y }\n"
+        "int twice(int a) { return 2 * a; }\n"
+        "Point p = {twice(1), 3};\n"
+        "if true {\n"
+        "    void local() { print p.x; }\n"
+        "    local();\n"
+        "}\n"
+        "print twice(p.y);\n");
+
+    EXPECT_EQ(output, "2\n6\n");
+    EXPECT_EQ(program_.statements.size(), 3);
+}
+
+TEST_F(InterpreterTest, streaming_keeps_definitions_in_blocks) {
+    const auto output = streamAndGetOutput(
+        "variant Any { int, P }\n"
+        "Any a = 1 as Any;\n"
+        "if true {\n"
+        "    struct P { int x, int y }\n"
+        "    P p = {11, 22};\n"
+        "    a = p as Any;\n"
+        "}\n"
+        "int i = 0;\n"
+        "while i < 100 { int j = (i + 1) * 2 - 3; i = i + 1; }\n"
+        "print a is P;\n");
+
+    EXPECT_EQ(output, "true\n");
+}
+
+TEST_F(InterpreterTest, streaming_executes_statements_before_syntax_error) {
+    EXPECT_THROW(streamAndGetOutput("print 1;\nprint (2;"), SyntaxException);
+    EXPECT_EQ(output_.str(), "1\n");
+}
+
 TEST_F(InterpreterTest, function_not_found) {
     Init("foo(5);");
     interpretAndExpectThrowAt<SymbolNotFound>({1, 1});
@@ -510,6 +710,22 @@ TEST_F(InterpreterTest, field_access_of_invalid_field) {
     interpretAndExpectThrowAt<InvalidField>({3, 7});
 }
 
+TEST_F(InterpreterTest, field_access_of_structs_with_different_field_order) {
+    Init(
+        "void swap(S s) { print s.y; s.y = s.x; print s.y; }"
+        "if true { struct S { int x, int y } swap({1, 2}); }"
+        "if true { struct S { int y, int x } swap({3, 4}); }");
+    EXPECT_EQ(interpretAndGetOutput(), "2\n1\n3\n4\n");
+}
+
+TEST_F(InterpreterTest, field_missing_in_struct_of_later_access) {
+    Init(
+        "void show(S s) { print s.y; }\n"
+        "if true { struct S { int x, int y } show({1, 2}); }\n"
+        "if true { struct S { int x } show({3}); }");
+    interpretAndExpectThrowAt<InvalidField>({1, 24});
+}
+
 TEST_F(InterpreterTest, passing_struct_to_function_by_value) {
     Init(
         "struct MyInteger {"
@@ -749,6 +965,22 @@ TEST_F(InterpreterTest, assignment_of_anonymous_struct_to_variant) {
     interpretAndExpectThrowAt<TypeMismatch>({4, 1});
 }
 
+TEST_F(InterpreterTest, variant_holding_struct_defined_in_function) {
+    Init(
+        "variant V { A, int }"
+        "void f() {"
+        "    struct A { bool b }"
+        "    A a = {true};"
+        "    V v = a;"
+        "    print v is A;"
+        "    print (v as A).b;"
+        "}"
+        "f();"
+        "V w = 3;"
+        "print w is A;");
+    EXPECT_EQ(interpretAndGetOutput(), "true\ntrue\nfalse\n");
+}
+
 TEST_F(InterpreterTest, variant_getting_packed_value) {
     Init(
         "variant V { int, bool }"
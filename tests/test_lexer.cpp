@@ -8,10 +8,11 @@ using TypeSequence = std::vector<Token::Type>;
 
 class LexerTest : public testing::Test {
    protected:
-    void Init(const std::string& input) {
+    void Init(const std::string& input,
+              Lexer::Comments comments = Lexer::Comments::KEEP) {
         stream_ = std::istringstream(input);
         source_ = std::make_unique<Source>(stream_);
-        lexer_ = std::make_unique<Lexer>(*source_);
+        lexer_ = std::make_unique<Lexer>(*source_, comments);
     }
 
     std::istringstream stream_;
@@ -59,7 +60,7 @@ TEST_F(LexerTest, getToken_id) {
     auto token = lexer_->getToken();
 
     ASSERT_EQ(token.getType(), Token::Type::ID) << "Invalid type";
-    EXPECT_EQ(std::get<std::string>(token.getValue()), "valid_identifier_123")
+    EXPECT_EQ(std::get<Symbol>(token.getValue()), "valid_identifier_123")
         << "Invalid value";
 
     EXPECT_EQ(lexer_->getToken().getType(), Token::Type::ETX) << "Invalid type";
@@ -71,7 +72,7 @@ TEST_F(LexerTest, getToken_id_pretending_to_be_keyword) {
     auto token = lexer_->getToken();
 
     ASSERT_EQ(token.getType(), Token::Type::ID) << "Keywords are lowercase only";
-    EXPECT_EQ(std::get<std::string>(token.getValue()), "While") << "Invalid value";
+    EXPECT_EQ(std::get<Symbol>(token.getValue()), "While") << "Invalid value";
 
     EXPECT_EQ(lexer_->getToken().getType(), Token::Type::ETX) << "Invalid type";
 }
@@ -131,20 +132,74 @@ TEST_P(LexerFloatTest, getToken_invalid_float) {
     EXPECT_THROW(lexer_->getToken(), InvalidFloat);
 }
 
-INSTANTIATE_TEST_SUITE_P(InvalidFloat, LexerFloatTest, testing::Values("1..125", "1."));
+INSTANTIATE_TEST_SUITE_P(InvalidFloat, LexerFloatTest,
+                         testing::Values("1..125", "1.", "1e+", "1.5e-", "2E-x"));
 
-TEST_F(LexerTest, getToken_float_max) {
-    Init("0.2147483647");
+TEST_F(LexerTest, getToken_float_long_fraction) {
+    Init("0.21474836481234567890123");
 
-    EXPECT_NO_THROW(lexer_->getToken()) << "Just at the max";
+    auto token = lexer_->getToken();
+
+    ASSERT_EQ(token.getType(), Token::Type::FLOAT_CONST) << "Invalid type";
+    EXPECT_EQ(std::get<float>(token.getValue()), 0.21474836481234567890123f)
+        << "Not correctly rounded";
+}
+
+using LiteralWithValue = std::pair<std::string, float>;
+
+class LexerExponentTest : public LexerTest,
+                          public testing::WithParamInterface<LiteralWithValue> {};
+
+TEST_P(LexerExponentTest, getToken_float_with_exponent) {
+    Init(GetParam().first);
+
+    auto token = lexer_->getToken();
+
+    ASSERT_EQ(token.getType(), Token::Type::FLOAT_CONST) << "Invalid type";
+    EXPECT_EQ(std::get<float>(token.getValue()), GetParam().second) << "Invalid value";
+    EXPECT_EQ(lexer_->getToken().getType(), Token::Type::ETX) << "Invalid type";
+}
+
+INSTANTIATE_TEST_SUITE_P(Exponent, LexerExponentTest,
+                         testing::Values(std::make_pair("1e-6", 1e-6f),
+                                         std::make_pair("1.5E3", 1.5e3f),
+                                         std::make_pair("2e+2", 2e2f),
+                                         std::make_pair("0e7", 0.0f),
+                                         std::make_pair("3.4028235e38", 3.4028235e38f)));
+
+TEST_F(LexerTest, getToken_int_followed_by_identifier_starting_with_e) {
+    Init("1end");
+
+    EXPECT_EQ(lexer_->getToken().getType(), Token::Type::INT_CONST) << "Invalid type";
+    EXPECT_EQ(lexer_->getToken().getType(), Token::Type::ID) << "Invalid type";
 }
 
 TEST_F(LexerTest, getToken_float_overflow) {
-    Init("0.2147483648");
+    Init("1e39");
 
     EXPECT_THROW(lexer_->getToken(), NumericOverflow) << "Max exceeded";
 }
 
+class LexerFloatOverflowTest : public LexerTest,
+                               public testing::WithParamInterface<std::string> {};
+
+TEST_P(LexerFloatOverflowTest, getToken_float_overflow_with_negative_exponent) {
+    Init(GetParam());
+
+    EXPECT_THROW(lexer_->getToken(), NumericOverflow) << "Max exceeded";
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FloatOverflow, LexerFloatOverflowTest,
+    testing::Values("1" + std::string(50, '0') + "e-5", "1e99999999999999999999",
+                    "0.1e40"));
+
+INSTANTIATE_TEST_SUITE_P(Underflow, LexerExponentTest,
+                         testing::Values(std::make_pair("1e-50", 0.0f),
+                                         std::make_pair("0.001e-44", 0.0f),
+                                         std::make_pair("1e-99999999999999999999", 0.0f),
+                                         std::make_pair("1e-40", 1e-40f)));
+
 TEST_F(LexerTest, getToken_invalid) {
     Init("&324");
 
@@ -297,6 +352,60 @@ TEST_F(LexerTest, getToken_end_comment_at_new_line) {
     EXPECT_EQ(std::get<std::string>(token.getValue()), R"( first line)");
 }
 
+TEST_F(LexerTest, getToken_skip_comments) {
+    Init("# first\n  # second\n\t\n int # third", Lexer::Comments::SKIP);
+
+    auto token = lexer_->getToken();
+    ASSERT_EQ(token.getType(), Token::Type::INT_KW) << "Invalid type";
+    EXPECT_EQ(token.getPosition().line, 4);
+    EXPECT_EQ(token.getPosition().column, 2);
+
+    EXPECT_EQ(lexer_->getToken().getType(), Token::Type::ETX) << "Invalid type";
+}
+
+TEST_F(LexerTest, getToken_long_whitespace_run) {
+    Init(std::string(100, ' ') + "\n\t\r\v\f" + std::string(40, ' ') + ';');
+
+    auto token = lexer_->getToken();
+    ASSERT_EQ(token.getType(), Token::Type::SEMI) << "Invalid type";
+    EXPECT_EQ(token.getPosition().line, 2);
+    EXPECT_EQ(token.getPosition().column, 45);
+}
+
+TEST_F(LexerTest, getTokens_stops_after_end_of_text) {
+    Init("a = 1;");
+
+    std::array<Token, 8> tokens;
+
+    ASSERT_EQ(lexer_->getTokens(tokens), 5);
+    EXPECT_EQ(tokens[0].getType(), Token::Type::ID);
+    EXPECT_EQ(tokens[1].getType(), Token::Type::ASGN_OP);
+    EXPECT_EQ(tokens[2].getType(), Token::Type::INT_CONST);
+    EXPECT_EQ(tokens[3].getType(), Token::Type::SEMI);
+    EXPECT_EQ(tokens[4].getType(), Token::Type::ETX);
+}
+
+TEST_F(LexerTest, getTokens_fills_whole_buffer) {
+    Init("a b c");
+
+    std::array<Token, 2> tokens;
+
+    ASSERT_EQ(lexer_->getTokens(tokens), 2);
+    EXPECT_EQ(std::get<Symbol>(tokens[1].getValue()), "b");
+    ASSERT_EQ(lexer_->getTokens(tokens), 2);
+    EXPECT_EQ(std::get<Symbol>(tokens[0].getValue()), "c");
+    EXPECT_EQ(tokens[1].getType(), Token::Type::ETX);
+}
+
+TEST_F(LexerTest, getTokens_defers_error) {
+    Init("a b @ c");
+
+    std::array<Token, 8> tokens;
+
+    ASSERT_EQ(lexer_->getTokens(tokens), 2);
+    EXPECT_THROW(lexer_->getTokens(tokens), InvalidToken);
+}
+
 TEST_F(LexerTest, getToken_token_position_one_line) {
     Init("int void");
 
@@ -340,3 +449,55 @@ TEST_F(LexerTest, getToken_multiple_tokens) {
     for (auto type : seq)
         EXPECT_EQ(lexer_->getToken().getType(), type) << "Invalid type";
 }
+
+TEST_F(LexerTest, getToken_adjacent_operators) {
+    Init("<=>==!=(-)1.5#");
+
+    TypeSequence seq{
+        Token::Type::LTE_OP, Token::Type::GTE_OP,      Token::Type::ASGN_OP,
+        Token::Type::NEQ_OP, Token::Type::L_PAR,       Token::Type::MIN_OP,
+        Token::Type::R_PAR,  Token::Type::FLOAT_CONST, Token::Type::CMT,
+        Token::Type::ETX,
+    };
+
+    for (auto type : seq)
+        EXPECT_EQ(lexer_->getToken().getType(), type) << "Invalid type";
+}
+
+class LexerKeywordTest
+    : public LexerTest,
+      public testing::WithParamInterface<std::pair<std::string, Token::Type>> {};
+
+TEST_P(LexerKeywordTest, getToken_keywords) {
+    auto& [keyword, tokenType] = GetParam();
+    Init(keyword);
+
+    EXPECT_EQ(lexer_->getToken().getType(), tokenType) << "Invalid type";
+    EXPECT_EQ(lexer_->getToken().getType(), Token::Type::ETX) << "Invalid type";
+}
+
+auto keywordPairs = testing::Values(
+    std::make_pair("if", Token::Type::IF_KW),
+    std::make_pair("while", Token::Type::WHILE_KW),
+    std::make_pair("return", Token::Type::RETURN_KW),
+    std::make_pair("print", Token::Type::PRINT_KW),
+    std::make_pair("const", Token::Type::CONST_KW),
+    std::make_pair("ref", Token::Type::REF_KW),
+    std::make_pair("struct", Token::Type::STRUCT_KW),
+    std::make_pair("variant", Token::Type::VARIANT_KW),
+    std::make_pair("or", Token::Type::OR_KW), std::make_pair("and", Token::Type::AND_KW),
+    std::make_pair("not", Token::Type::NOT_KW), std::make_pair("as", Token::Type::AS_KW),
+    std::make_pair("is", Token::Type::IS_KW),
+    std::make_pair("void", Token::Type::VOID_KW),
+    std::make_pair("int", Token::Type::INT_KW),
+    std::make_pair("float", Token::Type::FLOAT_KW),
+    std::make_pair("bool", Token::Type::BOOL_KW),
+    std::make_pair("str", Token::Type::STR_KW),
+    std::make_pair("true", Token::Type::TRUE_CONST),
+    std::make_pair("false", Token::Type::FALSE_CONST),
+    std::make_pair("i", Token::Type::ID), std::make_pair("iff", Token::Type::ID),
+    std::make_pair("whiles", Token::Type::ID), std::make_pair("True", Token::Type::ID),
+    std::make_pair("variants", Token::Type::ID), std::make_pair("if_kw", Token::Type::ID),
+    std::make_pair("id", Token::Type::ID));
+
+INSTANTIATE_TEST_SUITE_P(Keywords, LexerKeywordTest, keywordPairs);
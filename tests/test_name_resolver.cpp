@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include "lexer.hpp"
+#include "name_resolver.hpp"
+#include "parser.hpp"
+
+class NameResolverTest : public testing::Test {
+   protected:
+    void Init(const std::string& input,
+              Parser::FunctionBodies functionBodies = Parser::FunctionBodies::EAGER) {
+        stream_ = std::istringstream(input);
+        source_ = std::make_unique<Source>(stream_);
+        lexer_ = std::make_unique<Lexer>(*source_);
+        program_ = Parser(*lexer_, functionBodies).parseProgram();
+        for (const auto& statement : program_.statements)
+            resolver_.resolve(*statement);
+    }
+
+    template <typename Node>
+    const Node& getStatement(std::size_t index) const {
+        return dynamic_cast<const Node&>(*program_.statements.at(index));
+    }
+
+    template <typename Node>
+    static const Node& getStatement(const FuncDef& funcDef, std::size_t index) {
+        return dynamic_cast<const Node&>(*funcDef.getStatements().at(index));
+    }
+
+    static VariableSlot getPrintedSlot(const Statement& statement) {
+        const auto& print = dynamic_cast<const PrintStatement&>(statement);
+        return dynamic_cast<const VariableAccess&>(*print.expression).slot;
+    }
+
+    static void expectSlot(VariableSlot slot, std::uint32_t depth, std::uint32_t index) {
+        EXPECT_EQ(slot.depth, depth);
+        EXPECT_EQ(slot.index, index);
+    }
+
+    std::istringstream stream_;
+    std::unique_ptr<Source> source_;
+    std::unique_ptr<Lexer> lexer_;
+    Program program_;
+    NameResolver resolver_;
+};
+
+TEST_F(NameResolverTest, global_variables) {
+    Init(
+        "int a = 1;"
+        "int b = 2;"
+        "print b;"
+        "b = a;");
+    EXPECT_EQ(getStatement<VarDef>(0).slot, 0);
+    EXPECT_EQ(getStatement<VarDef>(1).slot, 1);
+    expectSlot(getPrintedSlot(*program_.statements[2]), 0, 1);
+    expectSlot(getStatement<Assignment>(3).slot, 0, 1);
+    EXPECT_EQ(resolver_.getGlobalFrameSize(), 2);
+    EXPECT_EQ(resolver_.getGlobalSlot(Symbol("a")), 0);
+    EXPECT_EQ(resolver_.getGlobalSlot(Symbol("c")), std::nullopt);
+}
+
+TEST_F(NameResolverTest, shadowing_in_block_shares_slot) {
+    Init(
+        "int x = 1;"
+        "if true {"
+        "    print x;"
+        "    int x = 2;"
+        "    print x;"
+        "}");
+    const auto& ifStmt = getStatement<IfStatement>(1);
+    expectSlot(getPrintedSlot(*ifStmt.statements[0]), 0, 0);
+    EXPECT_EQ(dynamic_cast<const VarDef&>(*ifStmt.statements[1]).slot, 0);
+    expectSlot(getPrintedSlot(*ifStmt.statements[2]), 0, 0);
+    EXPECT_EQ(resolver_.getGlobalFrameSize(), 1);
+}
+
+TEST_F(NameResolverTest, redefinition_in_block_shares_slot) {
+    Init(
+        "int x = 1;"
+        "int x = 2;");
+    EXPECT_EQ(getStatement<VarDef>(1).slot, getStatement<VarDef>(0).slot);
+}
+
+TEST_F(NameResolverTest, function_frame) {
+    Init(
+        "int g = 1;"
+        "void f(int p, ref int q) {"
+        "    int b = g;"
+        "    if true { int c = b; print c; }"
+        "    print q;"
+        "}");
+    const auto& funcDef = getStatement<FuncDef>(1);
+    EXPECT_EQ(funcDef.getParameters()[0].slot, 0);
+    EXPECT_EQ(funcDef.getParameters()[1].slot, 1);
+    EXPECT_EQ(funcDef.getFrame().size, 4);
+    EXPECT_TRUE(resolver_.isResolved(funcDef));
+
+    const auto& varDef = getStatement<VarDef>(funcDef, 0);
+    EXPECT_EQ(varDef.slot, 2);
+    expectSlot(dynamic_cast<const VariableAccess&>(*varDef.expression).slot, 1, 0);
+    const auto& ifStmt = getStatement<IfStatement>(funcDef, 1);
+    expectSlot(getPrintedSlot(*ifStmt.statements[1]), 0, 3);
+    expectSlot(getPrintedSlot(*funcDef.getStatements()[2]), 0, 1);
+}
+
+TEST_F(NameResolverTest, body_sees_variables_defined_after_function) {
+    Init(
+        "void outer() {"
+        "    void inner() { print x; }"
+        "    int x = 1;"
+        "}");
+    const auto& outer = getStatement<FuncDef>(0);
+    const auto& inner = getStatement<FuncDef>(outer, 0);
+    expectSlot(getPrintedSlot(*inner.getStatements()[0]), 1, 0);
+    EXPECT_EQ(inner.getFrame().size, 0);
+}
+
+TEST_F(NameResolverTest, reference_parameter_shadowed_by_variable) {
+    Init("void f(ref int a) { int a = 1; print a; }");
+    const auto& funcDef = getStatement<FuncDef>(0);
+    EXPECT_EQ(getStatement<VarDef>(funcDef, 0).slot, 0);
+    expectSlot(getPrintedSlot(*funcDef.getStatements()[1]), 0, 0);
+    EXPECT_EQ(funcDef.getFrame().size, 1);
+}
+
+TEST_F(NameResolverTest, slot_falls_back_to_enclosing_function) {
+    Init(
+        "int x = 1;"
+        "void f() {"
+        "    print x;"
+        "    void g() { print x; }"
+        "    int x = 2;"
+        "}");
+    const auto& funcDef = getStatement<FuncDef>(1);
+    expectSlot(getPrintedSlot(*funcDef.getStatements()[0]), 0, 0);
+    ASSERT_EQ(funcDef.getFrame().outerSlots.size(), 1);
+    expectSlot(funcDef.getFrame().outerSlots[0], 1, 0);
+
+    const auto& nested = getStatement<FuncDef>(funcDef, 1);
+    expectSlot(getPrintedSlot(*nested.getStatements()[0]), 1, 0);
+    EXPECT_TRUE(nested.getFrame().outerSlots.empty());
+}
+
+TEST_F(NameResolverTest, function_in_block_resolved_when_defined) {
+    Init("if true { void f() { print x; } }");
+    const auto& ifStmt = getStatement<IfStatement>(0);
+    const auto& funcDef = dynamic_cast<const FuncDef&>(*ifStmt.statements[0]);
+    EXPECT_TRUE(resolver_.isResolved(funcDef));
+}
+
+TEST_F(NameResolverTest, undefined_name_takes_global_slot) {
+    Init(
+        "void f() { print y; }"
+        "int x = 1;"
+        "int y = 2;");
+    const auto& funcDef = getStatement<FuncDef>(0);
+    expectSlot(getPrintedSlot(*funcDef.getStatements()[0]), 1, 0);
+    EXPECT_EQ(getStatement<VarDef>(1).slot, 1);
+    EXPECT_EQ(getStatement<VarDef>(2).slot, 0);
+}
+
+TEST_F(NameResolverTest, deferred_body_resolved_on_request) {
+    Init(
+        "int x = 1;"
+        "void f() { print x; }",
+        Parser::FunctionBodies::LAZY);
+    const auto& funcDef = getStatement<FuncDef>(1);
+    EXPECT_FALSE(resolver_.isResolved(funcDef));
+
+    resolver_.resolveBody(funcDef);
+    EXPECT_TRUE(resolver_.isResolved(funcDef));
+    expectSlot(getPrintedSlot(*funcDef.getStatements()[0]), 1, 0);
+}
+
+TEST_F(NameResolverTest, resolvers_have_distinct_ids) {
+    Init("void f() {}");
+    EXPECT_FALSE(NameResolver().isResolved(getStatement<FuncDef>(0)));
+}
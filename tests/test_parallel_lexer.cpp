@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "lexer_errors.hpp"
+#include "parallel_lexer.hpp"
+
+/// Lexes the input sequentially and in parallel with tiny chunks and expects the same
+/// tokens and errors
+class ParallelLexerTest : public testing::Test {
+   protected:
+    static constexpr std::size_t tokenLimit_{10000};
+
+    struct Result {
+        std::vector<Token> tokens;
+        std::string error;
+    };
+
+    static Result lexAll(ILexer& lexer) {
+        Result result;
+        try {
+            while (result.tokens.size() < tokenLimit_) {
+                result.tokens.push_back(lexer.getToken());
+                if (result.tokens.back().getType() == Token::Type::ETX)
+                    break;
+            }
+        } catch (const BaseException& e) {
+            result.error = e.describe();
+        }
+        return result;
+    }
+
+    static void expectSameTokens(const std::string& input,
+                                 Lexer::Comments comments = Lexer::Comments::KEEP) {
+        std::istringstream stream(input);
+        auto source = Source(stream);
+        auto lexer = Lexer(source, comments);
+        const auto expected = lexAll(lexer);
+
+        for (std::size_t chunkSize{1}; chunkSize <= 16; ++chunkSize) {
+            auto parallelSource = Source(source.getBuffer());
+            auto parallelLexer = ParallelLexer(parallelSource, comments, 64, chunkSize);
+            const auto actual = lexAll(parallelLexer);
+
+            ASSERT_EQ(actual.tokens.size(), expected.tokens.size())
+                << "Chunk size " << chunkSize;
+            for (std::size_t i{0}; i < expected.tokens.size(); ++i) {
+                const auto& expectedToken = expected.tokens[i];
+                const auto& actualToken = actual.tokens[i];
+                EXPECT_EQ(actualToken.getType(), expectedToken.getType()) << "Token " << i;
+                EXPECT_EQ(actualToken.getValue(), expectedToken.getValue()) << "Token " << i;
+                EXPECT_EQ(actualToken.getPosition().line, expectedToken.getPosition().line)
+                    << "Token " << i;
+                EXPECT_EQ(actualToken.getPosition().column,
+                          expectedToken.getPosition().column)
+                    << "Token " << i;
+            }
+            EXPECT_EQ(actual.error, expected.error) << "Chunk size " << chunkSize;
+        }
+    }
+};
+
+TEST_F(ParallelLexerTest, simple_program) {
+    expectSameTokens(
+        "int a = 1;\n"
+        "float b = 2.5;\n"
+        "\n"
+        "   while a < 10 {\n"
+        "       a = a + 1;\n"
+        "   }\n"
+        "print a;\n");
+}
+
+TEST_F(ParallelLexerTest, comments) {
+    const auto input =
+        "# comment \"\n"
+        "int a = 1; # another \" comment\n"
+        "\n"
+        "# print b;\n"
+        "print a;";
+    expectSameTokens(input);
+    expectSameTokens(input, Lexer::Comments::SKIP);
+}
+
+TEST_F(ParallelLexerTest, multiline_strings) {
+    const auto input =
+        "str a = \"first\n"
+        "line # not a comment\n"
+        "\"; print \"x\n"
+        "int b = 1;\n"
+        "\"\n"
+        "# comment\n"
+        "print \"\n"
+        "\n"
+        "\";\n";
+    expectSameTokens(input);
+    expectSameTokens(input, Lexer::Comments::SKIP);
+}
+
+TEST_F(ParallelLexerTest, string_looking_like_invalid_code) {
+    expectSameTokens(
+        "print \"\n"
+        "@ $ !\n"
+        "\" ;\n"
+        "print 1;\n");
+}
+
+TEST_F(ParallelLexerTest, error_in_later_chunk) {
+    expectSameTokens(
+        "int a = 1;\n"
+        "int b = 2;\n"
+        "int c = @;\n"
+        "int d = 4;\n");
+}
+
+TEST_F(ParallelLexerTest, not_terminated_string) {
+    expectSameTokens(
+        "int a = 1;\n"
+        "print \"abc\n"
+        "int b = 2;\n");
+}
+
+TEST_F(ParallelLexerTest, empty_source) {
+    expectSameTokens("");
+    expectSameTokens("\n\n   \n");
+}
+
+TEST_F(ParallelLexerTest, batched_tokens_end_with_end_of_text) {
+    std::istringstream stream("a\nb\nc\n");
+    auto source = Source(stream);
+    auto lexer = ParallelLexer(source, Lexer::Comments::KEEP, 4, 1);
+
+    std::array<Token, 8> tokens;
+
+    ASSERT_EQ(lexer.getTokens(tokens), 4);
+    EXPECT_EQ(tokens[3].getType(), Token::Type::ETX);
+    ASSERT_EQ(lexer.getTokens(tokens), 1);
+    EXPECT_EQ(tokens[0].getType(), Token::Type::ETX);
+}
+
+TEST_F(ParallelLexerTest, error_thrown_after_preceding_tokens) {
+    std::istringstream stream("a\nb\n@\nc\n");
+    auto source = Source(stream);
+    auto lexer = ParallelLexer(source, Lexer::Comments::KEEP, 4, 1);
+
+    std::array<Token, 8> tokens;
+
+    ASSERT_EQ(lexer.getTokens(tokens), 2);
+    EXPECT_THROW(lexer.getTokens(tokens), InvalidToken);
+}
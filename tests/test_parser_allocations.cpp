@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#include "lexer.hpp"
+#include "parser.hpp"
+
+namespace {
+bool countAllocations{false};
+std::size_t allocationCount{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (countAllocations)
+        ++allocationCount;
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+void operator delete[](void* memory) noexcept { std::free(memory); }
+
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+TEST(ParserAllocationsTest, parsing_allocates_only_for_the_tree) {
+    // Statements needing no containers besides the list of top level statements
+    const std::string block{
+        "x = (a + 1) * b - c.field;\n"
+        "print x >= 2 and not y;\n"
+        "int y = -2;\n"
+        "const float z = y as float / 3.5;\n"
+        "return z is float;\n"};
+    static constexpr std::size_t statementsInBlock{5};
+    static constexpr std::size_t repetitions{2000};
+
+    std::string text;
+    for (std::size_t i{0}; i < repetitions; ++i)
+        text += block;
+
+    std::istringstream stream(text);
+    Source source(stream);
+    Lexer lexer(source);
+
+    allocationCount = 0;
+    countAllocations = true;
+    Parser parser(lexer);
+    const auto program = parser.parseProgram();
+    countAllocations = false;
+
+    const auto statementCount = statementsInBlock * repetitions;
+    ASSERT_EQ(program.statements.size(), statementCount);
+
+    // Besides the arena blocks holding the nodes, only growing the vectors of the
+    // statements and of the lexer's tables allocates, which is logarithmic in the size
+    // of the program. Checking for expected tokens must not allocate anything
+    const auto otherAllocations = allocationCount - program.arena->getBlockCount();
+    EXPECT_LT(otherAllocations, statementCount / 100);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <fstream>
+
 #include "source.hpp"
 
 class SourceTest : public testing::Test {
@@ -62,3 +64,73 @@ TEST_F(SourceTest, getChar_after_nextChar) {
 
     ASSERT_EQ(source_->getChar(), 'b');
 }
+
+TEST_F(SourceTest, getChar_end_of_file) {
+    Init("a");
+
+    source_->nextChar();
+
+    ASSERT_EQ(source_->getChar(), EOF);
+    source_->nextChar();
+    ASSERT_EQ(source_->getChar(), EOF);
+}
+
+TEST_F(SourceTest, getPosition_past_end_of_file) {
+    Init("a\n");
+
+    source_->nextChar();
+    source_->nextChar();
+    source_->nextChar();
+
+    auto position = source_->getPosition();
+    ASSERT_EQ(position.line, 2);
+    ASSERT_EQ(position.column, 2);
+}
+
+TEST(SourceBufferTest, getPosition_random_access) {
+    const SourceBuffer buffer("ab\ncd\n\nef");
+
+    auto position = buffer.getPosition(8);
+    EXPECT_EQ(position.line, 4);
+    EXPECT_EQ(position.column, 2);
+
+    position = buffer.getPosition(4);
+    EXPECT_EQ(position.line, 2);
+    EXPECT_EQ(position.column, 2);
+
+    position = buffer.getPosition(2);
+    EXPECT_EQ(position.line, 1);
+    EXPECT_EQ(position.column, 3);
+}
+
+TEST(SourceBufferTest, fromFile) {
+    const auto path = testing::TempDir() + "source_test.rp";
+    std::ofstream(path) << "ab\ncd";
+
+    auto source = Source::fromFile(path);
+    EXPECT_EQ(source.getBuffer()->getText(), "ab\ncd");
+
+    source.nextChar();
+    source.nextChar();
+    source.nextChar();
+    EXPECT_EQ(source.getChar(), 'c');
+    EXPECT_EQ(source.getPosition().line, 2);
+    EXPECT_EQ(source.getPosition().column, 1);
+
+    std::remove(path.c_str());
+}
+
+TEST(SourceBufferTest, fromFile_empty) {
+    const auto path = testing::TempDir() + "empty_source_test.rp";
+    std::ofstream{path};
+
+    auto source = Source::fromFile(path);
+    EXPECT_EQ(source.getChar(), EOF);
+
+    std::remove(path.c_str());
+}
+
+TEST(SourceBufferTest, fromFile_not_existing) {
+    auto source = Source::fromFile(testing::TempDir() + "not_existing.rp");
+    EXPECT_EQ(source.getChar(), EOF);
+}
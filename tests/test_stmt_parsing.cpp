@@ -10,6 +10,70 @@ TEST_F(FullyParsedTest, parse_empty_program) {
     EXPECT_EQ(prog.statements.size(), 0);
 }
 
+TEST_F(FullyParsedTest, parse_program_streaming) {
+    Init(
+        "print 1;\n"
+        "void f() {}\n"
+        "int a = 2;\n"
+        "struct S {}\n"
+        "variant V { int, bool }\n");
+
+    std::vector<Position> positions;
+    const auto prog = parser_->parseProgram([&positions](const Statement& statement) {
+        positions.push_back(statement.position);
+    });
+
+    ASSERT_EQ(positions.size(), 5);
+    for (std::size_t i{0}; i < positions.size(); ++i)
+        EXPECT_EQ(positions[i].line, i + 1);
+
+    ASSERT_EQ(prog.statements.size(), 3);
+    EXPECT_EQ(prog.statements[0]->position.line, 2);
+    EXPECT_EQ(prog.statements[1]->position.line, 4);
+    EXPECT_EQ(prog.statements[2]->position.line, 5);
+}
+
+TEST_F(FullyParsedTest, parse_program_streaming_keeps_definitions_in_blocks) {
+    Init(
+        "if true { print 1; }\n"
+        "while false { if true { struct S {} } }\n"
+        "if true { while false {} void f() {} }\n");
+
+    const auto prog = parser_->parseProgram([](const Statement&) {});
+
+    ASSERT_EQ(prog.statements.size(), 2);
+    EXPECT_EQ(prog.statements[0]->position.line, 2);
+    EXPECT_EQ(prog.statements[1]->position.line, 3);
+}
+
+TEST_F(ParserTest, parse_program_streaming_reuses_memory_of_statements) {
+    std::string input;
+    for (int i{0}; i < 10000; ++i)
+        input += "if true { print \"text\" + 2 * 3; }\n";
+    Init(input);
+
+    std::size_t handled{0};
+    const auto prog =
+        parser_->parseProgram([&handled](const Statement&) { ++handled; });
+
+    EXPECT_EQ(handled, 10000);
+    EXPECT_EQ(prog.statements.size(), 0);
+    EXPECT_LE(prog.arena->getBlockCount(), 1);
+    EXPECT_EQ(prog.arena->getAllocatedBytes(), 0);
+}
+
+TEST_F(ParserTest, parse_program_streaming_handles_statements_before_error) {
+    Init(
+        "print 1;\n"
+        "print 2;\n"
+        "print (3;");
+
+    std::size_t handled{0};
+    EXPECT_THROW(parser_->parseProgram([&handled](const Statement&) { ++handled; }),
+                 SyntaxException);
+    EXPECT_EQ(handled, 2);
+}
+
 TEST_F(ParserTest, unknown_statement) {
     Init("unknown");
 
@@ -294,6 +358,73 @@ TEST_F(FullyParsedTest, parse_func_def_statements) {
     ASSERT_TRUE(dynamic_cast<IfStatement*>(statement.get()));
 }
 
+TEST_F(FullyParsedTest, parse_lazy_func_def_body_when_requested) {
+    Init(
+        "int foo() {\n"
+        "    if true {\n"
+        "        Point p = { 1, 2 };\n"
+        "    }\n"
+        "    return 1;\n"
+        "}\n"
+        "print foo();",
+        Parser::FunctionBodies::LAZY);
+
+    const auto prog = parser_->parseProgram();
+
+    ASSERT_EQ(prog.statements.size(), 2);
+    const auto funcDef = dynamic_cast<FuncDef*>(prog.statements.at(0).get());
+    ASSERT_TRUE(funcDef);
+    EXPECT_TRUE(funcDef->isBodyDeferred());
+    EXPECT_TRUE(dynamic_cast<PrintStatement*>(prog.statements.at(1).get()));
+
+    const auto& statements = funcDef->getStatements();
+
+    EXPECT_FALSE(funcDef->isBodyDeferred());
+    ASSERT_EQ(statements.size(), 2);
+    const auto ifStatement = dynamic_cast<IfStatement*>(statements.at(0).get());
+    ASSERT_TRUE(ifStatement);
+    ASSERT_EQ(ifStatement->statements.size(), 1);
+    EXPECT_EQ(ifStatement->statements.at(0)->position.line, 3);
+    EXPECT_EQ(ifStatement->statements.at(0)->position.column, 9);
+    EXPECT_TRUE(dynamic_cast<ReturnStatement*>(statements.at(1).get()));
+}
+
+TEST_F(FullyParsedTest, parse_lazy_func_def_reports_body_errors_when_requested) {
+    Init(
+        "int foo() {\n"
+        "    x = ;\n"
+        "}\n"
+        "print 1;",
+        Parser::FunctionBodies::LAZY);
+
+    const auto prog = parser_->parseProgram();
+
+    ASSERT_EQ(prog.statements.size(), 2);
+    const auto funcDef = dynamic_cast<FuncDef*>(prog.statements.at(0).get());
+    ASSERT_TRUE(funcDef);
+    EXPECT_THROW(
+        {
+            try {
+                funcDef->getStatements();
+            } catch (const SyntaxException& e) {
+                EXPECT_EQ(e.getPosition().line, 2);
+                EXPECT_EQ(e.getPosition().column, 9);
+                throw;
+            }
+        },
+        SyntaxException);
+}
+
+TEST_F(ParserTest, parse_lazy_func_def_unmatched_brace) {
+    Init(
+        "int foo() {\n"
+        "    if true {\n"
+        "}",
+        Parser::FunctionBodies::LAZY);
+
+    parseAndExpectThrowAt<SyntaxException>({3, 2});
+}
+
 TEST_F(FullyParsedTest, parse_void_func_def) {
     Init(
         "void foo() {"
@@ -323,8 +454,8 @@ TEST_F(FullyParsedTest, parse_assignment) {
     ASSERT_EQ(prog.statements.size(), 1);
     const auto assignment = dynamic_cast<Assignment*>(prog.statements.at(0).get());
     ASSERT_TRUE(assignment);
-    ASSERT_TRUE(std::holds_alternative<std::string>(assignment->lhs));
-    EXPECT_EQ(std::get<std::string>(assignment->lhs), "var");
+    ASSERT_TRUE(std::holds_alternative<Symbol>(assignment->lhs));
+    EXPECT_EQ(std::get<Symbol>(assignment->lhs), "var");
 
     const auto expression = dynamic_cast<Constant*>(assignment->rhs.get());
     ASSERT_TRUE(expression);
@@ -341,18 +472,16 @@ TEST_F(FullyParsedTest, parse_field_assignment) {
     const auto assignment = dynamic_cast<Assignment*>(prog.statements.at(0).get());
     ASSERT_TRUE(assignment);
 
-    ASSERT_TRUE(std::holds_alternative<std::unique_ptr<FieldAccess>>(assignment->lhs));
-    const auto& fieldAccess = std::get<std::unique_ptr<FieldAccess>>(assignment->lhs);
+    ASSERT_TRUE(std::holds_alternative<NodePtr<FieldAccess>>(assignment->lhs));
+    const auto& fieldAccess = std::get<NodePtr<FieldAccess>>(assignment->lhs);
     EXPECT_EQ(fieldAccess->field, "secondField");
 
-    ASSERT_TRUE(
-        std::holds_alternative<std::unique_ptr<FieldAccess>>(fieldAccess->container));
-    const auto& innerFieldAccess =
-        std::get<std::unique_ptr<FieldAccess>>(fieldAccess->container);
+    ASSERT_TRUE(std::holds_alternative<NodePtr<FieldAccess>>(fieldAccess->container));
+    const auto& innerFieldAccess = std::get<NodePtr<FieldAccess>>(fieldAccess->container);
     EXPECT_EQ(innerFieldAccess->field, "firstField");
 
-    ASSERT_TRUE(std::holds_alternative<std::string>(innerFieldAccess->container));
-    ASSERT_EQ(std::get<std::string>(innerFieldAccess->container), "myStruct");
+    ASSERT_TRUE(std::holds_alternative<Symbol>(innerFieldAccess->container));
+    ASSERT_EQ(std::get<Symbol>(innerFieldAccess->container), "myStruct");
 
     const auto expression = dynamic_cast<Constant*>(assignment->rhs.get());
     ASSERT_TRUE(expression);
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "symbol.hpp"
+
+TEST(SymbolTest, same_text_same_id) {
+    const std::string text{"identifier"};
+
+    EXPECT_EQ(Symbol(text), Symbol("identifier"));
+    EXPECT_EQ(Symbol(text).getId(), Symbol("identifier").getId());
+}
+
+TEST(SymbolTest, different_text_different_id) {
+    EXPECT_NE(Symbol("a"), Symbol("b"));
+    EXPECT_NE(Symbol("a"), Symbol("A"));
+}
+
+TEST(SymbolTest, getText) {
+    const Symbol symbol{"some_name"};
+
+    EXPECT_EQ(symbol.getText(), "some_name");
+    EXPECT_EQ(symbol, "some_name");
+}
+
+TEST(SymbolTest, default_is_empty) {
+    EXPECT_EQ(Symbol(), Symbol(""));
+    EXPECT_EQ(Symbol().getText(), "");
+}
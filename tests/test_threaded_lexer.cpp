@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+#include "filter.hpp"
+#include "flat_ast.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "spsc_ring.hpp"
+#include "threaded_lexer.hpp"
+
+TEST(SpscRingTest, passes_items_in_order) {
+    SpscRing<int> ring(4);
+    std::vector<int> items(10000);
+    std::iota(items.begin(), items.end(), 0);
+
+    std::jthread producer([&] {
+        for (std::size_t i{0}; i < items.size(); i += 7) {
+            const auto count = std::min<std::size_t>(7, items.size() - i);
+            ring.push(std::span(items).subspan(i, count));
+        }
+        ring.close();
+    });
+
+    std::vector<int> received;
+    std::array<int, 3> buffer;
+    while (const auto count = ring.pop(buffer))
+        received.insert(received.end(), buffer.begin(), buffer.begin() + count);
+
+    EXPECT_EQ(received, items);
+}
+
+TEST(SpscRingTest, closing_wakes_waiting_producer) {
+    SpscRing<int> ring(2);
+    const std::array<int, 5> items{1, 2, 3, 4, 5};
+    bool pushed{true};
+
+    std::jthread producer([&] { pushed = ring.push(items); });
+    std::array<int, 1> buffer;
+    EXPECT_EQ(ring.pop(buffer), 1);
+    ring.close();
+    producer.join();
+
+    EXPECT_FALSE(pushed);
+}
+
+/// Lexes the input directly and through the ThreadedLexer with rings of various sizes
+/// and expects the same tokens and errors
+class ThreadedLexerTest : public testing::Test {
+   protected:
+    static constexpr std::size_t tokenLimit_{10000};
+
+    struct Result {
+        std::vector<Token> tokens;
+        std::string error;
+    };
+
+    static Result lexAll(ILexer& lexer) {
+        Result result;
+        try {
+            while (result.tokens.size() < tokenLimit_) {
+                result.tokens.push_back(lexer.getToken());
+                if (result.tokens.back().getType() == Token::Type::ETX)
+                    break;
+            }
+        } catch (const BaseException& e) {
+            result.error = e.describe();
+        }
+        return result;
+    }
+
+    static void expectSameTokens(const std::string& input) {
+        std::istringstream stream(input);
+        auto source = Source(stream);
+        auto lexer = Lexer(source);
+        auto filter = Filter(lexer, Token::Type::CMT);
+        const auto expected = lexAll(filter);
+
+        for (const std::size_t capacity : {1, 2, 3, 1000}) {
+            auto threadedSource = Source(source.getBuffer());
+            auto threadedLexer = Lexer(threadedSource);
+            auto threadedFilter = Filter(threadedLexer, Token::Type::CMT);
+            auto threaded = ThreadedLexer(threadedFilter, capacity);
+            const auto actual = lexAll(threaded);
+
+            ASSERT_EQ(actual.tokens.size(), expected.tokens.size())
+                << "Capacity " << capacity;
+            for (std::size_t i{0}; i < expected.tokens.size(); ++i) {
+                const auto& expectedToken = expected.tokens[i];
+                const auto& actualToken = actual.tokens[i];
+                EXPECT_EQ(actualToken.getType(), expectedToken.getType())
+                    << "Token " << i;
+                EXPECT_EQ(actualToken.getValue(), expectedToken.getValue())
+                    << "Token " << i;
+                EXPECT_EQ(actualToken.getPosition().line,
+                          expectedToken.getPosition().line)
+                    << "Token " << i;
+                EXPECT_EQ(actualToken.getPosition().column,
+                          expectedToken.getPosition().column)
+                    << "Token " << i;
+            }
+            EXPECT_EQ(actual.error, expected.error) << "Capacity " << capacity;
+        }
+    }
+};
+
+TEST_F(ThreadedLexerTest, simple_program) {
+    expectSameTokens(
+        "int a = 1; # comment\n"
+        "float b = 2.5;\n"
+        "while a < 10 {\n"
+        "    a = a + 1;\n"
+        "}\n"
+        "print \"a\\tb\" + \"c\";\n");
+}
+
+TEST_F(ThreadedLexerTest, error_after_tokens) {
+    expectSameTokens(
+        "int a = 1;\n"
+        "int b = 2;\n"
+        "int c = @;\n"
+        "int d = 4;\n");
+}
+
+TEST_F(ThreadedLexerTest, not_terminated_string) {
+    expectSameTokens(
+        "int a = 1;\n"
+        "print \"abc\n");
+}
+
+TEST_F(ThreadedLexerTest, end_of_text_is_repeated) {
+    std::istringstream stream("print 1;");
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+    auto threaded = ThreadedLexer(lexer);
+
+    std::array<CompactToken, 8> tokens;
+    EXPECT_EQ(threaded.getCompactTokens(tokens), 4);
+    EXPECT_EQ(threaded.getToken().getType(), Token::Type::ETX);
+    EXPECT_EQ(threaded.getToken().getType(), Token::Type::ETX);
+}
+
+TEST_F(ThreadedLexerTest, destroyed_before_reading_everything) {
+    std::string input;
+    for (int i{0}; i < 10000; ++i)
+        input += "print " + std::to_string(i) + ";\n";
+    std::istringstream stream(input);
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+
+    auto threaded = ThreadedLexer(lexer, 16);
+    EXPECT_EQ(threaded.getToken().getType(), Token::Type::PRINT_KW);
+}
+
+TEST_F(ThreadedLexerTest, parses_like_lexer) {
+    const std::string input =
+        "struct Point { int x, float y }\n"
+        "int f(ref Point p) {\n"
+        "    return p.x * 2 + 1;\n"
+        "}\n"
+        "Point p = {1, 2.5};\n"
+        "print f(ref p) as str + \"\\n\";\n";
+
+    std::istringstream stream(input);
+    auto source = Source(stream);
+    auto lexer = Lexer(source, Lexer::Comments::SKIP);
+    const auto expected = flatten(Parser(lexer).parseProgram()).serialize();
+
+    auto threadedSource = Source(source.getBuffer());
+    auto threadedLexer = Lexer(threadedSource, Lexer::Comments::SKIP);
+    auto threaded = ThreadedLexer(threadedLexer);
+    const auto actual = flatten(Parser(threaded).parseProgram()).serialize();
+
+    EXPECT_EQ(actual, expected);
+}
+
+TEST_F(ThreadedLexerTest, parser_error_position) {
+    std::istringstream stream("int a = 1;\nprint (a;\n");
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+    auto threaded = ThreadedLexer(lexer);
+
+    try {
+        Parser(threaded).parseProgram();
+        FAIL() << "Expected SyntaxException";
+    } catch (const SyntaxException& e) {
+        EXPECT_EQ(e.getPosition().line, 2);
+        EXPECT_EQ(e.getPosition().column, 9);
+    }
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "compact_token.hpp"
+#include "lexer.hpp"
+#include "token_table.hpp"
+
+TEST(CompactTokenTest, payload) {
+    const CompactToken integral{Token::Type::INT_CONST, 0, CompactToken::pack(-42)};
+    const CompactToken floating{Token::Type::FLOAT_CONST, 0, CompactToken::pack(2.5f)};
+    const CompactToken boolean{Token::Type::TRUE_CONST, 0, CompactToken::pack(true)};
+    const CompactToken id{Token::Type::ID, 0, CompactToken::pack(Symbol("x"))};
+
+    EXPECT_EQ(integral.getIntegral(), -42);
+    EXPECT_EQ(floating.getFloating(), 2.5f);
+    EXPECT_TRUE(boolean.getBool());
+    EXPECT_EQ(id.getSymbol(), Symbol("x"));
+}
+
+TEST(TokenTableTest, add_keeps_value_and_position) {
+    TokenTable table;
+
+    const auto str = table.add(Token(Token::Type::STR_CONST, "abc", {2, 5}));
+    const auto id = table.add(Token(Token::Type::ID, Symbol("name"), {3, 1}));
+
+    const auto strToken = table.getToken(str);
+    EXPECT_EQ(strToken.getType(), Token::Type::STR_CONST);
+    EXPECT_EQ(std::get<std::string>(strToken.getValue()), "abc");
+    EXPECT_EQ(strToken.getPosition().line, 2);
+    EXPECT_EQ(strToken.getPosition().column, 5);
+
+    EXPECT_EQ(id.getSymbol(), "name");
+    EXPECT_EQ(table.getPosition(id).line, 3);
+}
+
+TEST(TokenTableTest, lexed_tokens_resolve_positions_from_offsets) {
+    std::istringstream stream("int a = 1;\n  str b = \"x\";");
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+
+    std::array<CompactToken, 16> tokens;
+    ASSERT_EQ(lexer.getCompactTokens(tokens), 11);
+
+    const auto& table = lexer.getTokenTable();
+    EXPECT_EQ(tokens[5].getType(), Token::Type::STR_KW);
+    EXPECT_EQ(tokens[5].getOffset(), 13);
+    EXPECT_EQ(table.getPosition(tokens[5]).line, 2);
+    EXPECT_EQ(table.getPosition(tokens[5]).column, 3);
+
+    EXPECT_EQ(tokens[8].getType(), Token::Type::STR_CONST);
+    EXPECT_EQ(table.getString(tokens[8]), "x");
+    EXPECT_EQ(tokens[10].getType(), Token::Type::ETX);
+}
+
+TEST(TokenTableTest, strings_without_escapes_view_the_source) {
+    std::istringstream stream(R"("plain" "esc\"aped" # comment)");
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+
+    std::array<CompactToken, 4> tokens;
+    ASSERT_EQ(lexer.getCompactTokens(tokens), 4);
+
+    const auto text = source.getText();
+    const auto& table = lexer.getTokenTable();
+    EXPECT_EQ(table.getString(tokens[0]), "plain");
+    EXPECT_EQ(table.getString(tokens[0]).data(), text.data() + 1);
+    EXPECT_EQ(table.getString(tokens[1]), "esc\"aped");
+    EXPECT_EQ(table.getString(tokens[2]), " comment");
+    EXPECT_EQ(table.getString(tokens[2]).data(), text.data() + 21);
+}
+
+TEST(TokenTableTest, add_from_other_table_keeps_source_views) {
+    std::istringstream stream(R"("plain" "a\nb")");
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+
+    std::array<CompactToken, 2> tokens;
+    ASSERT_EQ(lexer.getCompactTokens(tokens), 2);
+
+    TokenTable table(source.getBuffer());
+    const auto plain = table.addString(lexer.getTokenTable(), tokens[0]);
+    const auto escaped = table.addString(lexer.getTokenTable(), tokens[1]);
+    const auto plainToken = CompactToken(Token::Type::STR_CONST, 0, plain);
+    const auto escapedToken = CompactToken(Token::Type::STR_CONST, 0, escaped);
+
+    EXPECT_EQ(table.getString(plainToken).data(), source.getText().data() + 1);
+    EXPECT_EQ(table.getString(escapedToken), "a\nb");
+    EXPECT_NE(table.getString(escapedToken).data(),
+              lexer.getTokenTable().getString(tokens[1]).data());
+}
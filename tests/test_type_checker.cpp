@@ -0,0 +1,275 @@
+#include <gtest/gtest.h>
+
+#include "interpreter.hpp"
+#include "interpreter_errors.hpp"
+#include "lexer.hpp"
+#include "name_resolver.hpp"
+#include "parser.hpp"
+#include "type_checker.hpp"
+
+class TypeCheckerTest : public testing::Test {
+   protected:
+    void Init(const std::string& input) {
+        stream_ = std::istringstream(input);
+        source_ = std::make_unique<Source>(stream_);
+        lexer_ = std::make_unique<Lexer>(*source_);
+        program_ = Parser(*lexer_).parseProgram();
+        for (const auto& statement : program_.statements)
+            resolver_.resolve(*statement);
+    }
+
+    void check() { TypeChecker().check(program_); }
+
+    template <typename Exception>
+    void checkAndExpectThrowAt(Position position) {
+        EXPECT_THROW(
+            {
+                try {
+                    check();
+                } catch (const Exception& e) {
+                    EXPECT_EQ(e.getPosition().line, position.line);
+                    EXPECT_EQ(e.getPosition().column, position.column);
+                    throw;
+                }
+            },
+            Exception);
+    }
+
+    template <typename Node>
+    const Node& getStatement(std::size_t index) const {
+        return dynamic_cast<const Node&>(*program_.statements.at(index));
+    }
+
+    static const Type* getPrintedType(const Statement& statement) {
+        return dynamic_cast<const PrintStatement&>(statement).expression->checkedType;
+    }
+
+    std::istringstream stream_;
+    std::unique_ptr<Source> source_;
+    std::unique_ptr<Lexer> lexer_;
+    Program program_;
+    NameResolver resolver_;
+};
+
+TEST_F(TypeCheckerTest, intern_returns_same_pointer_for_equal_types) {
+    EXPECT_EQ(TypeChecker::intern(BuiltInType::INT),
+              TypeChecker::intern(BuiltInType::INT));
+    EXPECT_EQ(TypeChecker::intern(std::string("Point")),
+              TypeChecker::intern(std::string("Point")));
+    EXPECT_NE(TypeChecker::intern(BuiltInType::INT),
+              TypeChecker::intern(BuiltInType::FLOAT));
+}
+
+TEST_F(TypeCheckerTest, expressions_annotated_with_types) {
+    Init(
+        "int a = 1;"
+        "print a + 2;"
+        "print a as float;"
+        "print a < 2;"
+        "print \"a\" + \"b\";");
+    check();
+    EXPECT_TRUE(getStatement<VarDef>(0).checked);
+    EXPECT_EQ(getPrintedType(*program_.statements[1]),
+              TypeChecker::intern(BuiltInType::INT));
+    EXPECT_EQ(getPrintedType(*program_.statements[2]),
+              TypeChecker::intern(BuiltInType::FLOAT));
+    EXPECT_EQ(getPrintedType(*program_.statements[3]),
+              TypeChecker::intern(BuiltInType::BOOL));
+    EXPECT_EQ(getPrintedType(*program_.statements[4]),
+              TypeChecker::intern(BuiltInType::STR));
+
+    const auto& addition = dynamic_cast<const BinaryExpression&>(
+        *getStatement<PrintStatement>(1).expression);
+    EXPECT_TRUE(addition.checked);
+}
+
+TEST_F(TypeCheckerTest, structure_fields_and_calls_typed) {
+    Init(
+        "struct Point { int x, float y }"
+        "Point p = { 1, 2.0 };"
+        "print p.y;"
+        "float f(int a) { return a as float; }"
+        "print f(p.x);");
+    check();
+    EXPECT_FALSE(getStatement<VarDef>(1).checked);
+    EXPECT_EQ(getPrintedType(*program_.statements[2]),
+              TypeChecker::intern(BuiltInType::FLOAT));
+    EXPECT_TRUE(getStatement<FuncDef>(3).areReturnsChecked());
+
+    const auto& call =
+        dynamic_cast<const FuncCall&>(*getStatement<PrintStatement>(4).expression);
+    EXPECT_EQ(call.checkedType, TypeChecker::intern(BuiltInType::FLOAT));
+    EXPECT_TRUE(call.arguments[0].checked);
+}
+
+TEST_F(TypeCheckerTest, function_defined_twice_left_unchecked) {
+    Init(
+        "if true { int f() { return 1; } print f(); }"
+        "if true { str f() { return \"a\"; } print f(); }");
+    check();
+    const auto& ifStmt = getStatement<IfStatement>(0);
+    EXPECT_EQ(getPrintedType(*ifStmt.statements[1]), nullptr);
+}
+
+TEST_F(TypeCheckerTest, slot_shared_by_different_types_left_unchecked) {
+    Init(
+        "int a = 1;"
+        "str a = \"b\";"
+        "print a;");
+    check();
+    EXPECT_EQ(getPrintedType(*program_.statements[2]), nullptr);
+}
+
+TEST_F(TypeCheckerTest, variable_of_enclosing_function) {
+    Init(
+        "void f(str s) {"
+        "    void g() { print s + 1; }"
+        "}");
+    checkAndExpectThrowAt<TypeMismatch>({1, 37});
+}
+
+TEST_F(TypeCheckerTest, mismatched_operands) {
+    Init(
+        "print 1;"
+        "print 1 + 2.0;");
+    checkAndExpectThrowAt<TypeMismatch>({1, 15});
+}
+
+TEST_F(TypeCheckerTest, condition_not_bool) {
+    Init("while 1 {}");
+    checkAndExpectThrowAt<TypeMismatch>({1, 7});
+}
+
+TEST_F(TypeCheckerTest, variable_definition_mismatch) {
+    Init("int a = \"b\";");
+    checkAndExpectThrowAt<TypeMismatch>({1, 1});
+}
+
+TEST_F(TypeCheckerTest, assignment_to_field_mismatch) {
+    Init(
+        "struct Point { int x, int y }\n"
+        "Point p = { 1, 2 };\n"
+        "p.x = 1.0;");
+    checkAndExpectThrowAt<TypeMismatch>({3, 1});
+}
+
+TEST_F(TypeCheckerTest, argument_mismatch) {
+    Init(
+        "void f(int a) {}\n"
+        "f(true);");
+    checkAndExpectThrowAt<TypeMismatch>({2, 3});
+}
+
+TEST_F(TypeCheckerTest, argument_not_in_variant) {
+    Init(
+        "variant Number { int, float }\n"
+        "void f(Number n) {}\n"
+        "f(1);\n"
+        "f(\"a\");");
+    checkAndExpectThrowAt<TypeMismatch>({4, 3});
+}
+
+TEST_F(TypeCheckerTest, void_function_used_as_value) {
+    Init(
+        "void f() {}\n"
+        "int a = f();");
+    checkAndExpectThrowAt<TypeMismatch>({2, 1});
+}
+
+TEST_F(TypeCheckerTest, return_type_mismatch) {
+    Init(
+        "int f() {\n"
+        "    return \"a\";\n"
+        "}");
+    checkAndExpectThrowAt<ReturnTypeMismatch>({2, 5});
+}
+
+TEST_F(TypeCheckerTest, return_in_global_scope) {
+    Init(
+        "print 1;\n"
+        "if true { return; }");
+    checkAndExpectThrowAt<ReturnTypeMismatch>({2, 1});
+}
+
+TEST_F(TypeCheckerTest, error_in_function_never_called) {
+    Init("void f() { print 1 < \"a\"; }");
+    checkAndExpectThrowAt<TypeMismatch>({1, 18});
+}
+
+class StaticTypeChecksTest : public testing::Test {
+   protected:
+    std::string interpretAndGetOutput(const std::string& input,
+                                      Interpreter::TypeChecks typeChecks) {
+        auto stream = std::istringstream(input);
+        auto source = Source(stream);
+        auto lexer = Lexer(source);
+        const auto program = Parser(lexer).parseProgram();
+        std::stringstream output;
+        Interpreter(output, typeChecks).interpret(program);
+        return output.str();
+    }
+
+    void expectSameOutput(const std::string& input) {
+        EXPECT_EQ(interpretAndGetOutput(input, Interpreter::TypeChecks::STATIC),
+                  interpretAndGetOutput(input, Interpreter::TypeChecks::RUNTIME));
+    }
+};
+
+TEST_F(StaticTypeChecksTest, error_reported_before_output) {
+    auto stream = std::istringstream(
+        "print 1;\n"
+        "print 1 - true;");
+    auto source = Source(stream);
+    auto lexer = Lexer(source);
+    const auto program = Parser(lexer).parseProgram();
+    std::stringstream output;
+    auto interpreter = Interpreter(output, Interpreter::TypeChecks::STATIC);
+    EXPECT_THROW(interpreter.interpret(program), TypeMismatch);
+    EXPECT_EQ(output.str(), "");
+}
+
+TEST_F(StaticTypeChecksTest, same_output_as_runtime_checks) {
+    expectSameOutput(
+        "int fib(int n) {"
+        "    if n < 2 { return n; }"
+        "    return fib(n - 1) + fib(n - 2);"
+        "}"
+        "int i = 0;"
+        "while i < 10 { print fib(i); i = i + 1; }"
+        "print 1.5 * 2.0 == 3.0;"
+        "print \"a\" + \"b\" < \"b\";"
+        "print not (true and false) or false;");
+}
+
+TEST_F(StaticTypeChecksTest, same_output_with_structures_and_variants) {
+    expectSameOutput(
+        "struct Point { int x, int y }"
+        "variant Any { int, Point }"
+        "Any describe(Point p) { return p as Any; }"
+        "Point p = { 1, 2 };"
+        "p.x = p.y + 1;"
+        "Any a = describe(p);"
+        "print a is Point;"
+        "print a as Point;"
+        "a = 3 as Any;"
+        "print a;");
+}
+
+TEST_F(StaticTypeChecksTest, same_output_with_variable_of_enclosing_context) {
+    expectSameOutput(
+        "str x = \"a\";"
+        "void f() {"
+        "    void g() { print x + x; }"
+        "    g();"
+        "    int x = 2;"
+        "    g();"
+        "}"
+        "f();");
+}
+
+TEST_F(StaticTypeChecksTest, conversions_still_done_at_runtime) {
+    expectSameOutput(
+        "struct Point { int x, int y }"
+        "void f(Point p) { print p.x; }"
+        "f({ 4, 5 });");
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "type_registry.hpp"
+
+TEST(TypeRegistryTest, same_name_same_id) {
+    const std::string name{"Point"};
+
+    EXPECT_EQ(TypeRegistry::getNameId(name), TypeRegistry::getNameId("Point"));
+    EXPECT_EQ(TypeRegistry::getId(Type{name}), TypeRegistry::getNameId("Point"));
+    EXPECT_NE(TypeRegistry::getNameId("Point"), TypeRegistry::getNameId("point"));
+}
+
+TEST(TypeRegistryTest, built_in_types_not_user_defined) {
+    for (const auto type :
+         {BuiltInType::INT, BuiltInType::FLOAT, BuiltInType::BOOL, BuiltInType::STR}) {
+        const auto id = TypeRegistry::getId(type);
+        EXPECT_NE(id, TypeRegistry::NONE);
+        EXPECT_FALSE(TypeRegistry::isUserDefined(id));
+        EXPECT_EQ(TypeRegistry::getType(id), Type{type});
+    }
+    EXPECT_TRUE(TypeRegistry::isUserDefined(TypeRegistry::getNameId("Point")));
+}
+
+TEST(TypeRegistryTest, void_has_no_id) {
+    EXPECT_EQ(TypeRegistry::getId(ReturnType{VoidType{}}), TypeRegistry::NONE);
+    EXPECT_EQ(TypeRegistry::getId(ReturnType{BuiltInType::INT}),
+              TypeRegistry::getId(BuiltInType::INT));
+}
+
+TEST(TypeRegistryTest, getType_of_name) {
+    const auto id = TypeRegistry::getNameId("Shape");
+
+    EXPECT_EQ(TypeRegistry::getType(id), Type{std::string("Shape")});
+}
+
+TEST(TypeSetTest, contains_inserted_types) {
+    const TypeSet set({BuiltInType::INT, std::string("Point")});
+
+    EXPECT_TRUE(set.contains(TypeRegistry::getId(BuiltInType::INT)));
+    EXPECT_TRUE(set.contains(TypeRegistry::getNameId("Point")));
+    EXPECT_FALSE(set.contains(TypeRegistry::getId(BuiltInType::FLOAT)));
+    EXPECT_FALSE(set.contains(TypeRegistry::NONE));
+}
+
+TEST(TypeSetTest, ids_beyond_first_word) {
+    TypeSet set;
+    set.insert(200);
+
+    EXPECT_TRUE(set.contains(200));
+    EXPECT_FALSE(set.contains(199));
+    EXPECT_FALSE(set.contains(1000));
+}